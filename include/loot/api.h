@@ -28,17 +28,23 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "loot/api_decorator.h"
 #include "loot/enum/game_type.h"
 #include "loot/enum/log_level.h"
+#include "loot/enum/log_overflow_policy.h"
 #include "loot/exception/condition_syntax_error.h"
 #include "loot/exception/cyclic_interaction_error.h"
 #include "loot/exception/error_categories.h"
 #include "loot/exception/file_access_error.h"
 #include "loot/exception/git_state_error.h"
+#include "loot/executor_interface.h"
 #include "loot/game_interface.h"
 #include "loot/loot_version.h"
+#include "loot/struct/masterlist_update_job.h"
+#include "loot/struct/masterlist_update_result.h"
+#include "loot/struct/memory_usage.h"
 
 namespace loot {
 /**@}*/
@@ -60,6 +66,161 @@ namespace loot {
 LOOT_API void SetLoggingCallback(
     std::function<void(LogLevel, const char*)> callback);
 
+/**
+ * @brief Set a callback function that is called asynchronously when logging.
+ * @details Messages are formatted on the thread that logs them, then queued
+ *          in a bounded lock-free queue that a background thread passes to
+ *          the callback, so threads that log don't wait for the callback or
+ *          for each other. The callback is only ever called from the
+ *          background thread. Queued messages are passed to the callback
+ *          before a game handle is destroyed, and before the callback is
+ *          replaced by another call to this function or to
+ *          SetLoggingCallback().
+ * @param callback
+ *        The function called when logging. The first parameter is the
+ *        level of the message being logged, and the second is the message.
+ * @param queueSize
+ *        The maximum number of messages that can be queued. Must be a power
+ *        of two.
+ * @param overflowPolicy
+ *        What to do with a message that is logged while the queue is full.
+ */
+LOOT_API void SetAsyncLoggingCallback(
+    std::function<void(LogLevel, const char*)> callback,
+    size_t queueSize = 8192,
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::block);
+
+/**
+ * @brief Set the minimum level of messages that are logged.
+ * @details Messages below this level are discarded without being formatted or
+ *          passed to the logging callback. The level is kept when a new
+ *          logging callback is set. If this function is not called, messages
+ *          of all levels are logged. Trace messages are never logged if the
+ *          API was built with the `LOOT_DISABLE_TRACE_LOGGING` option.
+ * @param level
+ *        The minimum level of messages to log.
+ */
+LOOT_API void SetLogLevel(LogLevel level);
+
+/**@}*/
+/**********************************************************************/ /**
+                                                                          *  @name
+                                                                          *Tracing
+                                                                          *Functions
+                                                                          *************************************************************************/
+/**@{*/
+
+/**
+ * @brief Start recording a timeline of API operations.
+ * @details Plugin loading (per plugin and per thread that loads plugins),
+ *          sorting phases, condition evaluation, metadata file loading and
+ *          saving and Git operations are recorded with the threads they ran
+ *          on. Any events recorded by a previous call are discarded. When
+ *          tracing is not started, operations only check whether it is.
+ */
+LOOT_API void StartTracing();
+
+/**
+ * @brief Stop recording a timeline of API operations and write it to a file.
+ * @details The file is written in the Chrome trace-event JSON format, which
+ *          can be viewed using Perfetto or Chrome's ``about:tracing`` page.
+ * @param outputFile
+ *        The path to write the timeline to. Any existing file is replaced.
+ */
+LOOT_API void StopTracing(const std::string& outputFile);
+
+/**@}*/
+/**********************************************************************/ /**
+                                                                          *  @name
+                                                                          *Memory
+                                                                          *Accounting
+                                                                          *Functions
+                                                                          *************************************************************************/
+/**@{*/
+
+/**
+ * @brief Get the approximate heap memory held by each part of the API.
+ * @details Loaded plugins, masterlists and userlists, cached condition
+ *          results and plugin sorting are reported separately. If the API was
+ *          built without the ``LOOT_MEMORY_ACCOUNTING`` CMake option, no
+ *          allocations are counted.
+ * @returns The bytes held by each part of the API, for all game handles.
+ */
+LOOT_API MemoryUsage GetMemoryUsage();
+
+/**@}*/
+/**********************************************************************/ /**
+                                                                          *  @name
+                                                                          *Shared
+                                                                          *Plugin
+                                                                          *Cache
+                                                                          *Functions
+                                                                          *************************************************************************/
+/**@{*/
+
+/**
+ * @brief Read and store plugin data in a cache file that can be shared by
+ *        several processes.
+ * @details When a plugin is loaded, its header data, CRC and number of
+ *          override records are read from the cache if it holds them for a
+ *          file with the plugin's path, size and modification time, and are
+ *          otherwise read from the plugin and stored in the cache. A plugin
+ *          read from the cache is only parsed if its records are needed to
+ *          check if they overlap with another plugin's. Reading from the cache
+ *          doesn't wait for any locks. Plugins that have already been loaded
+ *          are unaffected. Once the cache is full, no more plugins are stored
+ *          in it, and a warning is logged.
+ * @param cache_path
+ *        The path to the cache file, which is created if it doesn't exist and
+ *        replaced if it isn't a cache file. Processes that store plugins in
+ *        the cache lock a file at the same path with ``.lock`` appended.
+ */
+LOOT_API void AttachSharedPluginCache(const std::string& cache_path);
+
+/**
+ * @brief Stop using the shared plugin cache.
+ */
+LOOT_API void DetachSharedPluginCache();
+
+/**@}*/
+/**********************************************************************/ /**
+                                                                          *  @name
+                                                                          *Executor
+                                                                          *Functions
+                                                                          *************************************************************************/
+/**@{*/
+
+/**
+ * @brief Set the executor that runs the tasks that parallel work is split
+ *        into.
+ * @details Loading plugins splits its work into tasks. If no executor is set,
+ *          tasks are run by a work-stealing thread pool that has a thread for
+ *          each hardware thread and is shared by all game handles. Masterlist
+ *          updates are not run as tasks, as they mostly wait on the network,
+ *          so they don't hold up the executor's threads. Operations that have
+ *          already started keep using the executor that they started with.
+ * @param executor
+ *        The executor to use, or ``nullptr`` to use the default thread pool.
+ */
+LOOT_API void SetExecutor(std::shared_ptr<ExecutorInterface> executor);
+
+/**
+ * @brief Set the maximum number of threads that parallel work runs on.
+ * @details Each parallel operation is done by the thread that calls it and
+ *          by executor tasks. All operations share a budget of one less than
+ *          the maximum number of tasks, so operations running at the same
+ *          time on different threads or game handles don't add up to more
+ *          tasks than that. Operations that can't get any tasks from the
+ *          budget run on their calling thread alone. The threads that
+ *          UpdateMasterlists() and DatabaseInterface::UpdateMasterlistAsync()
+ *          start are not counted.
+ * @param max_concurrency
+ *        The maximum number of threads. If zero, the number of hardware
+ *        threads is used, which is the default. If one, parallel work is
+ *        always done by the calling thread.
+ */
+LOOT_API void SetMaxConcurrency(unsigned int max_concurrency);
+
 /**@}*/
 /**********************************************************************/ /**
                                                                           *  @name
@@ -126,6 +287,37 @@ LOOT_API std::shared_ptr<GameInterface> CreateGameHandle(
     const GameType game,
     const std::string& game_path = "",
     const std::string& game_local_path = "");
+
+/**@}*/
+/**********************************************************************/ /**
+                                                                          *  @name
+                                                                          *Masterlist
+                                                                          *Update
+                                                                          *Functions
+                                                                          *************************************************************************/
+/**@{*/
+
+/**
+ *  @brief Update several masterlists concurrently.
+ *  @details Each job is updated as by DatabaseInterface::UpdateMasterlist(),
+ *           fetching, checking out and parsing its masterlist, but using a
+ *           pool of worker threads so that the jobs' network round-trips
+ *           overlap. Masterlists are only updated on disk: databases that use
+ *           them must reload them using DatabaseInterface::LoadLists().
+ *  @param jobs
+ *         The masterlists to update. No two jobs may have masterlists in the
+ *         same directory, as they would share a Git repository.
+ *  @param max_workers
+ *         The maximum number of jobs to run at the same time. If zero, the
+ *         number of hardware threads is used. Workers other than the calling
+ *         thread are threads of their own, and don't count towards the budget
+ *         set by SetMaxConcurrency().
+ *  @returns The result of each job, in the same order as the given jobs. A job
+ *           failing does not stop the other jobs from running.
+ */
+LOOT_API std::vector<MasterlistUpdateResult> UpdateMasterlists(
+    const std::vector<MasterlistUpdateJob>& jobs,
+    unsigned int max_workers = 0);
 }
 
 #endif
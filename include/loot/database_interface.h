@@ -24,6 +24,7 @@
 #ifndef LOOT_DATABASE_INTERFACE
 #define LOOT_DATABASE_INTERFACE
 
+#include <future>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #include "loot/metadata/plugin_metadata.h"
 #include "loot/struct/masterlist_info.h"
 #include "loot/struct/simple_message.h"
+#include "loot/struct/transfer_progress.h"
 
 namespace loot {
 /** @brief The interface provided by API's database handle. */
@@ -123,6 +125,71 @@ public:
                                 const std::string& remote_url,
                                 const std::string& remote_branch) = 0;
 
+  /**
+   *  @brief Asynchronously updates the given masterlist using the given Git
+   *         repository details.
+   *  @details The update is performed on a separate thread. The loaded
+   *           masterlist is only replaced once the updated masterlist has been
+   *           successfully parsed, so the database can continue to be used
+   *           while the update is in progress. Updates to masterlists are
+   *           performed one at a time.
+   *  @param masterlist_path
+   *         A string containing the relative or absolute path to the masterlist
+   *         file that should be updated. The filename must match the filename
+   *         of the masterlist file in the given remote repository, otherwise it
+   *         will not be updated correctly. Although LOOT itself expects this
+   *         filename to be "masterlist.yaml", the API does not check for any
+   *         specific filename.
+   *  @param remote_url
+   *         The URL of the remote from which to fetch updates. This can also be
+   *         a relative or absolute path to a local repository.
+   *  @param remote_branch
+   *         The branch of the remote from which to apply updates.
+   *  @param progress_callback
+   *         A callback that is passed the progress of the transfer of objects
+   *         from the remote repository. It is called on the update's thread.
+   *         If it returns `false`, the update is cancelled and the returned
+   *         future's `get()` will throw a `std::system_error` with the
+   *         `libgit2_category()` error code `GIT_EUSER`. If the callback
+   *         throws, the update is cancelled and the future rethrows the
+   *         callback's exception. May be empty.
+   *  @returns A future that holds the value that `UpdateMasterlist()` would
+   *           return, or the exception that it would throw.
+   */
+  virtual std::future<bool> UpdateMasterlistAsync(
+      const std::string& masterlist_path,
+      const std::string& remote_url,
+      const std::string& remote_branch,
+      const TransferProgressCallback& progress_callback = nullptr) = 0;
+
+  /**
+   *  @brief Updates the given masterlist using a local Git bundle, without
+   *         accessing the network.
+   *  @details The bundle's objects are added to the masterlist's repository
+   *           and its branch is applied as if it had been fetched from the
+   *           repository's remote, so an incremental bundle only needs to
+   *           contain the commits that the repository doesn't already have. If
+   *           there is no repository, one is created, and the bundle must then
+   *           contain the branch's full history. Raw packfiles are not
+   *           supported because they do not record which commit a branch
+   *           points to.
+   *  @param masterlist_path
+   *         A string containing the relative or absolute path to the masterlist
+   *         file that should be updated.
+   *  @param bundle_path
+   *         The relative or absolute path to a bundle created by
+   *         `git bundle create`.
+   *  @param remote_branch
+   *         The branch in the bundle from which to apply updates.
+   *  @returns `true` if the masterlist was updated. `false` if no update was
+   *           necessary, ie. it was already up-to-date. If `true`, the
+   *           masterlist will have been re-loaded, but will need to be
+   *           re-evaluated separately.
+   */
+  virtual bool UpdateMasterlistFromBundle(const std::string& masterlist_path,
+                                          const std::string& bundle_path,
+                                          const std::string& remote_branch) = 0;
+
   /**
    *  @brief Get the given masterlist's revision.
    *  @details Getting a masterlist's revision is only possible if it is found
@@ -142,6 +209,7 @@ public:
 
   /**
    * Check if the given masterlist is the latest available for a given branch.
+   * Only the remote's refs are listed, no objects are fetched.
    * @param  masterlist_path
    *         A string containing the relative or absolute path to the masterlist
    *         file for which the latest revision should be obtained. It needs to
@@ -0,0 +1,62 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_EDGE_TYPE
+#define LOOT_EDGE_TYPE
+
+#include <cstdint>
+
+namespace loot {
+/**
+ * @brief Codes used to indicate why an edge was added to the plugin graph
+ *        when sorting.
+ * @details If more than one reason applies to a pair of plugins, the edge
+ *          between them has the type of the first reason found, which follows
+ *          the order of the codes below.
+ */
+enum struct EdgeType : uint8_t {
+  /** The first plugin is a master and the second plugin is not. */
+  masterFlag,
+  /** The first plugin is one of the second plugin's masters. */
+  master,
+  /** The first plugin is one of the second plugin's requirements. */
+  requirement,
+  /** The second plugin's metadata says to load it after the first plugin. */
+  loadAfter,
+  /** The first plugin has a lower priority than the second plugin. */
+  priority,
+  /**
+   * The plugins override some of the same records, and the first plugin
+   * overrides more records than the second plugin.
+   */
+  overlap,
+  /**
+   * No other reason applies, so the plugins were ordered to keep the existing
+   * load order as much as possible.
+   */
+  tieBreak,
+};
+}
+
+#endif
@@ -0,0 +1,55 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_EXECUTOR_INTERFACE
+#define LOOT_EXECUTOR_INTERFACE
+
+#include <functional>
+
+namespace loot {
+/**
+ * Runs the tasks that the API splits parallel work into, such as loading
+ * plugins. Hosts can implement this to run the API's tasks on their own
+ * scheduler, and pass it to SetExecutor().
+ */
+class ExecutorInterface {
+public:
+  virtual ~ExecutorInterface() {}
+
+  /**
+   * Run a task.
+   *
+   * The task may be run on any thread, at any time after this function is
+   * called, and may be run before this function returns. Tasks do not throw
+   * exceptions. Every task that is passed to this function must eventually
+   * be run, but the API never waits for a task to start: threads that call
+   * into the API do any work that has not been started yet themselves.
+   * @param task
+   *        The task to run.
+   */
+  virtual void Execute(std::function<void()> task) = 0;
+};
+}
+
+#endif
@@ -26,6 +26,8 @@
 
 #include "loot/database_interface.h"
 #include "loot/plugin_interface.h"
+#include "loot/struct/game_statistics.h"
+#include "loot/struct/sort_graph_edge.h"
 
 namespace loot {
 /** @brief The interface provided for accessing game-specific functionality. */
@@ -125,6 +127,37 @@ public:
   virtual std::vector<std::string> SortPlugins(
       const std::vector<std::string>& plugins) = 0;
 
+  /**
+   *  @brief Set whether to keep the plugin graph that sorting builds.
+   *  @details If enabled, each successful call to ``SortPlugins()`` keeps a
+   *           compact copy of its plugin graph, replacing any graph kept by an
+   *           earlier call, so that ``GetSortGraphPath()`` can explain the
+   *           sorted order without sorting again. Disabling this discards any
+   *           kept graph. Graphs are not kept by default.
+   *  @param retain
+   *         If `true`, keep the graph of each sort.
+   */
+  virtual void SetRetainSortGraph(bool retain) = 0;
+
+  /**
+   *  @brief Get a path between two plugins in the last kept sort graph.
+   *  @details The path explains why the first plugin loads before the second
+   *           plugin. Of the possible paths, the one with the fewest
+   *           tie-break edges is returned, and then the one with the fewest
+   *           edges. Plugin filenames are case-insensitive. Throws a
+   *           `std::logic_error` if no graph has been kept, and a
+   *           `std::invalid_argument` if either plugin was not sorted.
+   *  @param from_plugin
+   *         The filename of the plugin that the path starts from.
+   *  @param to_plugin
+   *         The filename of the plugin that the path ends at.
+   *  @returns The edges of the path in order, or an empty vector if there is
+   *           no path or the plugins are the same.
+   */
+  virtual std::vector<SortGraphEdge> GetSortGraphPath(
+      const std::string& from_plugin,
+      const std::string& to_plugin) const = 0;
+
   /**
    *  @}
    *  @name Load Order Interaction
@@ -137,9 +170,23 @@ public:
    *        state.
    * @details This function should be called whenever the load order or active
    *          state of plugins "on disk" changes, so that the cached state is
-   *          updated to reflect the changes.
+   *          updated to reflect the changes. Unless forced, the state is only
+   *          reloaded if IsLoadOrderStateStale() returns true.
+   * @param force
+   *        If `true`, reload the state even if it is not stale.
    */
-  virtual void LoadCurrentLoadOrderState() = 0;
+  virtual void LoadCurrentLoadOrderState(bool force = false) = 0;
+
+  /**
+   * @brief Check if the load order state has changed on disk since it was
+   *        last loaded or set.
+   * @details This compares the sizes and modification times of the files that
+   *          the load order state is read from, which is much cheaper than
+   *          reloading the state. If the game's local path was not given when
+   *          creating the game handle, the state is always treated as stale.
+   * @returns True if the state should be reloaded, false otherwise.
+   */
+  virtual bool IsLoadOrderStateStale() const = 0;
 
   /**
    * @brief Check if a plugin is active.
@@ -157,10 +204,112 @@ public:
 
   /**
    * @brief Set the game's load order.
+   * @details If a load order write delay has been set, the cached load order
+   *          is updated immediately but the load order is not written until
+   *          the delay has passed without it being set again. An error
+   *          encountered when writing it is thrown by the next call to this
+   *          function or to FlushLoadOrder().
    * @param loadOrder
    *        A vector of plugin filenames sorted in the load order to set.
    */
   virtual void SetLoadOrder(const std::vector<std::string>& loadOrder) = 0;
+
+  /**
+   * @brief Set how long to wait before writing a load order set using
+   *        SetLoadOrder().
+   * @details Writes are delayed on a background thread, so that setting the
+   *          load order many times in quick succession only writes the last
+   *          load order set. Any pending load order is written when this game
+   *          handle is destroyed. By default, there is no delay and the load
+   *          order is written before SetLoadOrder() returns.
+   * @param milliseconds
+   *        The delay in milliseconds. If zero, any pending load order is
+   *        written and later load orders are written synchronously.
+   */
+  virtual void SetLoadOrderWriteDelay(unsigned int milliseconds) = 0;
+
+  /**
+   * @brief Write any load order that SetLoadOrder() has delayed writing.
+   * @details This also throws any error that a delayed write encountered.
+   */
+  virtual void FlushLoadOrder() = 0;
+
+  /**
+   *  @}
+   *  @name Snapshots
+   *  @{
+   */
+
+  /**
+   * @brief Save the game handle's loaded data to a snapshot file.
+   * @details The snapshot holds the loaded plugins, the cached results of
+   *          evaluated conditions, the loaded masterlist and userlist and the
+   *          cached load order state, along with the sizes and modification
+   *          times of the files that they were read from. Any pending load
+   *          order is written first. Snapshots are only meant to be restored
+   *          on the machine that saved them, by the same version of the API.
+   * @param snapshotPath
+   *        The path to write the snapshot to. Any existing file is replaced.
+   */
+  virtual void SaveSnapshot(const std::string& snapshotPath) = 0;
+
+  /**
+   * @brief Replace the game handle's loaded data with that in a snapshot
+   *        file.
+   * @details Each part of the snapshot is checked against the current files
+   *          before it is used:
+   *
+   *          - Plugins that have changed are loaded again. Plugins that can no
+   *            longer be loaded are left out.
+   *          - A masterlist or userlist that has changed is loaded again.
+   *            Restored lists hold their metadata as loaded, so their
+   *            conditions are evaluated again when evaluated metadata is next
+   *            needed.
+   *          - If any load order state files have changed, the load order
+   *            state is not restored. If the snapshot has plugins, the current
+   *            load order state is loaded instead, as it is when loading
+   *            plugins.
+   *          - Condition results are only restored if the load order state,
+   *            the loaded plugins and the timestamps of the game and data
+   *            directories are all unchanged. Otherwise conditions are
+   *            evaluated again when they are next needed. Files that are
+   *            added, removed or renamed inside subdirectories, or edited in
+   *            place, are not detected. For that reason, the results of
+   *            conditions using the \c checksum() or \c version() functions
+   *            are never saved.
+   *
+   *          Plugins whose records were restored are not parsed again until
+   *          their records are needed to sort them.
+   * @param snapshotPath
+   *        The path of a snapshot file saved by SaveSnapshot() using a game
+   *        handle for the same game type and game path.
+   */
+  virtual void RestoreSnapshot(const std::string& snapshotPath) = 0;
+
+  /**
+   *  @}
+   *  @name Statistics
+   *  @{
+   */
+
+  /**
+   * @brief Get counts of and time spent on work done by the API since this
+   *        game handle was created or its statistics were last reset.
+   * @details The statistics only include work done through this game handle
+   *          and its database, including work that they do on other threads.
+   *          Work done by calling a loaded plugin's functions directly isn't
+   *          counted.
+   * @returns The statistics.
+   */
+  virtual GameStatistics GetStatistics() const = 0;
+
+  /**
+   * @brief Reset the statistics returned by GetStatistics() to zero.
+   * @details This does not affect the statistics of other game handles.
+   */
+  virtual void ResetStatistics() = 0;
+
+  /** @} */
 };
 }
 
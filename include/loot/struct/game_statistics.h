@@ -0,0 +1,141 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_GAME_STATISTICS
+#define LOOT_GAME_STATISTICS
+
+#include <chrono>
+#include <cstdint>
+
+namespace loot {
+/**
+ * @brief A structure that holds counts of and time spent on work done by the
+ *        API.
+ * @details Counts are approximate, as they may be read while other threads
+ *          are still adding to them.
+ */
+struct GameStatistics {
+  inline GameStatistics() :
+      plugins_parsed(0),
+      bytes_read(0),
+      crcs_computed(0),
+      esplugin_calls(0),
+      libloadorder_calls(0),
+      condition_cache_hits(0),
+      condition_cache_misses(0),
+      regex_compilations(0),
+      metadata_lookups(0),
+      load_plugins_time(0),
+      sort_plugins_time(0),
+      load_lists_time(0),
+      update_masterlist_time(0),
+      game_cache_lock_wait_time(0),
+      logging_lock_wait_time(0) {}
+
+  /**
+   * @brief The number of plugins that were parsed, fully or just their
+   *        headers.
+   */
+  uint64_t plugins_parsed;
+
+  /**
+   * @brief The number of bytes read from plugins that were fully parsed and
+   *        from files that had their CRCs computed.
+   */
+  uint64_t bytes_read;
+
+  /**
+   * @brief The number of file CRCs that were computed.
+   */
+  uint64_t crcs_computed;
+
+  /**
+   * @brief The number of calls made to esplugin, not including calls that
+   *        free memory.
+   */
+  uint64_t esplugin_calls;
+
+  /**
+   * @brief The number of calls made to libloadorder, not including calls that
+   *        free memory.
+   */
+  uint64_t libloadorder_calls;
+
+  /**
+   * @brief The number of conditions whose results were found in the cache.
+   */
+  uint64_t condition_cache_hits;
+
+  /**
+   * @brief The number of conditions whose results were not found in the
+   *        cache.
+   */
+  uint64_t condition_cache_misses;
+
+  /**
+   * @brief The number of regular expressions that were compiled.
+   */
+  uint64_t regex_compilations;
+
+  /**
+   * @brief The number of times that a metadata list was searched for a
+   *        plugin's metadata.
+   */
+  uint64_t metadata_lookups;
+
+  /**
+   * @brief The time spent in GameInterface::LoadPlugins().
+   */
+  std::chrono::nanoseconds load_plugins_time;
+
+  /**
+   * @brief The time spent in GameInterface::SortPlugins(), including the time
+   *        spent loading plugins.
+   */
+  std::chrono::nanoseconds sort_plugins_time;
+
+  /**
+   * @brief The time spent in DatabaseInterface::LoadLists().
+   */
+  std::chrono::nanoseconds load_lists_time;
+
+  /**
+   * @brief The time spent updating masterlists.
+   */
+  std::chrono::nanoseconds update_masterlist_time;
+
+  /**
+   * @brief The time that threads spent waiting for other threads to finish
+   *        using a game's plugin and condition cache.
+   */
+  std::chrono::nanoseconds game_cache_lock_wait_time;
+
+  /**
+   * @brief The time that threads spent waiting for other threads to finish
+   *        passing messages to the logging callback.
+   */
+  std::chrono::nanoseconds logging_lock_wait_time;
+};
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_MASTERLIST_UPDATE_JOB
+#define LOOT_MASTERLIST_UPDATE_JOB
+
+#include <string>
+
+namespace loot {
+/**
+ * @brief A structure that holds the details of a masterlist to update as part
+ *        of a batch of updates.
+ */
+struct MasterlistUpdateJob {
+  inline MasterlistUpdateJob() {}
+
+  inline MasterlistUpdateJob(const std::string& masterlist_path,
+                             const std::string& remote_url,
+                             const std::string& remote_branch) :
+      masterlist_path(masterlist_path),
+      remote_url(remote_url),
+      remote_branch(remote_branch) {}
+
+  /**
+   * @brief The relative or absolute path to the masterlist file to update.
+   */
+  std::string masterlist_path;
+
+  /**
+   * @brief The URL of the remote from which to fetch updates. This can also be
+   *        a relative or absolute path to a local repository.
+   */
+  std::string remote_url;
+
+  /**
+   * @brief The branch of the remote from which to apply updates.
+   */
+  std::string remote_branch;
+};
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_MASTERLIST_UPDATE_RESULT
+#define LOOT_MASTERLIST_UPDATE_RESULT
+
+#include <exception>
+
+namespace loot {
+/**
+ * @brief A structure that holds the outcome of one masterlist update in a batch
+ *        of updates.
+ */
+struct MasterlistUpdateResult {
+  inline MasterlistUpdateResult() : updated(false) {}
+
+  /**
+   * @brief `true` if the masterlist was updated, `false` if it was already
+   *        up-to-date or the update failed.
+   */
+  bool updated;
+
+  /**
+   * @brief The exception thrown by the update if it failed, or null if it
+   *        succeeded. It can be rethrown using `std::rethrow_exception()`.
+   */
+  std::exception_ptr error;
+};
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_MEMORY_USAGE
+#define LOOT_MEMORY_USAGE
+
+#include <cstddef>
+
+namespace loot {
+/**
+ * @brief A structure that holds the approximate number of heap bytes held by
+ *        each part of the API.
+ * @details Allocations are only counted if the API was built with the
+ *          ``LOOT_MEMORY_ACCOUNTING`` CMake option, which replaces the global
+ *          operator new and delete. Memory allocated by esplugin,
+ *          libloadorder and libgit2 is not counted, and memory is attributed
+ *          to the part of the API that allocated it, even if it is later
+ *          owned by another part. Sizes include all game handles in the
+ *          process.
+ */
+struct MemoryUsage {
+  inline MemoryUsage() :
+      is_counted(false),
+      plugins_bytes(0),
+      metadata_lists_bytes(0),
+      condition_cache_bytes(0),
+      sorting_bytes(0),
+      sorting_peak_bytes(0),
+      other_bytes(0) {}
+
+  /**
+   * @brief True if allocations are being counted, false if the API was built
+   *        without memory accounting and all sizes are zero.
+   */
+  bool is_counted;
+
+  /**
+   * @brief The bytes held by loaded plugins.
+   */
+  size_t plugins_bytes;
+
+  /**
+   * @brief The bytes held by loaded masterlists and userlists.
+   */
+  size_t metadata_lists_bytes;
+
+  /**
+   * @brief The bytes held by cached condition results.
+   */
+  size_t condition_cache_bytes;
+
+  /**
+   * @brief The bytes held by plugin sorting. Sorting frees its temporary data
+   *        when it finishes, so this is usually only the memory held by
+   *        sorted load orders that have not yet been freed.
+   */
+  size_t sorting_bytes;
+
+  /**
+   * @brief The most bytes that plugin sorting has held at once.
+   */
+  size_t sorting_peak_bytes;
+
+  /**
+   * @brief The bytes held by everything else, including the application's
+   *        own allocations if it shares the API's operator new.
+   */
+  size_t other_bytes;
+};
+}
+
+#endif
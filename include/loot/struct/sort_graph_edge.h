@@ -0,0 +1,60 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_SORT_GRAPH_EDGE
+#define LOOT_SORT_GRAPH_EDGE
+
+#include <string>
+
+#include "loot/enum/edge_type.h"
+
+namespace loot {
+/**
+ * @brief A structure that holds an edge of the plugin graph that was built
+ *        when sorting.
+ * @details An edge means that its first plugin must load before its second
+ *          plugin.
+ */
+struct SortGraphEdge {
+  inline SortGraphEdge() : type(EdgeType::tieBreak) {}
+
+  inline SortGraphEdge(const std::string& from_plugin,
+                       const std::string& to_plugin,
+                       EdgeType type) :
+      from_plugin(from_plugin),
+      to_plugin(to_plugin),
+      type(type) {}
+
+  /** @brief The filename of the plugin that must load first. */
+  std::string from_plugin;
+
+  /** @brief The filename of the plugin that must load second. */
+  std::string to_plugin;
+
+  /** @brief Why the edge was added. */
+  EdgeType type;
+};
+}
+
+#endif
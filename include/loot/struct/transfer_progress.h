@@ -0,0 +1,89 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_TRANSFER_PROGRESS
+#define LOOT_TRANSFER_PROGRESS
+
+#include <cstddef>
+#include <functional>
+
+namespace loot {
+/**
+ * @brief A structure that holds the progress of a masterlist update's transfer
+ *        of objects from its remote repository.
+ */
+struct TransferProgress {
+  inline TransferProgress() :
+      total_objects(0),
+      indexed_objects(0),
+      received_objects(0),
+      local_objects(0),
+      total_deltas(0),
+      indexed_deltas(0),
+      received_bytes(0) {}
+
+  /**
+   * @brief The number of objects that the remote is sending.
+   */
+  size_t total_objects;
+
+  /**
+   * @brief The number of received objects that have been indexed.
+   */
+  size_t indexed_objects;
+
+  /**
+   * @brief The number of objects that have been received.
+   */
+  size_t received_objects;
+
+  /**
+   * @brief The number of objects that were already present locally and so did
+   *        not need to be received.
+   */
+  size_t local_objects;
+
+  /**
+   * @brief The number of deltas that the remote is sending.
+   */
+  size_t total_deltas;
+
+  /**
+   * @brief The number of received deltas that have been indexed.
+   */
+  size_t indexed_deltas;
+
+  /**
+   * @brief The number of bytes that have been received.
+   */
+  size_t received_bytes;
+};
+
+/**
+ * @brief A callback that is passed a masterlist update's transfer progress.
+ * @returns `true` to continue the transfer, or `false` to cancel it.
+ */
+typedef std::function<bool(const TransferProgress&)> TransferProgressCallback;
+}
+
+#endif
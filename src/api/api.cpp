@@ -24,11 +24,22 @@
 
 #include "loot/api.h"
 
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+
+#include <git2.h>
 #include <boost/filesystem.hpp>
 #include <boost/locale.hpp>
 
 #include "api/game/game.h"
+#include "api/helpers/executor.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/memory_accounting.h"
+#include "api/helpers/tracing.h"
+#include "api/masterlist.h"
+#include "api/plugin/shared_plugin_cache.h"
 
 namespace fs = boost::filesystem;
 
@@ -46,10 +57,56 @@ LOOT_API void SetLoggingCallback(
     std::function<void(LogLevel, const char*)> callback) {
   auto sink = std::make_shared<SpdLoggingSink>(callback);
   auto logger = std::make_shared<spdlog::logger>(LOGGER_NAME, sink);
-  logger->set_level(spdlog::level::level_enum::trace);
 
   spdlog::drop(LOGGER_NAME);
   spdlog::register_logger(logger);
+  setLogger(logger);
+}
+
+LOOT_API void SetAsyncLoggingCallback(
+    std::function<void(LogLevel, const char*)> callback,
+    size_t queueSize,
+    LogOverflowPolicy overflowPolicy) {
+  // spdlog's queue indexes its ring buffer using a bitmask.
+  if (queueSize < 2 || (queueSize & (queueSize - 1)) != 0)
+    throw std::invalid_argument(
+        "The logging queue size must be a power of two.");
+
+  auto policy = overflowPolicy == LogOverflowPolicy::drop
+                    ? spdlog::async_overflow_policy::discard_log_msg
+                    : spdlog::async_overflow_policy::block_retry;
+
+  auto sink = std::make_shared<SpdLoggingSink>(callback);
+  auto logger = std::make_shared<spdlog::async_logger>(
+      LOGGER_NAME, sink, queueSize, policy);
+
+  spdlog::drop(LOGGER_NAME);
+  spdlog::register_logger(logger);
+  setLogger(logger);
+}
+
+LOOT_API void SetLogLevel(LogLevel level) { setLogLevel(mapToSpdlog(level)); }
+
+LOOT_API void StartTracing() { startTracing(); }
+
+LOOT_API void StopTracing(const std::string& outputFile) {
+  stopTracing(outputFile);
+}
+
+LOOT_API MemoryUsage GetMemoryUsage() { return GetMemoryUsageBySubsystem(); }
+
+LOOT_API void AttachSharedPluginCache(const std::string& cache_path) {
+  setSharedPluginCache(std::make_shared<SharedPluginCache>(cache_path));
+}
+
+LOOT_API void DetachSharedPluginCache() { setSharedPluginCache(nullptr); }
+
+LOOT_API void SetExecutor(std::shared_ptr<ExecutorInterface> executor) {
+  setExecutor(executor);
+}
+
+LOOT_API void SetMaxConcurrency(unsigned int max_concurrency) {
+  setMaxConcurrency(max_concurrency);
 }
 
 LOOT_API bool IsCompatible(const unsigned int versionMajor,
@@ -82,4 +139,107 @@ LOOT_API std::shared_ptr<GameInterface> CreateGameHandle(
 
   return std::make_shared<Game>(game, resolvedGamePath, resolvedGameLocalPath);
 }
+
+namespace {
+// Keeps libgit2 initialised for as long as it exists.
+class LibGit2Initialiser {
+public:
+  LibGit2Initialiser() { git_libgit2_init(); }
+  ~LibGit2Initialiser() { git_libgit2_shutdown(); }
+
+  LibGit2Initialiser(const LibGit2Initialiser&) = delete;
+  LibGit2Initialiser& operator=(const LibGit2Initialiser&) = delete;
+};
+
+// Joins the threads when it's destroyed, so that they're joined even if
+// starting one of them throws.
+class ThreadJoiner {
+public:
+  explicit ThreadJoiner(std::vector<std::thread>& threads) :
+      threads_(threads) {}
+
+  ~ThreadJoiner() {
+    for (auto& thread : threads_) {
+      if (thread.joinable())
+        thread.join();
+    }
+  }
+
+  ThreadJoiner(const ThreadJoiner&) = delete;
+  ThreadJoiner& operator=(const ThreadJoiner&) = delete;
+
+private:
+  std::vector<std::thread>& threads_;
+};
+
+MasterlistUpdateResult RunMasterlistUpdateJob(const MasterlistUpdateJob& job) {
+  MasterlistUpdateResult result;
+  try {
+    fs::path masterlistPath(job.masterlist_path);
+    if (!fs::is_directory(masterlistPath.parent_path()))
+      throw std::invalid_argument("Given masterlist path \"" +
+                                  job.masterlist_path +
+                                  "\" does not have a valid parent directory.");
+
+    Masterlist masterlist;
+    result.updated =
+        masterlist.Update(masterlistPath, job.remote_url, job.remote_branch);
+  } catch (...) {
+    result.error = std::current_exception();
+  }
+
+  return result;
+}
+}
+
+LOOT_API std::vector<MasterlistUpdateResult> UpdateMasterlists(
+    const std::vector<MasterlistUpdateJob>& jobs,
+    unsigned int maxWorkers) {
+  std::set<fs::path> repositoryPaths;
+  for (const auto& job : jobs) {
+    fs::path repositoryPath =
+        fs::absolute(job.masterlist_path).parent_path().lexically_normal();
+    if (!repositoryPaths.insert(repositoryPath).second)
+      throw std::invalid_argument(
+          "More than one masterlist update job uses the repository at \"" +
+          repositoryPath.string() + "\".");
+  }
+
+  // Updates spend most of their time waiting on the network, so they run on
+  // their own threads instead of taking executor tasks from CPU-bound work.
+  if (maxWorkers == 0)
+    maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+  size_t workerCount = std::min<size_t>(maxWorkers, jobs.size());
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->info("Updating {} masterlists using {} worker threads.",
+                 jobs.size(),
+                 workerCount);
+  }
+
+  // Keep libgit2 initialised for the whole batch so that its global state
+  // isn't set up and torn down again for every job.
+  LibGit2Initialiser libgit2Initialiser;
+
+  std::vector<MasterlistUpdateResult> results(jobs.size());
+  std::atomic<size_t> nextJob(0);
+  auto worker = [&]() {
+    for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+      results[i] = RunMasterlistUpdateJob(jobs[i]);
+    }
+  };
+
+  // The workers use the results, so they must be joined before anything
+  // declared above is destroyed.
+  std::vector<std::thread> workers;
+  ThreadJoiner workersJoiner(workers);
+  for (size_t i = 1; i < workerCount; ++i) {
+    workers.emplace_back(worker);
+  }
+  worker();
+
+  return results;
+}
 }
@@ -30,6 +30,9 @@
 #include <boost/algorithm/string.hpp>
 
 #include "api/game/game.h"
+#include "api/helpers/logging.h"
+#include "api/helpers/memory_accounting.h"
+#include "api/helpers/statistics.h"
 #include "api/metadata/condition_evaluator.h"
 #include "api/metadata/yaml/plugin_metadata.h"
 #include "api/plugin/plugin_sorter.h"
@@ -39,9 +42,12 @@ namespace loot {
 ApiDatabase::ApiDatabase(const GameType gameType,
                          const boost::filesystem::path& dataPath,
                          std::shared_ptr<GameCache> gameCache,
-                         std::shared_ptr<LoadOrderHandler> loadOrderHandler) :
+                         std::shared_ptr<LoadOrderHandler> loadOrderHandler,
+                         std::shared_ptr<StatisticCounters> statistics) :
     gameCache_(gameCache),
-    conditionEvaluator_(gameType, dataPath, gameCache, loadOrderHandler) {}
+    conditionEvaluator_(gameType, dataPath, gameCache, loadOrderHandler),
+    statistics_(statistics),
+    listsGeneration_(0) {}
 
 ///////////////////////////////////
 // Database Loading Functions
@@ -49,9 +55,15 @@ ApiDatabase::ApiDatabase(const GameType gameType,
 
 void ApiDatabase::LoadLists(const std::string& masterlistPath,
                             const std::string& userlistPath) {
-  Masterlist temp;
-  MetadataList userTemp;
+  StatisticsScope statisticsScope(statistics_.get());
+  StatisticTimer timer(Statistic::loadListsTime);
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
+  // Identities are read before the files, so that a change while they're
+  // being read doesn't go unnoticed.
+  FileIdentity masterlistIdentity = FileIdentity::Get(masterlistPath);
 
+  Masterlist temp;
   if (!masterlistPath.empty()) {
     if (boost::filesystem::exists(masterlistPath)) {
       temp.Load(masterlistPath);
@@ -61,17 +73,18 @@ void ApiDatabase::LoadLists(const std::string& masterlistPath,
     }
   }
 
-  if (!userlistPath.empty()) {
-    if (boost::filesystem::exists(userlistPath)) {
-      userTemp.Load(userlistPath);
-    } else {
-      throw FileAccessError("The given userlist path does not exist: " +
-                            userlistPath);
-    }
-  }
+  ReplaceLists(masterlistPath, temp, masterlistIdentity, userlistPath);
+}
 
-  masterlist_ = temp;
-  userlist_ = userTemp;
+void ApiDatabase::LoadLists(const std::string& masterlistPath,
+                            const Masterlist& masterlist,
+                            const FileIdentity& masterlistIdentity,
+                            const std::string& userlistPath) {
+  StatisticsScope statisticsScope(statistics_.get());
+  StatisticTimer timer(Statistic::loadListsTime);
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
+  ReplaceLists(masterlistPath, masterlist, masterlistIdentity, userlistPath);
 }
 
 void ApiDatabase::WriteUserMetadata(const std::string& outputFile,
@@ -87,6 +100,73 @@ void ApiDatabase::WriteUserMetadata(const std::string& outputFile,
   userlist_.Save(outputFile);
 }
 
+void ApiDatabase::WriteSnapshot(BinaryWriter& writer) const {
+  std::lock_guard<std::mutex> guard(masterlistMutex_);
+
+  writer.Write(masterlistPath_);
+  masterlistIdentity_.Write(writer);
+  masterlist_.Write(writer);
+
+  writer.Write(userlistPath_);
+  userlistIdentity_.Write(writer);
+  userlist_.Write(writer);
+}
+
+void ApiDatabase::RestoreSnapshot(BinaryReader& reader) {
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+  auto logger = getLogger();
+
+  std::string masterlistPath = reader.Read<std::string>();
+  FileIdentity masterlistIdentity = FileIdentity::Read(reader);
+  Masterlist masterlist;
+  masterlist.Read(reader);
+
+  std::string userlistPath = reader.Read<std::string>();
+  FileIdentity userlistIdentity = FileIdentity::Read(reader);
+  MetadataList userlist;
+  userlist.Read(reader);
+
+  // Only the lists whose files have changed are reloaded. A list that can no
+  // longer be loaded is left empty, as if it had never been loaded.
+  if (!masterlistPath.empty() &&
+      FileIdentity::Get(masterlistPath) != masterlistIdentity) {
+    LOOT_LOG_DEBUG(logger, "The masterlist has changed, reloading it.");
+    masterlistIdentity = FileIdentity::Get(masterlistPath);
+    try {
+      masterlist.Load(masterlistPath);
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->warn("Failed to reload the masterlist. Details: {}", e.what());
+      }
+      masterlist = Masterlist();
+    }
+  }
+
+  if (!userlistPath.empty() &&
+      FileIdentity::Get(userlistPath) != userlistIdentity) {
+    LOOT_LOG_DEBUG(logger, "The userlist has changed, reloading it.");
+    userlistIdentity = FileIdentity::Get(userlistPath);
+    try {
+      userlist.Load(userlistPath);
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->warn("Failed to reload the userlist. Details: {}", e.what());
+      }
+      userlist.Clear();
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(masterlistMutex_);
+  masterlist_ = std::move(masterlist);
+  userlist_ = std::move(userlist);
+  masterlistPath_ = masterlistPath;
+  masterlistIdentity_ = masterlistIdentity;
+  userlistPath_ = userlistPath;
+  userlistIdentity_ = userlistIdentity;
+
+  ClearEvaluatedMetadata();
+}
+
 ////////////////////////////////////
 // LOOT Functionality Functions
 ////////////////////////////////////
@@ -99,9 +179,111 @@ bool ApiDatabase::UpdateMasterlist(const std::string& masterlistPath,
     throw std::invalid_argument("Given masterlist path \"" + masterlistPath +
                                 "\" does not have a valid parent directory.");
 
+  return UpdateAndReplaceMasterlist(
+      masterlistPath, remoteURL, remoteBranch, nullptr);
+}
+
+std::future<bool> ApiDatabase::UpdateMasterlistAsync(
+    const std::string& masterlistPath,
+    const std::string& remoteURL,
+    const std::string& remoteBranch,
+    const TransferProgressCallback& progressCallback) {
+  if (!boost::filesystem::is_directory(
+          boost::filesystem::path(masterlistPath).parent_path()))
+    throw std::invalid_argument("Given masterlist path \"" + masterlistPath +
+                                "\" does not have a valid parent directory.");
+
+  // Hold a reference to the database so that it outlives the update even if
+  // the caller releases its handle first.
+  // The update runs on its own thread rather than as an executor task, as it
+  // mostly waits on the network.
+  auto self = shared_from_this();
+  return std::async(
+      std::launch::async,
+      [self, masterlistPath, remoteURL, remoteBranch, progressCallback]() {
+        return self->UpdateAndReplaceMasterlist(
+            masterlistPath, remoteURL, remoteBranch, progressCallback);
+      });
+}
+
+bool ApiDatabase::UpdateMasterlistFromBundle(const std::string& masterlistPath,
+                                             const std::string& bundlePath,
+                                             const std::string& remoteBranch) {
+  if (!boost::filesystem::is_directory(
+          boost::filesystem::path(masterlistPath).parent_path()))
+    throw std::invalid_argument("Given masterlist path \"" + masterlistPath +
+                                "\" does not have a valid parent directory.");
+
+  StatisticsScope statisticsScope(statistics_.get());
+  std::lock_guard<std::mutex> updateGuard(updateMutex_);
+
+  Masterlist masterlist;
+  if (masterlist.UpdateFromBundle(masterlistPath, bundlePath, remoteBranch)) {
+    std::lock_guard<std::mutex> guard(masterlistMutex_);
+    masterlist_ = std::move(masterlist);
+    masterlistPath_ = masterlistPath;
+    masterlistIdentity_ = FileIdentity::Get(masterlistPath);
+    ClearEvaluatedMetadata();
+    return true;
+  }
+
+  return false;
+}
+
+void ApiDatabase::ReplaceLists(const std::string& masterlistPath,
+                               const Masterlist& masterlist,
+                               const FileIdentity& masterlistIdentity,
+                               const std::string& userlistPath) {
+  FileIdentity userlistIdentity = FileIdentity::Get(userlistPath);
+
+  MetadataList userTemp;
+  if (!userlistPath.empty()) {
+    if (boost::filesystem::exists(userlistPath)) {
+      userTemp.Load(userlistPath);
+    } else {
+      throw FileAccessError("The given userlist path does not exist: " +
+                            userlistPath);
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(masterlistMutex_);
+  masterlist_ = masterlist;
+  userlist_ = userTemp;
+  masterlistPath_ = masterlistPath;
+  masterlistIdentity_ = masterlistIdentity;
+  userlistPath_ = userlistPath;
+  userlistIdentity_ = userlistIdentity;
+
+  ClearEvaluatedMetadata();
+}
+
+void ApiDatabase::ClearEvaluatedMetadata() {
+  std::lock_guard<std::mutex> guard(evaluatedMetadataMutex_);
+  for (auto& cache : evaluatedMetadata_) {
+    cache.clear();
+  }
+
+  // Stops results evaluated from the old lists being cached.
+  ++listsGeneration_;
+}
+
+bool ApiDatabase::UpdateAndReplaceMasterlist(
+    const std::string& masterlistPath,
+    const std::string& remoteURL,
+    const std::string& remoteBranch,
+    const TransferProgressCallback& progressCallback) {
+  // Also called on the asynchronous update's own thread.
+  StatisticsScope statisticsScope(statistics_.get());
+  std::lock_guard<std::mutex> updateGuard(updateMutex_);
+
   Masterlist masterlist;
-  if (masterlist.Update(masterlistPath, remoteURL, remoteBranch)) {
-    masterlist_ = masterlist;
+  if (masterlist.Update(
+          masterlistPath, remoteURL, remoteBranch, progressCallback)) {
+    std::lock_guard<std::mutex> guard(masterlistMutex_);
+    masterlist_ = std::move(masterlist);
+    masterlistPath_ = masterlistPath;
+    masterlistIdentity_ = FileIdentity::Get(masterlistPath);
+    ClearEvaluatedMetadata();
     return true;
   }
 
@@ -124,6 +306,7 @@ bool ApiDatabase::IsLatestMasterlist(const std::string& masterlist_path,
 //////////////////////////
 
 std::set<std::string> ApiDatabase::GetKnownBashTags() const {
+  std::lock_guard<std::mutex> guard(masterlistMutex_);
   auto masterlistTags = masterlist_.BashTags();
   auto userlistTags = userlist_.BashTags();
 
@@ -136,7 +319,12 @@ std::set<std::string> ApiDatabase::GetKnownBashTags() const {
 
 std::vector<Message> ApiDatabase::GetGeneralMessages(
     bool evaluateConditions) const {
-  auto masterlistMessages = masterlist_.Messages();
+  StatisticsScope statisticsScope(statistics_.get());
+  std::vector<Message> masterlistMessages;
+  {
+    std::lock_guard<std::mutex> guard(masterlistMutex_);
+    masterlistMessages = masterlist_.Messages();
+  }
   auto userlistMessages = userlist_.Messages();
 
   if (!userlistMessages.empty()) {
@@ -163,14 +351,45 @@ std::vector<Message> ApiDatabase::GetGeneralMessages(
 PluginMetadata ApiDatabase::GetPluginMetadata(const std::string& plugin,
                                               bool includeUserMetadata,
                                               bool evaluateConditions) const {
-  PluginMetadata metadata = masterlist_.FindPlugin(plugin);
+  StatisticsScope statisticsScope(statistics_.get());
+  auto& evaluatedCache = evaluatedMetadata_[includeUserMetadata ? 1 : 0];
+  uint64_t cacheGeneration = 0;
+  uint64_t listsGeneration = 0;
+  if (evaluateConditions) {
+    cacheGeneration = gameCache_->GetGeneration();
+
+    std::lock_guard<std::mutex> guard(evaluatedMetadataMutex_);
+    auto it = evaluatedCache.find(plugin);
+    if (it != evaluatedCache.end() &&
+        it->second.cacheGeneration == cacheGeneration)
+      return it->second.metadata;
+
+    listsGeneration = listsGeneration_;
+  }
+
+  PluginMetadata metadata;
+  {
+    std::lock_guard<std::mutex> guard(masterlistMutex_);
+    metadata = masterlist_.FindPlugin(plugin);
+  }
 
   if (includeUserMetadata) {
     metadata.MergeMetadata(userlist_.FindPlugin(plugin));
   }
 
   if (evaluateConditions) {
-    return conditionEvaluator_.evaluateAll(metadata);
+    PluginMetadata evaluatedMetadata =
+        conditionEvaluator_.evaluateAll(metadata);
+
+    MemoryScope memoryScope(MemorySubsystem::conditionCache);
+    std::lock_guard<std::mutex> guard(evaluatedMetadataMutex_);
+    if (listsGeneration == listsGeneration_) {
+      auto& entry = evaluatedCache[plugin];
+      entry.cacheGeneration = cacheGeneration;
+      entry.metadata = evaluatedMetadata;
+    }
+
+    return evaluatedMetadata;
   }
 
   return metadata;
@@ -179,6 +398,7 @@ PluginMetadata ApiDatabase::GetPluginMetadata(const std::string& plugin,
 PluginMetadata ApiDatabase::GetPluginUserMetadata(
     const std::string& plugin,
     bool evaluateConditions) const {
+  StatisticsScope statisticsScope(statistics_.get());
   PluginMetadata metadata = userlist_.FindPlugin(plugin);
 
   if (evaluateConditions) {
@@ -191,13 +411,18 @@ PluginMetadata ApiDatabase::GetPluginUserMetadata(
 void ApiDatabase::SetPluginUserMetadata(const PluginMetadata& pluginMetadata) {
   userlist_.ErasePlugin(pluginMetadata);
   userlist_.AddPlugin(pluginMetadata);
+  ClearEvaluatedMetadata();
 }
 
 void ApiDatabase::DiscardPluginUserMetadata(const std::string& plugin) {
   userlist_.ErasePlugin(plugin);
+  ClearEvaluatedMetadata();
 }
 
-void ApiDatabase::DiscardAllUserMetadata() { userlist_.Clear(); }
+void ApiDatabase::DiscardAllUserMetadata() {
+  userlist_.Clear();
+  ClearEvaluatedMetadata();
+}
 
 // Writes a minimal masterlist that only contains mods that have Bash Tag
 // suggestions, and/or dirty messages, plus the Tag suggestions and/or messages
@@ -214,8 +439,14 @@ void ApiDatabase::WriteMinimalList(const std::string& outputFile,
     throw FileAccessError(
         "Output file exists but overwrite is not set to true.");
 
+  std::list<PluginMetadata> plugins;
+  {
+    std::lock_guard<std::mutex> guard(masterlistMutex_);
+    plugins = masterlist_.Plugins();
+  }
+
   MetadataList minimalList;
-  for (const auto& plugin : masterlist_.Plugins()) {
+  for (const auto& plugin : plugins) {
     PluginMetadata minimalPlugin(plugin.GetName());
     minimalPlugin.SetTags(plugin.GetTags());
     minimalPlugin.SetDirtyInfo(plugin.GetDirtyInfo());
@@ -25,12 +25,19 @@
 #ifndef LOOT_API_LOOT_DB
 #define LOOT_API_LOOT_DB
 
+#include <future>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "api/game/game_cache.h"
 #include "api/game/load_order_handler.h"
+#include "api/helpers/binary_stream.h"
+#include "api/helpers/file_identity.h"
+#include "api/helpers/statistics.h"
 #include "api/masterlist.h"
 #include "api/metadata/condition_evaluator.h"
 #include "api/metadata_list.h"
@@ -38,15 +45,25 @@
 #include "loot/enum/game_type.h"
 
 namespace loot {
-struct ApiDatabase : public DatabaseInterface {
+struct ApiDatabase : public DatabaseInterface,
+                     public std::enable_shared_from_this<ApiDatabase> {
   ApiDatabase(const GameType gameType,
               const boost::filesystem::path& dataPath,
               std::shared_ptr<GameCache> gameCache,
-              std::shared_ptr<LoadOrderHandler> loadOrderHandler);
+              std::shared_ptr<LoadOrderHandler> loadOrderHandler,
+              std::shared_ptr<StatisticCounters> statistics);
 
   void LoadLists(const std::string& masterlist_path,
                  const std::string& userlist_path = "");
 
+  // Loads the userlist and a copy of a masterlist that has already been
+  // parsed from the given path when the file had the given identity, so that
+  // databases can share a parsed masterlist.
+  void LoadLists(const std::string& masterlistPath,
+                 const Masterlist& masterlist,
+                 const FileIdentity& masterlistIdentity,
+                 const std::string& userlistPath);
+
   void WriteUserMetadata(const std::string& outputFile,
                          const bool overwrite) const;
 
@@ -57,6 +74,16 @@ struct ApiDatabase : public DatabaseInterface {
                         const std::string& remote_url,
                         const std::string& remote_branch);
 
+  std::future<bool> UpdateMasterlistAsync(
+      const std::string& masterlist_path,
+      const std::string& remote_url,
+      const std::string& remote_branch,
+      const TransferProgressCallback& progress_callback = nullptr);
+
+  bool UpdateMasterlistFromBundle(const std::string& masterlist_path,
+                                  const std::string& bundle_path,
+                                  const std::string& remote_branch);
+
   MasterlistInfo GetMasterlistRevision(const std::string& masterlist_path,
                                        const bool get_short_id) const;
 
@@ -81,11 +108,59 @@ struct ApiDatabase : public DatabaseInterface {
 
   void DiscardAllUserMetadata();
 
+  // Writes the loaded lists and the identities of the files they were loaded
+  // from. Restoring reloads any list whose file has changed since.
+  void WriteSnapshot(BinaryWriter& writer) const;
+  void RestoreSnapshot(BinaryReader& reader);
+
 private:
+  struct EvaluatedPluginMetadata {
+    uint64_t cacheGeneration;
+    PluginMetadata metadata;
+  };
+
+  void ReplaceLists(const std::string& masterlistPath,
+                    const Masterlist& masterlist,
+                    const FileIdentity& masterlistIdentity,
+                    const std::string& userlistPath);
+
+  bool UpdateAndReplaceMasterlist(
+      const std::string& masterlist_path,
+      const std::string& remote_url,
+      const std::string& remote_branch,
+      const TransferProgressCallback& progress_callback);
+
+  // Must be called after either list changes.
+  void ClearEvaluatedMetadata();
+
   std::shared_ptr<GameCache> gameCache_;
   ConditionEvaluator conditionEvaluator_;
+
+  // The statistics of the game handle that owns the database.
+  std::shared_ptr<StatisticCounters> statistics_;
+
+  // Guards masterlist_, which may be replaced by an asynchronous update, and
+  // the lists' paths and identities.
+  mutable std::mutex masterlistMutex_;
   Masterlist masterlist_;
   MetadataList userlist_;
+
+  std::string masterlistPath_;
+  FileIdentity masterlistIdentity_;
+  std::string userlistPath_;
+  FileIdentity userlistIdentity_;
+
+  // Serialises masterlist updates, which share the repository on disk.
+  std::mutex updateMutex_;
+
+  // The results of GetPluginMetadata() with conditions evaluated, keyed by
+  // the plugin name as given and indexed by whether user metadata was
+  // included. An entry is only used while the game cache's generation is the
+  // one it was evaluated with, so a hit only allocates the returned copy.
+  mutable std::mutex evaluatedMetadataMutex_;
+  mutable std::unordered_map<std::string, EvaluatedPluginMetadata>
+      evaluatedMetadata_[2];
+  uint64_t listsGeneration_;
 };
 }
 
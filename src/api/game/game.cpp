@@ -25,13 +25,20 @@
 #include "api/game/game.h"
 
 #include <algorithm>
-#include <cmath>
-#include <thread>
+#include <cstring>
+#include <iterator>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include "api/api_database.h"
+#include "api/helpers/binary_stream.h"
+#include "api/helpers/executor.h"
+#include "api/helpers/file_identity.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/memory_accounting.h"
+#include "api/helpers/tracing.h"
 #include "api/plugin/plugin_sorter.h"
 #include "loot/exception/file_access_error.h"
 
@@ -50,12 +57,80 @@
 
 using std::list;
 using std::string;
-using std::thread;
 using std::vector;
 
 namespace fs = boost::filesystem;
 
 namespace loot {
+namespace {
+const char SNAPSHOT_MAGIC[8] = {'L', 'O', 'O', 'T', 'S', 'N', 'A', 'P'};
+const uint32_t SNAPSHOT_VERSION = 2;
+const size_t SNAPSHOT_HEADER_SIZE =
+    sizeof(SNAPSHOT_MAGIC) + 2 * sizeof(uint32_t);
+
+uint32_t GetChecksum(const char* data, size_t size) {
+  boost::crc_32_type result;
+  result.process_bytes(data, size);
+  return result.checksum();
+}
+
+void WritePlugin(BinaryWriter& writer, const Plugin& plugin) {
+  const PluginFileKey& key = plugin.GetFileKey();
+  SharedPluginRecord record = plugin.GetRecord();
+
+  writer.Write(plugin.GetName());
+  writer.Write(key.path);
+  writer.Write(key.size);
+  writer.Write(key.modificationTime);
+
+  writer.Write(record.isHeaderOnly);
+  writer.Write(record.isEmpty);
+  writer.Write(record.isMaster);
+  writer.Write(record.isLightMaster);
+  writer.Write(record.crc);
+  writer.Write(static_cast<uint64_t>(record.numOverrideRecords));
+  writer.Write(record.description);
+  writer.Write(static_cast<uint32_t>(record.masters.size()));
+  for (const auto& master : record.masters) {
+    writer.Write(master);
+  }
+
+  writer.Write(plugin.LoadsArchive());
+}
+
+// Directory and plugin identities don't change when a file is edited in place,
+// so conditions that read file contents can't be checked for staleness.
+bool ReadsFileContents(const std::string& lowercasedCondition) {
+  return lowercasedCondition.find("checksum(") != std::string::npos ||
+         lowercasedCondition.find("version(") != std::string::npos;
+}
+
+void ReadPlugin(BinaryReader& reader,
+                std::string& name,
+                PluginFileKey& key,
+                SharedPluginRecord& record,
+                bool& loadsArchive) {
+  reader.Read(name);
+  reader.Read(key.path);
+  reader.Read(key.size);
+  reader.Read(key.modificationTime);
+
+  reader.Read(record.isHeaderOnly);
+  reader.Read(record.isEmpty);
+  reader.Read(record.isMaster);
+  reader.Read(record.isLightMaster);
+  reader.Read(record.crc);
+  record.numOverrideRecords = static_cast<size_t>(reader.Read<uint64_t>());
+  reader.Read(record.description);
+  uint32_t masterCount = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < masterCount; ++i) {
+    record.masters.push_back(reader.Read<std::string>());
+  }
+
+  reader.Read(loadsArchive);
+}
+}
+
 Game::Game(const GameType gameType,
            const boost::filesystem::path& gamePath,
            const boost::filesystem::path& localDataPath) :
@@ -63,7 +138,10 @@ Game::Game(const GameType gameType,
     gamePath_(gamePath),
     localDataPath_(localDataPath),
     cache_(std::make_shared<GameCache>()),
-    loadOrderHandler_(std::make_shared<LoadOrderHandler>()) {
+    loadOrderHandler_(std::make_shared<LoadOrderHandler>()),
+    statistics_(std::make_shared<StatisticCounters>()),
+    retainSortGraph_(false) {
+  StatisticsScope statisticsScope(statistics_.get());
   auto logger = getLogger();
   if (logger) {
     logger->info("Initialising load order data for game of type {} at: {}",
@@ -74,7 +152,31 @@ Game::Game(const GameType gameType,
   loadOrderHandler_->Init(type_, gamePath_, localDataPath_);
 
   database_ = std::make_shared<ApiDatabase>(
-      Type(), DataPath(), GetCache(), GetLoadOrderHandler());
+      Type(), DataPath(), GetCache(), GetLoadOrderHandler(), statistics_);
+}
+
+// The atomic member isn't copyable, so this does what the implicit copy
+// constructor would, with copies sharing the original's cache, load order
+// handler, database and statistics.
+Game::Game(const Game& game) :
+    cache_(game.cache_),
+    loadOrderHandler_(game.loadOrderHandler_),
+    database_(game.database_),
+    type_(game.type_),
+    gamePath_(game.gamePath_),
+    localDataPath_(game.localDataPath_),
+    masterFile_(game.masterFile_),
+    statistics_(game.statistics_),
+    retainSortGraph_(game.retainSortGraph_.load()),
+    sortGraph_(std::atomic_load(&game.sortGraph_)) {}
+
+Game::~Game() {
+  // If logging is asynchronous, make sure that the handle's messages reach the
+  // client before it's gone.
+  auto logger = getLogger();
+  if (logger) {
+    logger->flush();
+  }
 }
 
 GameType Game::Type() const { return type_; }
@@ -90,11 +192,16 @@ std::shared_ptr<LoadOrderHandler> Game::GetLoadOrderHandler() {
 std::shared_ptr<DatabaseInterface> Game::GetDatabase() { return database_; }
 
 bool Game::IsValidPlugin(const std::string& plugin) const {
+  StatisticsScope statisticsScope(statistics_.get());
   return Plugin::IsValid(plugin, Type(), DataPath());
 }
 
 void Game::LoadPlugins(const std::vector<std::string>& plugins,
                        bool loadHeadersOnly) {
+  StatisticsScope statisticsScope(statistics_.get());
+  StatisticTimer timer(Statistic::loadPluginsTime);
+  TraceScope scope("LoadPlugins", "plugins");
+
   auto logger = getLogger();
   uintmax_t meanFileSize = 0;
   std::multimap<uintmax_t, string> sizeMap;
@@ -115,79 +222,44 @@ void Game::LoadPlugins(const std::vector<std::string>& plugins,
   }
   meanFileSize /= sizeMap.size();  // Rounding error, but not important.
 
-  // Get the number of threads to use.
-  // hardware_concurrency() may be zero, if so then use only one thread.
-  size_t threadsToUse =
-      ::std::min((size_t)thread::hardware_concurrency(), sizeMap.size());
-  threadsToUse = ::std::max(threadsToUse, (size_t)1);
+  // Load the largest plugins first, so that the threads finish loading at
+  // around the same time.
+  vector<string> pluginNames;
+  for (auto it = sizeMap.rbegin(); it != sizeMap.rend(); ++it) {
+    pluginNames.push_back(it->second);
+  }
 
-  // Divide the plugins up by thread.
-  unsigned int pluginsPerThread = ceil((double)sizeMap.size() / threadsToUse);
-  vector<vector<string>> pluginGroups(threadsToUse);
   if (logger) {
-    logger->info(
-        "Loading {} plugins using {} threads, with up to {} plugins per "
-        "thread.",
-        sizeMap.size(),
-        threadsToUse,
-        pluginsPerThread);
-  }
-
-  // The plugins should be split between the threads so that the data
-  // load is as evenly spread as possible.
-  size_t currentGroup = 0;
-  for (const auto& plugin : sizeMap) {
-    if (currentGroup == threadsToUse) {
-      currentGroup = 0;
-    }
-
-    if (logger) {
-      logger->trace(
-          "Adding plugin {} to loading group {}", plugin.second, currentGroup);
-    }
-
-    pluginGroups[currentGroup].push_back(plugin.second);
-    ++currentGroup;
+    logger->info("Loading {} plugins using up to {} threads.",
+                 pluginNames.size(),
+                 std::min<size_t>(getMaxConcurrency(), pluginNames.size()));
   }
 
-  // Clear the existing plugin cache.
+  // Clear the existing plugin cache, and reload the load order state if it has
+  // changed.
   cache_->ClearCachedPlugins();
   loadOrderHandler_->LoadCurrentState();
 
   // Load the plugins.
-  if (logger) {
-    logger->trace("Starting plugin loading.");
-  }
-  vector<thread> threads;
-  while (threads.size() < threadsToUse) {
-    vector<string>& pluginGroup = pluginGroups[threads.size()];
-    threads.push_back(thread([&]() {
-      for (auto pluginName : pluginGroup) {
-        if (logger) {
-          logger->trace("Loading {}", pluginName);
-        }
-        const bool loadHeader =
-            boost::iequals(pluginName, masterFile_) || loadHeadersOnly;
-        try {
-          cache_->AddPlugin(Plugin(
-              Type(), DataPath(), loadOrderHandler_, pluginName, loadHeader));
-        } catch (std::exception& e) {
-          if (logger) {
-            logger->trace(
-                "Caught exception while trying to add {} to the cache: {}",
-                pluginName,
-                e.what());
-          }
-        }
-      }
-    }));
-  }
-
-  // Join all threads.
-  for (auto& thread : threads) {
-    if (thread.joinable())
-      thread.join();
-  }
+  LOOT_LOG_TRACE(logger, "Starting plugin loading.");
+  ParallelFor(pluginNames.size(), [&](size_t index) {
+    MemoryScope memoryScope(MemorySubsystem::plugins);
+    StatisticsScope statisticsScope(statistics_.get());
+    const string& pluginName = pluginNames[index];
+    TraceScope pluginScope("LoadPlugin", "plugins", pluginName);
+    LOOT_LOG_TRACE(logger, "Loading {}", pluginName);
+    const bool loadHeader =
+        boost::iequals(pluginName, masterFile_) || loadHeadersOnly;
+    try {
+      cache_->AddPlugin(Plugin(
+          Type(), DataPath(), loadOrderHandler_, pluginName, loadHeader));
+    } catch (std::exception& e) {
+      LOOT_LOG_TRACE(logger,
+                     "Caught exception while trying to add {} to the cache: {}",
+                     pluginName,
+                     e.what());
+    }
+  });
 }
 
 std::shared_ptr<const PluginInterface> Game::GetPlugin(
@@ -213,18 +285,60 @@ void Game::IdentifyMainMasterFile(const std::string& masterFile) {
 
 std::vector<std::string> Game::SortPlugins(
     const std::vector<std::string>& plugins) {
+  StatisticsScope statisticsScope(statistics_.get());
+  StatisticTimer timer(Statistic::sortPluginsTime);
+  TraceScope scope("SortPlugins", "sorting");
+
   LoadPlugins(plugins, false);
 
   // Sort plugins into their load order.
+  MemoryScope memoryScope(MemorySubsystem::sorting);
   PluginSorter sorter;
-  return sorter.Sort(*this);
+  std::vector<std::string> sortedPlugins = sorter.Sort(*this);
+
+  // The sorter's graph refers to the loaded plugins, so copy it while they're
+  // still loaded.
+  if (retainSortGraph_.load()) {
+    std::atomic_store(&sortGraph_,
+                      std::make_shared<const SortGraph>(sorter.GetSortGraph()));
+
+    // Don't keep the graph if retaining it was turned off while sorting.
+    if (!retainSortGraph_.load())
+      std::atomic_store(&sortGraph_, std::shared_ptr<const SortGraph>());
+  }
+
+  return sortedPlugins;
 }
 
-void Game::LoadCurrentLoadOrderState() {
-  loadOrderHandler_->LoadCurrentState();
+void Game::SetRetainSortGraph(bool retain) {
+  retainSortGraph_.store(retain);
+
+  if (!retain)
+    std::atomic_store(&sortGraph_, std::shared_ptr<const SortGraph>());
+}
+
+std::vector<SortGraphEdge> Game::GetSortGraphPath(
+    const std::string& fromPlugin,
+    const std::string& toPlugin) const {
+  auto sortGraph = std::atomic_load(&sortGraph_);
+  if (!sortGraph)
+    throw std::logic_error("No sort graph has been kept");
+
+  return sortGraph->FindPath(fromPlugin, toPlugin);
+}
+
+void Game::LoadCurrentLoadOrderState(bool force) {
+  StatisticsScope statisticsScope(statistics_.get());
+  loadOrderHandler_->LoadCurrentState(force);
+}
+
+bool Game::IsLoadOrderStateStale() const {
+  StatisticsScope statisticsScope(statistics_.get());
+  return loadOrderHandler_->IsStateStale();
 }
 
 bool Game::IsPluginActive(const std::string& plugin) const {
+  StatisticsScope statisticsScope(statistics_.get());
   try {
     return std::static_pointer_cast<const Plugin>(GetPlugin(plugin))
         ->IsActive();
@@ -234,10 +348,206 @@ bool Game::IsPluginActive(const std::string& plugin) const {
 }
 
 std::vector<std::string> Game::GetLoadOrder() const {
+  StatisticsScope statisticsScope(statistics_.get());
   return loadOrderHandler_->GetLoadOrder();
 }
 
 void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
+  StatisticsScope statisticsScope(statistics_.get());
   loadOrderHandler_->SetLoadOrder(loadOrder);
 }
+
+void Game::SetLoadOrderWriteDelay(unsigned int milliseconds) {
+  // The load order handler's writer thread counts its statistics in the
+  // scope that it's started in.
+  StatisticsScope statisticsScope(statistics_.get());
+  loadOrderHandler_->SetWriteDelay(std::chrono::milliseconds(milliseconds));
+}
+
+void Game::FlushLoadOrder() {
+  StatisticsScope statisticsScope(statistics_.get());
+  loadOrderHandler_->Flush();
+}
+
+void Game::SaveSnapshot(const std::string& snapshotPath) {
+  StatisticsScope statisticsScope(statistics_.get());
+  TraceScope scope("SaveSnapshot", "snapshot");
+
+  BinaryWriter writer;
+  writer.Write(static_cast<uint32_t>(type_));
+  writer.Write(DataPath().string());
+  writer.Write(masterFile_);
+
+  loadOrderHandler_->WriteSnapshot(writer);
+
+  // The identities of the game and data directories are read before the
+  // plugins and conditions, so that later changes invalidate them.
+  FileIdentity::Get(gamePath_).Write(writer);
+  FileIdentity::Get(DataPath()).Write(writer);
+
+  auto plugins = cache_->GetPlugins();
+  writer.Write(static_cast<uint32_t>(plugins.size()));
+  for (const auto& plugin : plugins) {
+    WritePlugin(writer, *plugin);
+  }
+
+  std::static_pointer_cast<ApiDatabase>(database_)->WriteSnapshot(writer);
+
+  auto conditions = cache_->GetCachedConditions();
+  for (auto it = conditions.begin(); it != conditions.end();) {
+    if (ReadsFileContents(it->first))
+      it = conditions.erase(it);
+    else
+      ++it;
+  }
+  writer.Write(static_cast<uint32_t>(conditions.size()));
+  for (const auto& condition : conditions) {
+    writer.Write(condition.first);
+    writer.Write(condition.second);
+  }
+
+  const std::string& payload = writer.GetBuffer();
+  uint32_t checksum = GetChecksum(payload.data(), payload.size());
+
+  // Write to a temporary file first so that an existing snapshot is never
+  // left half-written.
+  fs::path tempPath = snapshotPath + ".tmp";
+  fs::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+  if (!out.good())
+    throw FileAccessError("Cannot open the snapshot file \"" + snapshotPath +
+                          "\" for writing.");
+
+  out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  out.write(reinterpret_cast<const char*>(&SNAPSHOT_VERSION),
+            sizeof(SNAPSHOT_VERSION));
+  out.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+  out.write(payload.data(), payload.size());
+  out.close();
+  if (out.fail())
+    throw FileAccessError("Cannot write the snapshot file \"" + snapshotPath +
+                          "\".");
+
+  fs::rename(tempPath, snapshotPath);
+}
+
+void Game::RestoreSnapshot(const std::string& snapshotPath) {
+  StatisticsScope statisticsScope(statistics_.get());
+  TraceScope scope("RestoreSnapshot", "snapshot");
+  auto logger = getLogger();
+
+  fs::ifstream in(snapshotPath, std::ios::binary);
+  if (!in.good())
+    throw FileAccessError("Cannot open the snapshot file \"" + snapshotPath +
+                          "\".");
+
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  in.close();
+
+  bool isValid = content.size() >= SNAPSHOT_HEADER_SIZE &&
+                 content.compare(0,
+                                 sizeof(SNAPSHOT_MAGIC),
+                                 SNAPSHOT_MAGIC,
+                                 sizeof(SNAPSHOT_MAGIC)) == 0;
+
+  const char* payload = nullptr;
+  size_t payloadSize = 0;
+  if (isValid) {
+    uint32_t version = 0;
+    uint32_t checksum = 0;
+    std::memcpy(&version, &content[sizeof(SNAPSHOT_MAGIC)], sizeof(version));
+    std::memcpy(&checksum,
+                &content[sizeof(SNAPSHOT_MAGIC) + sizeof(version)],
+                sizeof(checksum));
+
+    payload = content.data() + SNAPSHOT_HEADER_SIZE;
+    payloadSize = content.size() - SNAPSHOT_HEADER_SIZE;
+    isValid = version == SNAPSHOT_VERSION &&
+              checksum == GetChecksum(payload, payloadSize);
+  }
+
+  if (!isValid)
+    throw FileAccessError("\"" + snapshotPath +
+                          "\" is not a valid snapshot file.");
+
+  BinaryReader reader(payload, payloadSize);
+  GameType gameType = static_cast<GameType>(reader.Read<uint32_t>());
+  std::string dataPath = reader.Read<std::string>();
+  if (gameType != type_ || dataPath != DataPath().string())
+    throw std::invalid_argument(
+        "The snapshot was saved for a different game.");
+
+  masterFile_ = reader.Read<std::string>();
+
+  cache_->ClearCachedPlugins();
+  cache_->ClearCachedConditions();
+
+  bool isLoadOrderStateCurrent = loadOrderHandler_->RestoreSnapshot(reader);
+  LOOT_LOG_DEBUG(logger,
+                 "The snapshot's load order state is {}.",
+                 isLoadOrderStateCurrent ? "current" : "stale");
+
+  bool isGamePathCurrent =
+      FileIdentity::Read(reader) == FileIdentity::Get(gamePath_);
+  bool isDataPathCurrent =
+      FileIdentity::Read(reader) == FileIdentity::Get(DataPath());
+
+  uint32_t pluginCount = reader.Read<uint32_t>();
+  if (pluginCount > 0)
+    loadOrderHandler_->LoadCurrentState();
+
+  bool arePluginsCurrent = true;
+  for (uint32_t i = 0; i < pluginCount; ++i) {
+    std::string name;
+    PluginFileKey key;
+    key.gameType = type_;
+    SharedPluginRecord record;
+    bool loadsArchive = false;
+    ReadPlugin(reader, name, key, record, loadsArchive);
+
+    try {
+      MemoryScope memoryScope(MemorySubsystem::plugins);
+      if (PluginFileKey::Get(type_, key.path) == key) {
+        // Archives can only have been added or removed if the data
+        // directory has changed.
+        if (!isDataPathCurrent)
+          loadsArchive = Plugin::LoadsArchive(name, type_, DataPath());
+
+        cache_->AddPlugin(Plugin(
+            type_, loadOrderHandler_, name, key, record, loadsArchive));
+        continue;
+      }
+
+      arePluginsCurrent = false;
+      LOOT_LOG_DEBUG(logger, "{} has changed, loading it again.", name);
+      cache_->AddPlugin(Plugin(
+          type_, DataPath(), loadOrderHandler_, name, record.isHeaderOnly));
+    } catch (std::exception& e) {
+      arePluginsCurrent = false;
+      LOOT_LOG_DEBUG(
+          logger, "Could not restore {} from the snapshot: {}", name, e.what());
+    }
+  }
+
+  std::static_pointer_cast<ApiDatabase>(database_)->RestoreSnapshot(reader);
+
+  // Conditions can depend on any file and on which plugins are active, so
+  // are only restored if nothing that they could depend on has visibly
+  // changed. Conditions that read file contents were never written.
+  bool areConditionsCurrent = isLoadOrderStateCurrent && isGamePathCurrent &&
+                              isDataPathCurrent && arePluginsCurrent;
+  uint32_t conditionCount = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < conditionCount; ++i) {
+    std::string condition = reader.Read<std::string>();
+    bool result = reader.Read<bool>();
+    if (areConditionsCurrent)
+      cache_->CacheCondition(condition, result);
+  }
+}
+
+GameStatistics Game::GetStatistics() const {
+  return ToGameStatistics(statistics_->GetValues(), StatisticValues());
+}
+
+void Game::ResetStatistics() { statistics_->Reset(); }
 }
@@ -25,12 +25,15 @@
 #ifndef LOOT_API_GAME_GAME
 #define LOOT_API_GAME_GAME
 
+#include <atomic>
 #include <string>
 
 #include <boost/filesystem.hpp>
 
 #include "api/game/game_cache.h"
 #include "api/game/load_order_handler.h"
+#include "api/helpers/statistics.h"
+#include "api/plugin/sort_graph.h"
 #include "loot/game_interface.h"
 
 namespace loot {
@@ -39,6 +42,8 @@ public:
   Game(const GameType gameType,
        const boost::filesystem::path& gamePath = "",
        const boost::filesystem::path& gameLocalDataPath = "");
+  Game(const Game& game);
+  ~Game();
 
   // Internal Methods //
   //////////////////////
@@ -68,7 +73,15 @@ public:
 
   std::vector<std::string> SortPlugins(const std::vector<std::string>& plugins);
 
-  void LoadCurrentLoadOrderState();
+  void SetRetainSortGraph(bool retain);
+
+  std::vector<SortGraphEdge> GetSortGraphPath(
+      const std::string& fromPlugin,
+      const std::string& toPlugin) const;
+
+  void LoadCurrentLoadOrderState(bool force = false);
+
+  bool IsLoadOrderStateStale() const;
 
   bool IsPluginActive(const std::string& pluginName) const;
 
@@ -76,6 +89,18 @@ public:
 
   void SetLoadOrder(const std::vector<std::string>& loadOrder);
 
+  void SetLoadOrderWriteDelay(unsigned int milliseconds);
+
+  void FlushLoadOrder();
+
+  void SaveSnapshot(const std::string& snapshotPath);
+
+  void RestoreSnapshot(const std::string& snapshotPath);
+
+  GameStatistics GetStatistics() const;
+
+  void ResetStatistics();
+
 private:
   std::shared_ptr<GameCache> cache_;
   std::shared_ptr<LoadOrderHandler> loadOrderHandler_;
@@ -86,6 +111,12 @@ private:
   const boost::filesystem::path localDataPath_;
 
   std::string masterFile_;
+
+  // Shared with the database and any copies of this handle.
+  std::shared_ptr<StatisticCounters> statistics_;
+
+  std::atomic<bool> retainSortGraph_;
+  std::shared_ptr<const SortGraph> sortGraph_;
 };
 }
 #endif
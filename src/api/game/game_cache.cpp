@@ -29,46 +29,77 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/locale.hpp>
 
+#include "api/helpers/memory_accounting.h"
+#include "api/helpers/statistics.h"
+
 using boost::locale::to_lower;
 using std::lock_guard;
-using std::mutex;
 using std::pair;
 using std::string;
 
 namespace loot {
-GameCache::GameCache() {}
+GameCache::GameCache() : generation_(0) {}
 
-GameCache::GameCache(const GameCache& cache) :
-    conditions_(cache.conditions_),
-    plugins_(cache.plugins_) {}
+GameCache::GameCache(const GameCache& cache) {
+  lock_guard<Mutex> guard(cache.mutex_);
+  conditions_ = cache.conditions_;
+  plugins_ = cache.plugins_;
+  generation_ = cache.generation_;
+}
 
 GameCache& GameCache::operator=(const GameCache& cache) {
   if (&cache != this) {
+    std::lock(mutex_, cache.mutex_);
+    lock_guard<Mutex> guard(mutex_, std::adopt_lock);
+    lock_guard<Mutex> otherGuard(cache.mutex_, std::adopt_lock);
+
     conditions_ = cache.conditions_;
     plugins_ = cache.plugins_;
+    ++generation_;
   }
 
   return *this;
 }
 
+// Lowercasing and allocating are done before locking to keep the time that
+// the mutex is held, and so other threads' waits, short.
 void GameCache::CacheCondition(const std::string& condition, bool result) {
-  lock_guard<mutex> guard(mutex_);
-  conditions_.insert(pair<string, bool>(to_lower(condition), result));
+  MemoryScope memoryScope(MemorySubsystem::conditionCache);
+  auto entry = pair<string, bool>(to_lower(condition), result);
+
+  lock_guard<Mutex> guard(mutex_);
+  conditions_.insert(std::move(entry));
 }
 
 std::pair<bool, bool> GameCache::GetCachedCondition(
     const std::string& condition) const {
-  lock_guard<mutex> guard(mutex_);
-
-  auto it = conditions_.find(to_lower(condition));
+  const string lowercasedCondition = to_lower(condition);
+  pair<bool, bool> result(false, false);
+  {
+    lock_guard<Mutex> guard(mutex_);
+
+    auto it = conditions_.find(lowercasedCondition);
+    if (it != conditions_.end())
+      result = pair<bool, bool>(it->second, true);
+  }
 
-  if (it != conditions_.end())
-    return pair<bool, bool>(it->second, true);
+  if (result.second)
+    IncrementStatistic(Statistic::conditionCacheHits);
   else
-    return pair<bool, bool>(false, false);
+    IncrementStatistic(Statistic::conditionCacheMisses);
+
+  return result;
+}
+
+std::unordered_map<std::string, bool> GameCache::GetCachedConditions() const {
+  lock_guard<Mutex> guard(mutex_);
+
+  return conditions_;
 }
 
 std::set<std::shared_ptr<const Plugin>> GameCache::GetPlugins() const {
+  lock_guard<Mutex> guard(mutex_);
+
   std::set<std::shared_ptr<const Plugin>> output;
   std::transform(
       begin(plugins_),
@@ -83,33 +114,43 @@ std::set<std::shared_ptr<const Plugin>> GameCache::GetPlugins() const {
 
 std::shared_ptr<const Plugin> GameCache::GetPlugin(
     const std::string& pluginName) const {
-  auto it = plugins_.find(to_lower(pluginName));
-  if (it != end(plugins_))
-    return it->second;
+  const string lowercasedName = to_lower(pluginName);
+  {
+    lock_guard<Mutex> guard(mutex_);
+
+    auto it = plugins_.find(lowercasedName);
+    if (it != end(plugins_))
+      return it->second;
+  }
 
   throw std::invalid_argument("No plugin \"" + pluginName + "\" exists.");
 }
 
 void GameCache::AddPlugin(const Plugin&& plugin) {
-  lock_guard<mutex> lock(mutex_);
+  auto pointer = std::make_shared<Plugin>(std::move(plugin));
 
-  auto it = plugins_.find(plugin.GetLowercasedName());
-  if (it != end(plugins_))
-    plugins_.erase(it);
-
-  plugins_.emplace(plugin.GetLowercasedName(),
-                   std::make_shared<Plugin>(std::move(plugin)));
+  lock_guard<Mutex> lock(mutex_);
+  plugins_[pointer->GetLowercasedName()] = pointer;
+  ++generation_;
 }
 
 void GameCache::ClearCachedConditions() {
-  lock_guard<mutex> guard(mutex_);
+  lock_guard<Mutex> guard(mutex_);
 
   conditions_.clear();
+  ++generation_;
 }
 
 void GameCache::ClearCachedPlugins() {
-  lock_guard<mutex> guard(mutex_);
+  lock_guard<Mutex> guard(mutex_);
 
   plugins_.clear();
+  ++generation_;
+}
+
+uint64_t GameCache::GetGeneration() const {
+  lock_guard<Mutex> guard(mutex_);
+
+  return generation_;
 }
 }
@@ -25,10 +25,12 @@
 #ifndef LOOT_API_GAME_GAME_CACHE
 #define LOOT_API_GAME_GAME_CACHE
 
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 
+#include "api/helpers/instrumented_mutex.h"
 #include "api/plugin/plugin.h"
 
 namespace loot {
@@ -42,6 +44,8 @@ public:
   // Returns false for second bool if no cached condition.
   std::pair<bool, bool> GetCachedCondition(const std::string& condition) const;
   void CacheCondition(const std::string& condition, bool result);
+  // Returns the cached condition results, keyed by lowercased condition.
+  std::unordered_map<std::string, bool> GetCachedConditions() const;
 
   std::set<std::shared_ptr<const Plugin>> GetPlugins() const;
   std::shared_ptr<const Plugin> GetPlugin(const std::string& pluginName) const;
@@ -50,11 +54,19 @@ public:
   void ClearCachedConditions();
   void ClearCachedPlugins();
 
+  // Returns a number that changes whenever cached plugins are added or
+  // cleared, or cached conditions are cleared, so that results derived from
+  // the cache can tell if they might be stale.
+  uint64_t GetGeneration() const;
+
 private:
   std::unordered_map<std::string, bool> conditions_;
   std::unordered_map<std::string, std::shared_ptr<const Plugin>> plugins_;
+  uint64_t generation_;
+
+  typedef InstrumentedMutex<Statistic::gameCacheLockWaitTime> Mutex;
 
-  mutable std::mutex mutex_;
+  mutable Mutex mutex_;
 };
 }
 
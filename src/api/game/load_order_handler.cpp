@@ -24,19 +24,45 @@
 
 #include "api/game/load_order_handler.h"
 
+#include <atomic>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <boost/locale.hpp>
 
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
 #include "loot/exception/error_categories.h"
 
 using boost::format;
+using boost::locale::to_lower;
 using std::string;
 
 namespace loot {
-LoadOrderHandler::LoadOrderHandler() : gh_(nullptr) {}
+LoadOrderHandler::LoadOrderHandler() :
+    gh_(nullptr),
+    stateFileStatusesTime_(0),
+    isStateLoaded_(false),
+    isHandleStateLoaded_(false),
+    writeDelay_(0),
+    hasPendingWrite_(false),
+    isWriting_(false),
+    stopWriter_(false) {}
+
+LoadOrderHandler::~LoadOrderHandler() {
+  try {
+    Flush();
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to write the pending load order. Details: {}",
+                    e.what());
+    }
+  }
+  StopWriter();
 
-LoadOrderHandler::~LoadOrderHandler() { lo_destroy_handle(gh_); }
+  lo_destroy_handle(gh_);
+}
 
 void LoadOrderHandler::Init(const GameType& gameType,
                             const boost::filesystem::path& gamePath,
@@ -45,6 +71,10 @@ void LoadOrderHandler::Init(const GameType& gameType,
     throw std::invalid_argument("Game path is not initialised.");
   }
 
+  // Write any pending load order using the handle it was set for.
+  Flush();
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
   const char* gameLocalDataPath = nullptr;
   string tempPathString = gameLocalAppData.string();
   if (!tempPathString.empty())
@@ -55,7 +85,14 @@ void LoadOrderHandler::Init(const GameType& gameType,
     lo_destroy_handle(gh_);
     gh_ = nullptr;
   }
-
+  std::atomic_store(&state_, std::shared_ptr<const State>());
+  stateFileStatuses_.clear();
+  isStateLoaded_ = false;
+  isHandleStateLoaded_ = false;
+  gamePath_ = gamePath;
+  localPath_ = gameLocalAppData;
+
+  IncrementStatistic(Statistic::libloadorderCalls);
   int ret;
   if (gameType == GameType::tes4)
     ret = lo_create_handle(
@@ -79,82 +116,467 @@ void LoadOrderHandler::Init(const GameType& gameType,
     ret = LIBLO_ERROR_INVALID_ARGS;
 
   HandleError("create a game handle", ret);
+
+  // No state has been loaded yet.
+  std::atomic_store(&state_, std::make_shared<const State>());
 }
 
-void LoadOrderHandler::LoadCurrentState() {
+void LoadOrderHandler::LoadCurrentState(bool force) {
   auto logger = getLogger();
-  if (logger) {
-    logger->debug("Loading the current load order state.");
+  if (!force && !IsStateStale()) {
+    LOOT_LOG_DEBUG(
+        logger, "The load order state is unchanged, not reloading it.");
+    return;
   }
 
+  // Reloading the state would discard a pending load order.
+  Flush();
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
+  LOOT_LOG_DEBUG(logger, "Loading the current load order state.");
+
+  // Read the file statuses before loading, so that changes made while the
+  // state is loading make it stale.
+  std::time_t statusesTime = std::time(nullptr);
+  auto statuses = GetStateFileStatuses();
+
+  IncrementStatistic(Statistic::libloadorderCalls);
   unsigned int ret = lo_load_current_state(gh_);
 
   HandleError("load the current load order state", ret);
+
+  UpdateState();
+
+  stateFileStatuses_ = statuses;
+  stateFileStatusesTime_ = statusesTime;
+  isStateLoaded_ = true;
+  isHandleStateLoaded_ = true;
+}
+
+bool LoadOrderHandler::IsStateStale() const {
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
+  // Without a local path, where libloadorder looks for plugins.txt isn't
+  // known, so changes can't be detected.
+  if (!isStateLoaded_ || localPath_.empty())
+    return true;
+
+  auto statuses = GetStateFileStatuses();
+  if (statuses.size() != stateFileStatuses_.size())
+    return true;
+
+  for (const auto& status : statuses) {
+    auto it = stateFileStatuses_.find(status.first);
+    if (it == stateFileStatuses_.end() || it->second != status.second)
+      return true;
+
+    // Modification times only have a resolution of a second, so a file
+    // modified in the same second as its status was read could have been
+    // changed again without its status changing. Treat such files as changed.
+    if (status.second.exists &&
+        status.second.modificationTime >= stateFileStatusesTime_)
+      return true;
+  }
+
+  return false;
 }
 
 bool LoadOrderHandler::IsPluginActive(const std::string& pluginName) const {
+  auto state = GetState();
+
+  return state->activePlugins.count(to_lower(pluginName)) != 0;
+}
+
+std::vector<std::string> LoadOrderHandler::GetLoadOrder() const {
+  return GetState()->loadOrder;
+}
+
+bool LoadOrderHandler::GetLoadOrderIndex(const std::string& pluginName,
+                                         size_t& index) const {
+  auto state = GetState();
+
+  auto it = state->loadOrderIndices.find(to_lower(pluginName));
+  if (it == state->loadOrderIndices.end())
+    return false;
+
+  index = it->second;
+  return true;
+}
+
+void LoadOrderHandler::SetWriteDelay(std::chrono::milliseconds delay) {
+  if (delay.count() <= 0) {
+    {
+      std::lock_guard<std::mutex> writeLock(writeMutex_);
+      writeDelay_ = std::chrono::milliseconds(0);
+    }
+
+    Flush();
+    StopWriter();
+    return;
+  }
+
+  std::lock_guard<std::mutex> writeLock(writeMutex_);
+  writeDelay_ = delay;
+
+  if (!writerThread_.joinable()) {
+    stopWriter_ = false;
+    writerThread_ = std::thread(
+        &LoadOrderHandler::RunWriter, this, GetStatisticCounters());
+  }
+}
+
+void LoadOrderHandler::SetLoadOrder(
+    const std::vector<std::string>& loadOrder) {
   auto logger = getLogger();
   if (logger) {
-    logger->debug("Checking if plugin \"{}\" is active.", pluginName);
+    logger->info("Setting load order.");
   }
+  for (const auto& plugin : loadOrder) {
+    LOOT_LOG_DEBUG(logger, "\t\t{}", plugin);
+  }
+
+  {
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    if (writeDelay_.count() > 0) {
+      RethrowWriteError();
+
+      UpdateState(loadOrder);
 
-  bool result = false;
-  unsigned int ret = lo_get_plugin_active(gh_, pluginName.c_str(), &result);
+      // Any load order that is already pending is superseded by this one.
+      pendingLoadOrder_ = loadOrder;
+      hasPendingWrite_ = true;
+      writeDeadline_ = std::chrono::steady_clock::now() + writeDelay_;
+      writeCondition_.notify_all();
 
-  HandleError("check if a plugin is active", ret);
+      if (logger) {
+        logger->info("Load order will be written in {} ms.",
+                     writeDelay_.count());
+      }
+      return;
+    }
+  }
+
+  WriteLoadOrder(loadOrder);
 
-  return result;
+  if (logger) {
+    logger->info("Load order set successfully.");
+  }
 }
 
-std::vector<std::string> LoadOrderHandler::GetLoadOrder() const {
+void LoadOrderHandler::Flush() {
+  std::vector<std::string> loadOrder;
+  {
+    std::unique_lock<std::mutex> writeLock(writeMutex_);
+
+    // Wait for any write in progress, so that its error isn't missed and it
+    // can't overwrite the load order written here.
+    writeCondition_.wait(writeLock, [&]() { return !isWriting_; });
+
+    RethrowWriteError();
+
+    if (!hasPendingWrite_)
+      return;
+
+    loadOrder = std::move(pendingLoadOrder_);
+    pendingLoadOrder_.clear();
+    hasPendingWrite_ = false;
+    isWriting_ = true;
+  }
+
   auto logger = getLogger();
-  if (logger) {
-    logger->debug("Getting load order.");
+  LOOT_LOG_DEBUG(logger, "Writing the pending load order.");
+
+  std::exception_ptr error;
+  try {
+    WriteLoadOrder(loadOrder);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    isWriting_ = false;
   }
+  writeCondition_.notify_all();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void LoadOrderHandler::WriteSnapshot(BinaryWriter& writer) {
+  // A pending load order is cached but not yet reflected in the state files'
+  // statuses.
+  Flush();
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
+  auto state = GetState();
+
+  writer.Write(isStateLoaded_);
+  writer.Write(static_cast<int64_t>(stateFileStatusesTime_));
+  writer.Write(static_cast<uint32_t>(stateFileStatuses_.size()));
+  for (const auto& status : stateFileStatuses_) {
+    writer.Write(status.first.string());
+    status.second.Write(writer);
+  }
+
+  writer.Write(static_cast<uint32_t>(state->loadOrder.size()));
+  for (const auto& plugin : state->loadOrder) {
+    writer.Write(plugin);
+  }
+
+  writer.Write(static_cast<uint32_t>(state->activePlugins.size()));
+  for (const auto& plugin : state->activePlugins) {
+    writer.Write(plugin);
+  }
+}
+
+bool LoadOrderHandler::RestoreSnapshot(BinaryReader& reader) {
+  bool wasStateLoaded = reader.Read<bool>();
+  std::time_t statusesTime =
+      static_cast<std::time_t>(reader.Read<int64_t>());
+
+  std::map<boost::filesystem::path, FileIdentity> statuses;
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    boost::filesystem::path path = reader.Read<std::string>();
+    statuses.emplace(path, FileIdentity::Read(reader));
+  }
+
+  auto state = std::make_shared<State>();
+  count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    state->loadOrder.push_back(reader.Read<std::string>());
+    state->loadOrderIndices.emplace(to_lower(state->loadOrder.back()), i);
+  }
+
+  count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    state->activePlugins.insert(reader.Read<std::string>());
+  }
+
+  // A pending load order would be newer than the snapshot's.
+  Flush();
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
+  // The same checks as IsStateStale(), but against the snapshot's statuses.
+  if (!wasStateLoaded || localPath_.empty())
+    return false;
+
+  if (GetStateFileStatuses() != statuses)
+    return false;
+
+  for (const auto& status : statuses) {
+    if (status.second.exists && status.second.modificationTime >= statusesTime)
+      return false;
+  }
+
+  std::atomic_store(&state_, std::shared_ptr<const State>(std::move(state)));
+  stateFileStatuses_ = statuses;
+  stateFileStatusesTime_ = statusesTime;
+  isStateLoaded_ = true;
+  isHandleStateLoaded_ = false;
+
+  return true;
+}
+
+std::shared_ptr<const LoadOrderHandler::State> LoadOrderHandler::GetState()
+    const {
+  auto state = std::atomic_load(&state_);
+  if (!state)
+    throw std::system_error(LIBLO_ERROR_INVALID_ARGS,
+                            libloadorder_category(),
+                            "The load order handler has not been initialised.");
+
+  return state;
+}
+
+void LoadOrderHandler::UpdateState() {
+  auto logger = getLogger();
+  LOOT_LOG_DEBUG(logger, "Caching the load order and active plugins.");
+
+  auto state = std::make_shared<State>();
 
   char** pluginArr;
   size_t pluginArrSize;
 
+  IncrementStatistic(Statistic::libloadorderCalls);
   unsigned int ret = lo_get_load_order(gh_, &pluginArr, &pluginArrSize);
-
   HandleError("get the load order", ret);
 
-  std::vector<string> loadOrder(pluginArr, pluginArr + pluginArrSize);
+  state->loadOrder.assign(pluginArr, pluginArr + pluginArrSize);
   lo_free_string_array(pluginArr, pluginArrSize);
 
-  return loadOrder;
+  IncrementStatistic(Statistic::libloadorderCalls);
+  ret = lo_get_active_plugins(gh_, &pluginArr, &pluginArrSize);
+  HandleError("get the active plugins", ret);
+
+  for (size_t i = 0; i < pluginArrSize; ++i) {
+    state->activePlugins.insert(to_lower(pluginArr[i]));
+  }
+  lo_free_string_array(pluginArr, pluginArrSize);
+
+  for (size_t i = 0; i < state->loadOrder.size(); ++i) {
+    state->loadOrderIndices.emplace(to_lower(state->loadOrder[i]), i);
+  }
+
+  std::atomic_store(&state_, std::shared_ptr<const State>(std::move(state)));
 }
 
-void LoadOrderHandler::SetLoadOrder(
-    const std::vector<std::string>& loadOrder) const {
-  auto logger = getLogger();
-  if (logger) {
-    logger->info("Setting load order.");
+void LoadOrderHandler::UpdateState(const std::vector<std::string>& loadOrder) {
+  // Setting the load order doesn't change which plugins are active.
+  auto state = std::make_shared<State>();
+  state->loadOrder = loadOrder;
+  state->activePlugins = GetState()->activePlugins;
+
+  for (size_t i = 0; i < state->loadOrder.size(); ++i) {
+    state->loadOrderIndices.emplace(to_lower(state->loadOrder[i]), i);
   }
 
-  size_t pluginArrSize = loadOrder.size();
-  char** pluginArr = new char*[pluginArrSize];
-  int i = 0;
+  std::atomic_store(&state_, std::shared_ptr<const State>(std::move(state)));
+}
+
+void LoadOrderHandler::WriteLoadOrder(
+    const std::vector<std::string>& loadOrder) {
+  std::vector<const char*> pluginArr;
+  pluginArr.reserve(loadOrder.size());
   for (const auto& plugin : loadOrder) {
-    if (logger) {
-      logger->info("\t\t{}", plugin);
+    pluginArr.push_back(plugin.c_str());
+  }
+
+  std::lock_guard<std::mutex> handleLock(handleMutex_);
+
+  // libloadorder validates and writes the load order using its own state, so
+  // it must be loaded if the cached state was restored from a snapshot.
+  if (!isHandleStateLoaded_) {
+    IncrementStatistic(Statistic::libloadorderCalls);
+    HandleError("load the current load order state",
+                lo_load_current_state(gh_));
+    isHandleStateLoaded_ = true;
+  }
+
+  IncrementStatistic(Statistic::libloadorderCalls);
+  unsigned int ret =
+      lo_set_load_order(gh_, pluginArr.data(), pluginArr.size());
+
+  std::exception_ptr error;
+  try {
+    HandleError("set the load order", ret);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  {
+    // If another load order was set while this one was being written, the
+    // cached state is newer than libloadorder's, so leave it alone. Otherwise
+    // resync it, which also undoes a cached load order that failed to write.
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    if (!hasPendingWrite_)
+      UpdateState();
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+
+  UpdateStateFileStatuses();
+}
+
+void LoadOrderHandler::RunWriter(
+    std::shared_ptr<StatisticCounters> statistics) {
+  StatisticsScope statisticsScope(statistics.get());
+  std::unique_lock<std::mutex> writeLock(writeMutex_);
+  while (!stopWriter_) {
+    if (!hasPendingWrite_ || isWriting_) {
+      writeCondition_.wait(writeLock);
+      continue;
+    }
+
+    // Each new load order pushes the deadline back, so that a burst of
+    // changes is written once.
+    if (std::chrono::steady_clock::now() < writeDeadline_) {
+      writeCondition_.wait_until(writeLock, writeDeadline_);
+      continue;
+    }
+
+    auto loadOrder = std::move(pendingLoadOrder_);
+    pendingLoadOrder_.clear();
+    hasPendingWrite_ = false;
+    isWriting_ = true;
+    writeLock.unlock();
+
+    std::exception_ptr error;
+    try {
+      WriteLoadOrder(loadOrder);
+    } catch (...) {
+      error = std::current_exception();
     }
 
-    pluginArr[i] = new char[plugin.length() + 1];
-    strcpy(pluginArr[i], plugin.c_str());
-    ++i;
+    writeLock.lock();
+    isWriting_ = false;
+    if (error)
+      writeError_ = error;
+    writeCondition_.notify_all();
   }
+}
 
-  unsigned int ret = lo_set_load_order(gh_, pluginArr, pluginArrSize);
+void LoadOrderHandler::StopWriter() {
+  {
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    stopWriter_ = true;
+  }
+  writeCondition_.notify_all();
 
-  for (size_t i = 0; i < pluginArrSize; i++) delete[] pluginArr[i];
-  delete[] pluginArr;
+  if (writerThread_.joinable())
+    writerThread_.join();
+}
 
-  HandleError("set the load order", ret);
+// Must be called with writeMutex_ locked.
+void LoadOrderHandler::RethrowWriteError() {
+  if (!writeError_)
+    return;
 
-  if (logger) {
-    logger->info("Load order set successfully.");
+  auto error = writeError_;
+  writeError_ = nullptr;
+  std::rethrow_exception(error);
+}
+
+std::map<boost::filesystem::path, FileIdentity>
+LoadOrderHandler::GetStateFileStatuses() const {
+  // Check every file that any game's load order could be read from, as files
+  // that a game doesn't use shouldn't exist or change.
+  std::vector<boost::filesystem::path> paths({
+      localPath_ / "plugins.txt",
+      localPath_ / "loadorder.txt",
+      gamePath_ / "Oblivion.ini",
+      gamePath_ / "Skyrim.ccc",
+      gamePath_ / "Fallout4.ccc",
+  });
+
+  // Some games' load orders are decided by plugin timestamps, and plugins
+  // being installed or uninstalled can change any game's load order.
+  boost::filesystem::path dataPath = gamePath_ / "Data";
+  if (boost::filesystem::is_directory(dataPath)) {
+    for (boost::filesystem::directory_iterator it(dataPath);
+         it != boost::filesystem::directory_iterator();
+         ++it) {
+      string extension = boost::to_lower_copy(it->path().extension().string());
+      if (extension == ".esp" || extension == ".esm" || extension == ".esl" ||
+          extension == ".ghost")
+        paths.push_back(it->path());
+    }
+  }
+
+  std::map<boost::filesystem::path, FileIdentity> statuses;
+  for (const auto& path : paths) {
+    statuses.emplace(path, FileIdentity::Get(path));
   }
+
+  return statuses;
+}
+
+void LoadOrderHandler::UpdateStateFileStatuses() {
+  stateFileStatusesTime_ = std::time(nullptr);
+  stateFileStatuses_ = GetStateFileStatuses();
+  isStateLoaded_ = true;
 }
 
 void LoadOrderHandler::HandleError(const std::string& operation,
@@ -165,6 +587,7 @@ void LoadOrderHandler::HandleError(const std::string& operation,
 
   const char* e = nullptr;
   string err;
+  IncrementStatistic(Statistic::libloadorderCalls);
   lo_get_error_message(&e);
   if (e == nullptr) {
     err = "libloadorder failed to " + operation +
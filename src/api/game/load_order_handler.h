@@ -25,13 +25,25 @@
 #ifndef LOOT_API_GAME_LOAD_ORDER_HANDLER
 #define LOOT_API_GAME_LOAD_ORDER_HANDLER
 
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <exception>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <boost/filesystem.hpp>
 #include <libloadorder.hpp>
 
+#include "api/helpers/binary_stream.h"
+#include "api/helpers/file_identity.h"
+#include "api/helpers/statistics.h"
 #include "loot/enum/game_type.h"
 
 namespace loot {
@@ -44,18 +56,96 @@ public:
             const boost::filesystem::path& gamePath,
             const boost::filesystem::path& gameLocalAppData = "");
 
-  void LoadCurrentState();
+  // Only reloads the state if it is stale, unless forced to.
+  void LoadCurrentState(bool force = false);
+
+  // Checks the sizes and modification times of the files that libloadorder
+  // reads the load order state from, so is much cheaper than reloading.
+  bool IsStateStale() const;
 
   std::vector<std::string> GetLoadOrder() const;
 
+  // Returns false if the plugin is not in the load order.
+  bool GetLoadOrderIndex(const std::string& pluginName, size_t& index) const;
+
   bool IsPluginActive(const std::string& pluginName) const;
 
-  void SetLoadOrder(const std::vector<std::string>& loadOrder) const;
+  // If the delay is non-zero, SetLoadOrder() only updates the cached state and
+  // the load order is written by a background thread once the delay has
+  // passed without it being set again. A delay of zero writes synchronously.
+  void SetWriteDelay(std::chrono::milliseconds delay);
+
+  void SetLoadOrder(const std::vector<std::string>& loadOrder);
+
+  // Writes any pending load order, and rethrows any error that a background
+  // write encountered.
+  void Flush();
+
+  // Writes the cached state and the state file statuses it was loaded with.
+  // Any pending load order is written first.
+  void WriteSnapshot(BinaryWriter& writer);
+
+  // Uses the snapshot's state if none of the state files have changed since
+  // it was written, and returns whether it was used. libloadorder doesn't
+  // load the state until it's needed to write a load order.
+  bool RestoreSnapshot(BinaryReader& reader);
 
 private:
+  // A copy of libloadorder's state, so that queries don't need to go through
+  // its FFI. Plugin names used as keys are lowercased.
+  struct State {
+    std::vector<std::string> loadOrder;
+    std::unordered_map<std::string, size_t> loadOrderIndices;
+    std::unordered_set<std::string> activePlugins;
+  };
+
+  std::shared_ptr<const State> GetState() const;
+  void UpdateState();
+  void UpdateState(const std::vector<std::string>& loadOrder);
+
+  void WriteLoadOrder(const std::vector<std::string>& loadOrder);
+  // The writer counts its statistics in the counters it's given.
+  void RunWriter(std::shared_ptr<StatisticCounters> statistics);
+  void StopWriter();
+  void RethrowWriteError();
+
+  std::map<boost::filesystem::path, FileIdentity> GetStateFileStatuses() const;
+  void UpdateStateFileStatuses();
+
   void HandleError(const std::string& operation, unsigned int returnCode) const;
 
   lo_game_handle gh_;
+  boost::filesystem::path gamePath_;
+  boost::filesystem::path localPath_;
+
+  // The statuses of the state files when the state was last loaded or set,
+  // and the time at which they were read.
+  std::map<boost::filesystem::path, FileIdentity> stateFileStatuses_;
+  std::time_t stateFileStatusesTime_;
+  bool isStateLoaded_;
+  // False if the cached state was restored from a snapshot without
+  // libloadorder loading it.
+  bool isHandleStateLoaded_;
+
+  // Accessed atomically, as plugins are loaded on several threads.
+  std::shared_ptr<const State> state_;
+
+  // Serialises use of the game handle and the state file statuses between
+  // the caller and the writer thread. Must be locked before writeMutex_ if
+  // both are needed.
+  mutable std::mutex handleMutex_;
+
+  // Write-behind state, guarded by writeMutex_.
+  std::mutex writeMutex_;
+  std::condition_variable writeCondition_;
+  std::thread writerThread_;
+  std::chrono::milliseconds writeDelay_;
+  std::chrono::steady_clock::time_point writeDeadline_;
+  std::vector<std::string> pendingLoadOrder_;
+  bool hasPendingWrite_;
+  bool isWriting_;
+  bool stopWriter_;
+  std::exception_ptr writeError_;
 };
 }
 
@@ -0,0 +1,106 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_BINARY_STREAM
+#define LOOT_API_HELPERS_BINARY_STREAM
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace loot {
+// Writes values to a buffer in the machine's own byte order, so the output is
+// only suitable for caches that are read back on the same machine.
+class BinaryWriter {
+public:
+  template<typename T>
+  void Write(T value) {
+    static_assert(std::is_arithmetic<T>::value,
+                  "Only arithmetic values can be written directly.");
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void Write(const std::string& value) {
+    Write(static_cast<uint32_t>(value.size()));
+    buffer_.append(value);
+  }
+
+  std::string& GetBuffer() { return buffer_; }
+
+private:
+  std::string buffer_;
+};
+
+// Reads values written by a BinaryWriter, throwing if the data ends before a
+// value does.
+class BinaryReader {
+public:
+  BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template<typename T>
+  void Read(T& value) {
+    static_assert(std::is_arithmetic<T>::value,
+                  "Only arithmetic values can be read directly.");
+    Check(sizeof(T));
+    std::memcpy(&value, data_, sizeof(T));
+    Skip(sizeof(T));
+  }
+
+  void Read(std::string& value) {
+    uint32_t length = 0;
+    Read(length);
+    Check(length);
+    value.assign(data_, length);
+    Skip(length);
+  }
+
+  template<typename T>
+  T Read() {
+    T value;
+    Read(value);
+    return value;
+  }
+
+  const char* GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+private:
+  void Check(size_t size) const {
+    if (size_ < size)
+      throw std::runtime_error("Unexpected end of binary data.");
+  }
+
+  void Skip(size_t size) {
+    data_ += size;
+    size_ -= size;
+  }
+
+  const char* data_;
+  size_t size_;
+};
+}
+
+#endif
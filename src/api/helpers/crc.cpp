@@ -28,6 +28,7 @@
 #include <boost/filesystem/fstream.hpp>
 #include <boost/format.hpp>
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
 
 #include "loot/exception/file_access_error.h"
 
@@ -49,9 +50,7 @@ size_t GetStreamSize(std::istream& stream) {
 uint32_t GetCrc32(const boost::filesystem::path& filename) {
   try {
     auto logger = getLogger();
-    if (logger) {
-      logger->trace("Calculating CRC for: {}", filename.string());
-    }
+    LOOT_LOG_TRACE(logger, "Calculating CRC for: {}", filename.string());
 
     boost::filesystem::ifstream ifile(filename, std::ios::binary);
     ifile.exceptions(std::ios_base::badbit | std::ios_base::failbit);
@@ -59,7 +58,8 @@ uint32_t GetCrc32(const boost::filesystem::path& filename) {
     static const size_t bufferSize = 8192;
     char buffer[bufferSize];
     boost::crc_32_type result;
-    size_t bytesLeft = GetStreamSize(ifile);
+    size_t fileSize = GetStreamSize(ifile);
+    size_t bytesLeft = fileSize;
     while (bytesLeft > 0) {
       if (bytesLeft > bufferSize)
         ifile.read(buffer, bufferSize);
@@ -70,10 +70,11 @@ uint32_t GetCrc32(const boost::filesystem::path& filename) {
       bytesLeft -= ifile.gcount();
     }
 
+    IncrementStatistic(Statistic::crcsComputed);
+    IncrementStatistic(Statistic::bytesRead, fileSize);
+
     uint32_t checksum = result.checksum();
-    if (logger) {
-      logger->debug("CRC32(\"{}\"): {:x}", filename.string(), checksum);
-    }
+    LOOT_LOG_DEBUG(logger, "CRC32(\"{}\"): {:x}", filename.string(), checksum);
     return checksum;
 
   } catch (std::exception& e) {
@@ -0,0 +1,283 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/executor.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "api/helpers/logging.h"
+#include "api/helpers/tracing.h"
+
+namespace loot {
+namespace {
+// The pool that the current thread belongs to, and the index of its queue.
+thread_local WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentQueue = 0;
+
+std::shared_ptr<ExecutorInterface> hostExecutor;
+
+// The number of executor tasks that parallel operations are currently using.
+std::mutex budgetMutex;
+unsigned int requestedConcurrency = 0;
+size_t tasksInUse = 0;
+
+size_t AcquireTasks(size_t wantedCount) {
+  size_t budget = getMaxConcurrency() - 1;
+
+  std::lock_guard<std::mutex> guard(budgetMutex);
+  size_t availableCount = tasksInUse < budget ? budget - tasksInUse : 0;
+  size_t acquiredCount = std::min(wantedCount, availableCount);
+  tasksInUse += acquiredCount;
+
+  return acquiredCount;
+}
+
+void ReleaseTasks(size_t count) {
+  std::lock_guard<std::mutex> guard(budgetMutex);
+  tasksInUse -= count;
+}
+
+// The state shared by the threads running a ParallelFor() call. Threads that
+// join after all indices have been taken return without calling the
+// function, as the caller may have returned.
+class ParallelLoop {
+public:
+  ParallelLoop(size_t count, const std::function<void(size_t)>& function) :
+      count_(count),
+      function_(function),
+      nextIndex_(0),
+      activeThreads_(0) {}
+
+  void Work() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (nextIndex_ >= count_)
+        return;
+      ++activeThreads_;
+    }
+
+    {
+      TraceScope scope("ParallelFor", "executor");
+      for (size_t i = nextIndex_++; i < count_; i = nextIndex_++) {
+        try {
+          function_(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(mutex_);
+          if (!error_)
+            error_ = std::current_exception();
+          nextIndex_ = count_;
+        }
+      }
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    --activeThreads_;
+    if (activeThreads_ == 0)
+      condition_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() {
+      return activeThreads_ == 0 && nextIndex_ >= count_;
+    });
+
+    if (error_)
+      std::rethrow_exception(error_);
+  }
+
+private:
+  const size_t count_;
+  const std::function<void(size_t)>& function_;
+  std::atomic<size_t> nextIndex_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  size_t activeThreads_;
+  std::exception_ptr error_;
+};
+}
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) :
+    nextQueue_(0),
+    pendingTasks_(0),
+    isStopping_(false) {
+  threadCount = std::max<size_t>(threadCount, 1);
+  for (size_t i = 0; i < threadCount; ++i) {
+    queues_.emplace_back(new TaskQueue());
+  }
+
+  for (size_t i = 0; i < threadCount; ++i) {
+    threads_.emplace_back(&WorkStealingPool::Run, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    isStopping_ = true;
+  }
+  condition_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::Execute(std::function<void()> task) {
+  size_t index = currentPool == this ? currentQueue
+                                     : nextQueue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> guard(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++pendingTasks_;
+  }
+  condition_.notify_one();
+}
+
+size_t WorkStealingPool::GetThreadCount() const { return threads_.size(); }
+
+void WorkStealingPool::Run(size_t index) {
+  currentPool = this;
+  currentQueue = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (PopTask(index, task)) {
+      try {
+        task();
+      } catch (std::exception& e) {
+        auto logger = getLogger();
+        if (logger) {
+          logger->error("An executor task threw an exception: {}", e.what());
+        }
+      }
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (isStopping_ && pendingTasks_ <= 0)
+      return;
+
+    condition_.wait(lock,
+                    [this]() { return isStopping_ || pendingTasks_ > 0; });
+  }
+}
+
+bool WorkStealingPool::PopTask(size_t index, std::function<void()>& task) {
+  bool isFound = false;
+  {
+    TaskQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      isFound = true;
+    }
+  }
+
+  for (size_t i = 1; !isFound && i < queues_.size(); ++i) {
+    TaskQueue& queue = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      isFound = true;
+    }
+  }
+
+  if (isFound) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    --pendingTasks_;
+  }
+
+  return isFound;
+}
+
+std::shared_ptr<ExecutorInterface> getExecutor() {
+  auto executor = std::atomic_load(&hostExecutor);
+  if (executor)
+    return executor;
+
+  static const auto defaultPool = std::make_shared<WorkStealingPool>(
+      std::max(1u, std::thread::hardware_concurrency()));
+
+  return defaultPool;
+}
+
+void setExecutor(std::shared_ptr<ExecutorInterface> executor) {
+  std::atomic_store(&hostExecutor, executor);
+}
+
+void setMaxConcurrency(unsigned int maxConcurrency) {
+  std::lock_guard<std::mutex> guard(budgetMutex);
+  requestedConcurrency = maxConcurrency;
+}
+
+unsigned int getMaxConcurrency() {
+  std::lock_guard<std::mutex> guard(budgetMutex);
+  if (requestedConcurrency == 0)
+    return std::max(1u, std::thread::hardware_concurrency());
+
+  return requestedConcurrency;
+}
+
+void ParallelFor(size_t count,
+                 const std::function<void(size_t)>& function,
+                 size_t maxThreads) {
+  if (count == 0)
+    return;
+
+  size_t wantedCount = count - 1;
+  if (maxThreads > 0)
+    wantedCount = std::min(wantedCount, maxThreads - 1);
+
+  auto loop = std::make_shared<ParallelLoop>(count, function);
+  size_t taskCount = AcquireTasks(wantedCount);
+  if (taskCount > 0) {
+    auto executor = getExecutor();
+    for (size_t i = 0; i < taskCount; ++i) {
+      try {
+        executor->Execute([loop]() {
+          loop->Work();
+          ReleaseTasks(1);
+        });
+      } catch (...) {
+        // The calling thread does the work of the tasks that weren't added.
+        ReleaseTasks(taskCount - i);
+        break;
+      }
+    }
+  }
+
+  loop->Work();
+  loop->Wait();
+}
+}
@@ -0,0 +1,106 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_EXECUTOR
+#define LOOT_API_HELPERS_EXECUTOR
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "loot/executor_interface.h"
+
+namespace loot {
+// The executor used when the host hasn't set its own. Each thread has its own
+// queue of tasks: tasks executed from one of the pool's threads are added to
+// that thread's queue, which it takes tasks from last in, first out, while
+// idle threads steal the oldest tasks from other threads' queues. Tasks that
+// are still queued when the pool is destroyed are run before its threads
+// exit.
+class WorkStealingPool : public ExecutorInterface {
+public:
+  explicit WorkStealingPool(size_t threadCount);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  void Execute(std::function<void()> task) override;
+
+  size_t GetThreadCount() const;
+
+private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Run(size_t index);
+  bool PopTask(size_t index, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> nextQueue_;
+
+  // Counts tasks that have been queued and not yet taken, so that idle
+  // threads can wait for new tasks.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  long pendingTasks_;
+  bool isStopping_;
+};
+
+// Returns the host's executor if one has been set, and otherwise a shared
+// WorkStealingPool with a thread for each hardware thread.
+std::shared_ptr<ExecutorInterface> getExecutor();
+
+// Passing nullptr restores the default pool.
+void setExecutor(std::shared_ptr<ExecutorInterface> executor);
+
+// The maximum number of threads that each parallel operation runs on,
+// counting the thread that calls it. All operations share one budget of
+// maxConcurrency - 1 executor tasks, so that operations running at the same
+// time don't run more than that many tasks between them. Zero sets the
+// number of hardware threads.
+void setMaxConcurrency(unsigned int maxConcurrency);
+unsigned int getMaxConcurrency();
+
+// Calls function for each index from zero to count - 1, and returns once all
+// the calls have returned. The calling thread takes indices in order along
+// with as many executor tasks as the concurrency budget allows, up to
+// maxThreads - 1 if maxThreads is not zero, so the loop finishes even if no
+// task is ever started. If any call throws, the remaining indices are
+// skipped and the first exception is rethrown.
+void ParallelFor(size_t count,
+                 const std::function<void(size_t)>& function,
+                 size_t maxThreads = 0);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/file_identity.h"
+
+namespace loot {
+FileIdentity::FileIdentity() : exists(false), size(0), modificationTime(0) {}
+
+FileIdentity FileIdentity::Get(const boost::filesystem::path& path) {
+  FileIdentity identity;
+  boost::system::error_code ec;
+
+  // Directories don't have a size, but their modification times change when
+  // their entries do.
+  if (boost::filesystem::is_directory(path, ec))
+    identity.size = 0;
+  else
+    identity.size = boost::filesystem::file_size(path, ec);
+
+  if (!ec) {
+    identity.exists = true;
+    identity.modificationTime = boost::filesystem::last_write_time(path, ec);
+  }
+  if (ec) {
+    identity = FileIdentity();
+  }
+
+  return identity;
+}
+
+FileIdentity FileIdentity::Read(BinaryReader& reader) {
+  FileIdentity identity;
+  reader.Read(identity.exists);
+  identity.size = static_cast<uintmax_t>(reader.Read<uint64_t>());
+  identity.modificationTime = static_cast<std::time_t>(reader.Read<int64_t>());
+
+  return identity;
+}
+
+void FileIdentity::Write(BinaryWriter& writer) const {
+  writer.Write(exists);
+  writer.Write(static_cast<uint64_t>(size));
+  writer.Write(static_cast<int64_t>(modificationTime));
+}
+
+bool FileIdentity::operator==(const FileIdentity& rhs) const {
+  return exists == rhs.exists && size == rhs.size &&
+         modificationTime == rhs.modificationTime;
+}
+
+bool FileIdentity::operator!=(const FileIdentity& rhs) const {
+  return !(*this == rhs);
+}
+}
@@ -0,0 +1,56 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_FILE_IDENTITY
+#define LOOT_API_HELPERS_FILE_IDENTITY
+
+#include <cstdint>
+#include <ctime>
+
+#include <boost/filesystem.hpp>
+
+#include "api/helpers/binary_stream.h"
+
+namespace loot {
+// A cheap way to tell whether a file has changed, using its size and
+// modification time.
+struct FileIdentity {
+  FileIdentity();
+
+  // Returns an identity that doesn't exist if the file can't be read.
+  static FileIdentity Get(const boost::filesystem::path& path);
+
+  static FileIdentity Read(BinaryReader& reader);
+  void Write(BinaryWriter& writer) const;
+
+  bool operator==(const FileIdentity& rhs) const;
+  bool operator!=(const FileIdentity& rhs) const;
+
+  bool exists;
+  uintmax_t size;
+  std::time_t modificationTime;
+};
+}
+
+#endif
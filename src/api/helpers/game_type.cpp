@@ -0,0 +1,46 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/game_type.h"
+
+#include <stdexcept>
+
+namespace loot {
+GameType ParseGameType(const std::string& game) {
+  if (game == "tes4")
+    return GameType::tes4;
+  else if (game == "tes5")
+    return GameType::tes5;
+  else if (game == "fo3")
+    return GameType::fo3;
+  else if (game == "fonv")
+    return GameType::fonv;
+  else if (game == "fo4")
+    return GameType::fo4;
+  else if (game == "tes5se")
+    return GameType::tes5se;
+
+  throw std::invalid_argument("Unknown game: " + game);
+}
+}
@@ -0,0 +1,38 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_GAME_TYPE
+#define LOOT_API_HELPERS_GAME_TYPE
+
+#include <string>
+
+#include "loot/enum/game_type.h"
+
+namespace loot {
+// Returns the game type that is written as the given name, which is the
+// name of a GameType value, such as "tes5se". Throws if the name is unknown.
+GameType ParseGameType(const std::string& game);
+}
+
+#endif
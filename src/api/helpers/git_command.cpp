@@ -0,0 +1,277 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/git_command.h"
+
+#ifdef _WIN32
+#ifndef UNICODE
+#define UNICODE
+#endif
+#ifndef _UNICODE
+#define _UNICODE
+#endif
+#include "api/helpers/windows_encoding_converters.h"
+#else
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace loot {
+namespace {
+// Splits output into lines at carriage returns as well as newlines, as the
+// Git client redraws its progress lines using carriage returns.
+class LineSplitter {
+public:
+  explicit LineSplitter(
+      const std::function<bool(const std::string&)>& onLine) :
+      onLine_(onLine) {}
+
+  // Returns false if the callback did.
+  bool Append(const char* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+      if (data[i] == '\r' || data[i] == '\n') {
+        if (!Flush())
+          return false;
+      } else
+        line_ += data[i];
+    }
+    return true;
+  }
+
+  bool Flush() {
+    if (line_.empty())
+      return true;
+
+    std::string line;
+    line.swap(line_);
+    return !onLine_ || onLine_(line);
+  }
+
+private:
+  const std::function<bool(const std::string&)>& onLine_;
+  std::string line_;
+};
+
+#ifdef _WIN32
+// Quotes an argument so that the MSVC runtime parses it back into the same
+// string.
+std::wstring QuoteArgument(const std::wstring& argument) {
+  if (!argument.empty() &&
+      argument.find_first_of(L" \t\n\v\"") == std::wstring::npos)
+    return argument;
+
+  std::wstring quoted = L"\"";
+  for (auto it = argument.begin();; ++it) {
+    size_t backslashes = 0;
+    while (it != argument.end() && *it == L'\\') {
+      ++it;
+      ++backslashes;
+    }
+
+    if (it == argument.end()) {
+      quoted.append(backslashes * 2, L'\\');
+      break;
+    } else if (*it == L'"')
+      quoted.append(backslashes * 2 + 1, L'\\');
+    else
+      quoted.append(backslashes, L'\\');
+
+    quoted.push_back(*it);
+  }
+  quoted.push_back(L'"');
+
+  return quoted;
+}
+#endif
+}
+
+#ifdef _WIN32
+int RunGitCommand(const std::vector<std::string>& arguments,
+                  const std::function<bool(const std::string&)>& onOutput) {
+  SECURITY_ATTRIBUTES attributes = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+  HANDLE readPipe;
+  HANDLE writePipe;
+  if (!CreatePipe(&readPipe, &writePipe, &attributes, 0))
+    return -1;
+  SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+
+  std::wstring commandLine = L"git";
+  for (const auto& argument : arguments) {
+    commandLine += L" " + QuoteArgument(ToWinWide(argument));
+  }
+
+  STARTUPINFO startupInfo = {0};
+  startupInfo.cb = sizeof(startupInfo);
+  startupInfo.dwFlags = STARTF_USESTDHANDLES;
+  startupInfo.hStdOutput = writePipe;
+  startupInfo.hStdError = writePipe;
+
+  PROCESS_INFORMATION processInfo;
+  BOOL created = CreateProcess(NULL,
+                               &commandLine[0],
+                               NULL,
+                               NULL,
+                               TRUE,
+                               CREATE_NO_WINDOW,
+                               NULL,
+                               NULL,
+                               &startupInfo,
+                               &processInfo);
+  CloseHandle(writePipe);
+  if (!created) {
+    CloseHandle(readPipe);
+    return -1;
+  }
+  CloseHandle(processInfo.hThread);
+
+  LineSplitter splitter(onOutput);
+  bool killed = false;
+  char buffer[4096];
+  DWORD count;
+  while (ReadFile(readPipe, buffer, sizeof(buffer), &count, NULL) &&
+         count > 0) {
+    if (!splitter.Append(buffer, count)) {
+      TerminateProcess(processInfo.hProcess, 1);
+      killed = true;
+      break;
+    }
+  }
+  if (!killed)
+    killed = !splitter.Flush();
+  CloseHandle(readPipe);
+
+  WaitForSingleObject(processInfo.hProcess, INFINITE);
+  DWORD exitCode;
+  GetExitCodeProcess(processInfo.hProcess, &exitCode);
+  CloseHandle(processInfo.hProcess);
+
+  return killed ? -1 : static_cast<int>(exitCode);
+}
+#else
+int RunGitCommand(const std::vector<std::string>& arguments,
+                  const std::function<bool(const std::string&)>& onOutput) {
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0)
+    return -1;
+
+  // Stop other processes that this one starts from inheriting the pipe. The
+  // copies that the client gets aren't affected.
+  fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(
+      &actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+
+  // Run the client in its own process group so that the processes it starts
+  // can be killed with it.
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+  posix_spawnattr_setpgroup(&attributes, 0);
+
+  std::vector<std::string> argStrings(1, "git");
+  argStrings.insert(argStrings.end(), arguments.begin(), arguments.end());
+  std::vector<char*> argv;
+  for (auto& argument : argStrings) {
+    argv.push_back(&argument[0]);
+  }
+  argv.push_back(nullptr);
+
+  // Fail instead of waiting for credentials that will never be entered, and
+  // don't translate the output, as its progress lines are parsed.
+  std::vector<std::string> envStrings = {"GIT_TERMINAL_PROMPT=0", "LC_ALL=C"};
+  for (char** variable = environ; *variable != nullptr; ++variable) {
+    if (std::strncmp(*variable, "GIT_TERMINAL_PROMPT=", 20) != 0 &&
+        std::strncmp(*variable, "LC_ALL=", 7) != 0)
+      envStrings.push_back(*variable);
+  }
+  std::vector<char*> envp;
+  for (auto& variable : envStrings) {
+    envp.push_back(&variable[0]);
+  }
+  envp.push_back(nullptr);
+
+  pid_t pid;
+  int error = posix_spawnp(
+      &pid, "git", &actions, &attributes, argv.data(), envp.data());
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attributes);
+  close(pipeFds[1]);
+  if (error != 0) {
+    close(pipeFds[0]);
+    return -1;
+  }
+
+  LineSplitter splitter(onOutput);
+  bool killed = false;
+  char buffer[4096];
+  while (true) {
+    ssize_t count = read(pipeFds[0], buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR)
+      continue;
+    else if (count <= 0)
+      break;
+
+    if (!splitter.Append(buffer, count)) {
+      kill(-pid, SIGTERM);
+      killed = true;
+      break;
+    }
+  }
+  if (!killed)
+    killed = !splitter.Flush();
+  close(pipeFds[0]);
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR)
+      return -1;
+  }
+
+  if (killed || !WIFEXITED(status))
+    return -1;
+
+  return WEXITSTATUS(status);
+}
+#endif
+
+bool IsGitCommandAvailable() {
+  static const bool isAvailable =
+      RunGitCommand({"--version"}, nullptr) == 0;
+
+  return isAvailable;
+}
+}
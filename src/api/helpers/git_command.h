@@ -0,0 +1,45 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_GIT_COMMAND
+#define LOOT_API_HELPERS_GIT_COMMAND
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace loot {
+// Runs the Git command line client with the given arguments and waits for it
+// to exit. Each line that it writes to stdout or stderr is passed to the
+// callback, and the client is killed if the callback returns false. Returns
+// the client's exit code, or -1 if it couldn't be run or was killed.
+int RunGitCommand(const std::vector<std::string>& arguments,
+                  const std::function<bool(const std::string&)>& onOutput);
+
+// Returns true if the Git command line client can be run. libgit2 can't make
+// or update shallow clones, so they're handled using the client.
+bool IsGitCommandAvailable();
+}
+
+#endif
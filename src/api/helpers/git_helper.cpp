@@ -24,10 +24,17 @@
 
 #include "api/helpers/git_helper.h"
 
+#include <regex>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
 #include <boost/format.hpp>
 
+#include "api/helpers/git_command.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/tracing.h"
 #include "loot/exception/error_categories.h"
+#include "loot/exception/file_access_error.h"
 #include "loot/exception/git_state_error.h"
 
 using std::string;
@@ -35,6 +42,46 @@ using std::string;
 namespace fs = boost::filesystem;
 
 namespace loot {
+namespace {
+// Parses a line of transfer progress written by the Git command line client,
+// e.g. "Receiving objects:  50% (5/10), 1.00 KiB | 1.00 MiB/s". Returns false
+// if the line isn't one.
+bool ParseTransferProgress(const std::string& line,
+                           TransferProgress& progress) {
+  static const std::regex regex(
+      R"(^(Receiving objects|Resolving deltas): +\d+% \((\d+)/(\d+)\))"
+      R"((, ([\d.]+) (bytes|KiB|MiB|GiB))?)");
+
+  std::smatch match;
+  if (!std::regex_search(line, match, regex))
+    return false;
+
+  size_t count = std::stoul(match.str(2));
+  size_t total = std::stoul(match.str(3));
+  if (match.str(1) == "Resolving deltas") {
+    progress.indexed_deltas = count;
+    progress.total_deltas = total;
+    return true;
+  }
+
+  // The client indexes objects as it receives them.
+  progress.received_objects = count;
+  progress.indexed_objects = count;
+  progress.total_objects = total;
+
+  if (match[4].matched) {
+    static const std::vector<std::string> units = {"bytes", "KiB", "MiB"};
+    double bytes = std::stod(match.str(5));
+    for (size_t i = 0; i < units.size() && units[i] != match.str(6); ++i) {
+      bytes *= 1024;
+    }
+    progress.received_bytes = static_cast<size_t>(bytes);
+  }
+
+  return true;
+}
+}
+
 GitHelper::GitHelper() : logger_(getLogger()) {}
 
 GitHelper::~GitHelper() {
@@ -61,7 +108,10 @@ GitHelper::GitData::GitData() :
     blob(nullptr),
     annotated_commit(nullptr),
     tree(nullptr),
+    tree_entry(nullptr),
     diff(nullptr),
+    odb(nullptr),
+    writepack(nullptr),
     buffer({0}) {
   // Init threading system and OpenSSL (for Linux builds).
   git_libgit2_init();
@@ -85,7 +135,11 @@ GitHelper::GitData::~GitData() {
   git_blob_free(blob);
   git_annotated_commit_free(annotated_commit);
   git_tree_free(tree);
+  git_tree_entry_free(tree_entry);
   git_diff_free(diff);
+  if (writepack != nullptr)
+    writepack->free(writepack);
+  git_odb_free(odb);
   git_buf_free(&buffer);
 
   // Also free any path strings in the checkout options.
@@ -114,6 +168,115 @@ void GitHelper::Call(int error_code) {
   throw std::system_error(error_code, libgit2_category(), message);
 }
 
+void GitHelper::SetTransferProgressCallback(
+    const TransferProgressCallback& callback) {
+  progressCallback_ = callback;
+}
+
+int GitHelper::OnTransferProgress(const git_transfer_progress* stats,
+                                  void* payload) {
+  GitHelper* git = static_cast<GitHelper*>(payload);
+
+  TransferProgress progress;
+  progress.total_objects = stats->total_objects;
+  progress.indexed_objects = stats->indexed_objects;
+  progress.received_objects = stats->received_objects;
+  progress.local_objects = stats->local_objects;
+  progress.total_deltas = stats->total_deltas;
+  progress.indexed_deltas = stats->indexed_deltas;
+  progress.received_bytes = stats->received_bytes;
+
+  // Exceptions can't be allowed to propagate through libgit2, so store them
+  // and cancel the transfer instead.
+  try {
+    if (git->progressCallback_(progress))
+      return 0;
+  } catch (...) {
+    git->progressException_ = std::current_exception();
+  }
+
+  if (git->logger_) {
+    git->logger_->info("Transfer cancelled by progress callback.");
+  }
+  return GIT_EUSER;
+}
+
+void GitHelper::SetRemoteCallbacks(git_remote_callbacks& callbacks) {
+  if (!progressCallback_)
+    return;
+
+  callbacks.transfer_progress = &GitHelper::OnTransferProgress;
+  callbacks.payload = this;
+}
+
+void GitHelper::CallWithProgress(int error_code) {
+  if (progressException_) {
+    std::exception_ptr exception = progressException_;
+    progressException_ = nullptr;
+    giterr_clear();
+    std::rethrow_exception(exception);
+  }
+
+  Call(error_code);
+}
+
+void GitHelper::RunGit(const std::vector<std::string>& arguments) {
+  std::vector<std::string> commandArguments;
+  if (data_.repo != nullptr) {
+    commandArguments.push_back("--git-dir");
+    commandArguments.push_back(git_repository_path(data_.repo));
+  }
+
+  // Don't let the client repack objects that libgit2 may have open.
+  commandArguments.push_back("-c");
+  commandArguments.push_back("gc.auto=0");
+
+  // Progress is only written if asked for, as the output isn't a terminal.
+  commandArguments.push_back(arguments.at(0));
+  commandArguments.push_back(progressCallback_ ? "--progress" : "--quiet");
+  commandArguments.insert(
+      commandArguments.end(), arguments.begin() + 1, arguments.end());
+
+  LOOT_LOG_TRACE(logger_, "Running the Git client's {} command.", arguments[0]);
+
+  TransferProgress progress;
+  std::string lastMessage;
+  bool cancelled = false;
+  int exitCode =
+      RunGitCommand(commandArguments, [&](const std::string& line) {
+        if (!ParseTransferProgress(line, progress)) {
+          lastMessage = line;
+          return true;
+        }
+
+        if (!progressCallback_)
+          return true;
+
+        try {
+          if (progressCallback_(progress))
+            return true;
+        } catch (...) {
+          progressException_ = std::current_exception();
+        }
+
+        if (logger_) {
+          logger_->info("Transfer cancelled by progress callback.");
+        }
+        cancelled = true;
+        return false;
+      });
+
+  if (cancelled)
+    CallWithProgress(GIT_EUSER);
+  else if (exitCode != 0) {
+    if (lastMessage.empty())
+      lastMessage = "The Git command line client could not be run.";
+
+    giterr_set_str(GITERR_NET, lastMessage.c_str());
+    Call(GIT_ERROR);
+  }
+}
+
 bool GitHelper::IsRepository(const boost::filesystem::path& path) {
   return git_repository_open_ext(NULL,
                                  path.string().c_str(),
@@ -124,45 +287,42 @@ bool GitHelper::IsRepository(const boost::filesystem::path& path) {
 // Removes the read-only flag from some files in git repositories created by
 // libgit2.
 void GitHelper::FixRepoPermissions(const boost::filesystem::path& path) {
-  if (logger_) {
-    logger_->trace("Recursively setting write permission on directory: {}",
-                   path.string());
-  }
+  LOOT_LOG_TRACE(logger_,
+                 "Recursively setting write permission on directory: {}",
+                 path.string());
   for (fs::recursive_directory_iterator it(path);
        it != fs::recursive_directory_iterator();
        ++it) {
     if ((it->status().permissions() &
          (fs::owner_write | fs::group_write | fs::others_write)) == 0) {
-      if (logger_) {
-        logger_->trace("Setting write permission for: {}", it->path().string());
-      }
+      LOOT_LOG_TRACE(
+          logger_, "Setting write permission for: {}", it->path().string());
       fs::permissions(it->path(), fs::add_perms | fs::owner_write);
     }
   }
 }
 
-int GitHelper::DiffFileCallback(const git_diff_delta* delta,
-                                float progress,
-                                void* payload) {
-  auto logger = getLogger();
-  if (logger) {
-    logger->trace("Checking diff for: {}", delta->old_file.path);
-  }
-
-  DiffPayload* gdp = (DiffPayload*)payload;
-  if (strcmp(delta->old_file.path, gdp->fileToFind) == 0) {
-    if (logger) {
-      logger->warn("Edited masterlist found.");
-    }
-    gdp->fileFound = true;
-  }
+std::string GitHelper::GetBranchRefspec(const std::string& remote,
+                                        const std::string& branch) {
+  return "+refs/heads/" + branch + ":refs/remotes/" + remote + "/" + branch;
+}
 
-  return 0;
+int GitHelper::CreateSingleBranchRemote(git_remote** out,
+                                        git_repository* repo,
+                                        const char* name,
+                                        const char* url,
+                                        void* payload) {
+  const char* branch = static_cast<const char*>(payload);
+  return git_remote_create_with_fetchspec(
+      out, repo, name, url, GetBranchRefspec(name, branch).c_str());
 }
 
 // Clones a repository and opens it.
 void GitHelper::Clone(const boost::filesystem::path& path,
-                      const std::string& url) {
+                      const std::string& url,
+                      unsigned int depth) {
+  TraceScope scope("Clone", "git", url);
+
   if (data_.repo != nullptr)
     throw GitStateError(
         "Cannot clone repository that has already been opened.");
@@ -181,9 +341,7 @@ void GitHelper::Clone(const boost::filesystem::path& path,
     // Directory is non-empty. Delete the masterlist file and
     // .git folder, then move any remaining files to a temporary
     // folder while the repo is cloned, before moving them back.
-    if (logger_) {
-      logger_->trace("Repo path not empty, renaming folder.");
-    }
+    LOOT_LOG_TRACE(logger_, "Repo path not empty, renaming folder.");
 
     // Clear any read-only flags first.
     FixRepoPermissions(path);
@@ -197,15 +355,45 @@ void GitHelper::Clone(const boost::filesystem::path& path,
     fs::create_directory(path);
   }
 
-  // Perform the clone.
-  Call(git_clone(
-      &data_.repo, url.c_str(), path.string().c_str(), &data_.clone_options));
+  // Perform the clone. LOOT only reads the history of one branch, so don't
+  // transfer any other branches or tags.
+  const char* branch = data_.clone_options.checkout_branch;
+  if (branch != nullptr && depth > 0 && IsGitCommandAvailable()) {
+    // libgit2 can't make shallow clones, so use the Git client, then check
+    // out the paths given by the clone options.
+    LOOT_LOG_TRACE(logger_, "Making a shallow clone with depth {}.", depth);
+    RunGit({"clone",
+            "--depth",
+            std::to_string(depth),
+            "--single-branch",
+            "--no-tags",
+            "--no-checkout",
+            "--branch",
+            branch,
+            "--",
+            url,
+            path.string()});
+
+    Call(git_repository_open(&data_.repo, path.string().c_str()));
+    Call(git_checkout_head(data_.repo, &data_.clone_options.checkout_opts));
+  } else {
+    if (branch != nullptr) {
+      data_.clone_options.remote_cb = &GitHelper::CreateSingleBranchRemote;
+      data_.clone_options.remote_cb_payload = const_cast<char*>(branch);
+    }
+    data_.clone_options.fetch_opts.download_tags =
+        GIT_REMOTE_DOWNLOAD_TAGS_NONE;
+    SetRemoteCallbacks(data_.clone_options.fetch_opts.callbacks);
+    CallWithProgress(git_clone(&data_.repo,
+                               url.c_str(),
+                               path.string().c_str(),
+                               &data_.clone_options));
+  }
 
   if (fs::exists(tempPath)) {
     // Move contents back in.
-    if (logger_) {
-      logger_->trace("Repo path wasn't empty, moving previous files back in.");
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Repo path wasn't empty, moving previous files back in.");
     for (fs::directory_iterator it(tempPath); it != fs::directory_iterator();
          ++it) {
       if (!fs::exists(path / it->path().filename())) {
@@ -218,37 +406,287 @@ void GitHelper::Clone(const boost::filesystem::path& path,
   }
 }
 
-void GitHelper::Fetch(const std::string& remote) {
+void GitHelper::Fetch(const std::string& remote, const std::string& branch) {
+  TraceScope scope("Fetch", "git", branch);
+
   if (data_.repo == nullptr)
     throw GitStateError(
         "Cannot fetch updates for repository that has not been opened.");
 
-  if (logger_) {
-    logger_->trace("Fetching updates from remote.");
-  }
+  LOOT_LOG_TRACE(logger_, "Fetching updates from remote.");
 
   // Get the origin remote.
   Call(git_remote_lookup(&data_.remote, data_.repo, remote.c_str()));
 
-  // Now fetch any updates.
+  // Repositories cloned with only one branch have a refspec for just that
+  // branch, so add one for the given branch if it isn't covered. Otherwise
+  // its remote-tracking branch can't be used as an upstream.
+  const string branchRef = "refs/heads/" + branch;
+  bool hasRefspec = false;
+  for (size_t i = 0; i < git_remote_refspec_count(data_.remote); ++i) {
+    const git_refspec* refspec = git_remote_get_refspec(data_.remote, i);
+    if (git_refspec_direction(refspec) == GIT_DIRECTION_FETCH &&
+        git_refspec_src_matches(refspec, branchRef.c_str())) {
+      hasRefspec = true;
+      break;
+    }
+  }
+
+  string refspec = GetBranchRefspec(remote, branch);
+  if (!hasRefspec) {
+    LOOT_LOG_TRACE(logger_, "Adding fetch refspec: {}", refspec);
+    Call(git_remote_add_fetch(data_.repo, remote.c_str(), refspec.c_str()));
+  }
+
+  // libgit2 can't fetch into shallow clones, so use the Git client.
+  if (git_repository_is_shallow(data_.repo) == 1) {
+    git_remote_free(data_.remote);
+    data_.remote = nullptr;
+
+    if (!IsGitCommandAvailable())
+      throw GitStateError(
+          "Cannot fetch updates for a shallow clone without the Git command "
+          "line client.");
+
+    RunGit({"fetch", "--no-tags", "--", remote, refspec});
+    return;
+  }
+
+  // Now fetch any updates, for only the given branch.
+  char* refspecs[] = {&refspec[0]};
+  git_strarray refspecArray = {refspecs, 1};
   git_fetch_options fetch_options = GIT_FETCH_OPTIONS_INIT;
-  Call(git_remote_fetch(data_.remote, nullptr, &fetch_options, nullptr));
+  fetch_options.download_tags = GIT_REMOTE_DOWNLOAD_TAGS_NONE;
+  SetRemoteCallbacks(fetch_options.callbacks);
+  CallWithProgress(
+      git_remote_fetch(data_.remote, &refspecArray, &fetch_options, nullptr));
 
   // Log some stats on what was fetched either during update or clone.
   const git_transfer_progress* stats = git_remote_stats(data_.remote);
+  LOOT_LOG_TRACE(logger_,
+                 "Received {} of {} objects in {} bytes.",
+                 stats->indexed_objects,
+                 stats->total_objects,
+                 stats->received_bytes);
+
+  git_remote_free(data_.remote);
+  data_.remote = nullptr;
+}
+
+bool GitHelper::Deepen(const std::string& remote,
+                       const std::string& branch,
+                       unsigned int depth) {
+  TraceScope scope("Deepen", "git", branch);
+
+  if (data_.repo == nullptr)
+    throw GitStateError("Cannot deepen repository that has not been opened.");
+
+  if (git_repository_is_shallow(data_.repo) != 1 || !IsGitCommandAvailable())
+    return false;
+
+  LOOT_LOG_TRACE(logger_, "Fetching {} older commits from remote.", depth);
+  RunGit({"fetch",
+          "--no-tags",
+          "--deepen",
+          std::to_string(depth),
+          "--",
+          remote,
+          GetBranchRefspec(remote, branch)});
+
+  return true;
+}
+
+void GitHelper::Init(const boost::filesystem::path& path,
+                     const std::string& remote,
+                     const std::string& url) {
+  if (data_.repo != nullptr)
+    throw GitStateError(
+        "Cannot initialise repository that has already been opened.");
+  else if (data_.remote != nullptr)
+    throw GitStateError(
+        "Cannot initialise repository, remote memory already allocated.");
+
   if (logger_) {
-    logger_->trace("Received {} of {} objects in {} bytes.",
-                   stats->indexed_objects,
-                   stats->total_objects,
-                   stats->received_bytes);
+    logger_->info("Repository doesn't exist, initialising a new repository.");
+  }
+
+  Call(git_repository_init(&data_.repo, path.string().c_str(), 0));
+  Call(git_remote_create(
+      &data_.remote, data_.repo, remote.c_str(), url.c_str()));
+
+  git_remote_free(data_.remote);
+  data_.remote = nullptr;
+}
+
+void GitHelper::ApplyBundle(const boost::filesystem::path& bundlePath,
+                            const std::string& remote,
+                            const std::string& branch) {
+  TraceScope scope("ApplyBundle", "git", bundlePath.string());
+
+  if (data_.repo == nullptr)
+    throw GitStateError(
+        "Cannot apply bundle to repository that has not been opened.");
+  else if (data_.odb != nullptr)
+    throw GitStateError(
+        "Cannot apply bundle, object database memory already allocated.");
+  else if (data_.writepack != nullptr)
+    throw GitStateError(
+        "Cannot apply bundle, pack writer memory already allocated.");
+  else if (data_.reference != nullptr)
+    throw GitStateError(
+        "Cannot apply bundle, reference memory already allocated.");
+
+  LOOT_LOG_TRACE(logger_, "Reading Git bundle at: {}", bundlePath.string());
+
+  fs::ifstream in(bundlePath, std::ios::binary);
+  if (!in.is_open())
+    throw FileAccessError("Could not open the bundle at: " +
+                          bundlePath.string());
+
+  // The bundle header is a signature line, then (for v3 bundles) capability
+  // lines starting with "@", then prerequisite commits prefixed by "-" and
+  // refs as "<id> <name>" lines, then a blank line followed by a packfile.
+  string line;
+  std::getline(in, line);
+  if (line.compare(0, 4, "PACK") == 0)
+    throw GitStateError(
+        "Packfiles do not record any refs, so cannot be applied. Use a Git "
+        "bundle instead.");
+  else if (line != "# v2 git bundle" && line != "# v3 git bundle")
+    throw GitStateError("\"" + bundlePath.string() +
+                        "\" is not a supported Git bundle.");
+
+  const string refName = "refs/heads/" + branch;
+  git_oid branchOid;
+  bool foundBranch = false;
+
+  Call(git_repository_odb(&data_.odb, data_.repo));
+
+  while (std::getline(in, line) && !line.empty()) {
+    if (line[0] == '@') {
+      if (line != "@object-format=sha1" && line.compare(0, 8, "@filter=") != 0)
+        throw GitStateError("Unsupported Git bundle capability: " +
+                            line.substr(1));
+      continue;
+    }
+
+    bool isPrerequisite = line[0] == '-';
+    string id = line.substr(isPrerequisite ? 1 : 0, GIT_OID_HEXSZ);
+
+    git_oid oid;
+    Call(git_oid_fromstrn(&oid, id.c_str(), id.length()));
+
+    if (isPrerequisite) {
+      if (!git_odb_exists(data_.odb, &oid))
+        throw GitStateError("The bundle requires commit " + id +
+                            ", which the repository does not have.");
+    } else if (line.length() > GIT_OID_HEXSZ + 1 &&
+               line.substr(GIT_OID_HEXSZ + 1) == refName) {
+      git_oid_cpy(&branchOid, &oid);
+      foundBranch = true;
+    }
+  }
+
+  if (!foundBranch)
+    throw GitStateError("The bundle does not contain the branch \"" + branch +
+                        "\".");
+
+  // Index the packfile into the object database. Objects the repository
+  // already has that the pack's deltas are based on are resolved from the
+  // object database, so incremental (thin) bundles can be applied.
+  LOOT_LOG_TRACE(logger_,
+                 "Writing the bundle's packfile to the object database.");
+  Call(git_odb_write_pack(&data_.writepack,
+                          data_.odb,
+                          progressCallback_ ? &GitHelper::OnTransferProgress
+                                            : nullptr,
+                          this));
+
+  git_transfer_progress stats = {0};
+  std::vector<char> chunk(64 * 1024);
+  while (in) {
+    in.read(chunk.data(), chunk.size());
+    if (in.gcount() > 0) {
+      CallWithProgress(data_.writepack->append(
+          data_.writepack, chunk.data(), in.gcount(), &stats));
+    }
+  }
+  CallWithProgress(data_.writepack->commit(data_.writepack, &stats));
+
+  LOOT_LOG_TRACE(logger_,
+                 "Indexed {} of {} objects in {} bytes.",
+                 stats.indexed_objects,
+                 stats.total_objects,
+                 stats.received_bytes);
+
+  data_.writepack->free(data_.writepack);
+  data_.writepack = nullptr;
+  git_odb_free(data_.odb);
+  data_.odb = nullptr;
+
+  // Update the remote-tracking branch as a fetch would.
+  Call(git_reference_create(&data_.reference,
+                            data_.repo,
+                            ("refs/remotes/" + remote + "/" + branch).c_str(),
+                            &branchOid,
+                            1,
+                            "Applied bundle."));
+
+  git_reference_free(data_.reference);
+  data_.reference = nullptr;
+}
+
+git_oid GitHelper::GetRemoteBranchId(const std::string& remote,
+                                     const std::string& branch) {
+  TraceScope scope("GetRemoteBranchId", "git", branch);
+
+  if (data_.repo == nullptr)
+    throw GitStateError(
+        "Cannot list remote refs for repository that has not been opened.");
+  else if (data_.remote != nullptr)
+    throw GitStateError(
+        "Cannot list remote refs, remote memory already allocated.");
+
+  LOOT_LOG_TRACE(logger_, "Listing refs of remote \"{}\".", remote);
+
+  Call(git_remote_lookup(&data_.remote, data_.repo, remote.c_str()));
+
+  git_remote_callbacks callbacks = GIT_REMOTE_CALLBACKS_INIT;
+  Call(git_remote_connect(
+      data_.remote, GIT_DIRECTION_FETCH, &callbacks, nullptr, nullptr));
+
+  const git_remote_head** heads = nullptr;
+  size_t headsCount = 0;
+  Call(git_remote_ls(&heads, &headsCount, data_.remote));
+
+  // The heads are owned by the remote, so copy out the matching ID before
+  // freeing it.
+  const string refName = "refs/heads/" + branch;
+  git_oid branchOid;
+  bool found = false;
+  for (size_t i = 0; i < headsCount; ++i) {
+    if (refName == heads[i]->name) {
+      git_oid_cpy(&branchOid, &heads[i]->oid);
+      found = true;
+      break;
+    }
   }
 
+  git_remote_disconnect(data_.remote);
   git_remote_free(data_.remote);
   data_.remote = nullptr;
+
+  if (!found)
+    throw GitStateError("The remote \"" + remote +
+                        "\" has no branch named \"" + branch + "\".");
+
+  return branchOid;
 }
 
 void GitHelper::CheckoutNewBranch(const std::string& remote,
                                   const std::string& branch) {
+  TraceScope scope("CheckoutNewBranch", "git", branch);
+
   if (data_.repo == nullptr)
     throw GitStateError(
         "Cannot fetch updates for repository that has not been opened.");
@@ -262,39 +700,30 @@ void GitHelper::CheckoutNewBranch(const std::string& remote,
     throw GitStateError(
         "Cannot fetch repository updates, reference memory already allocated.");
 
-  if (logger_) {
-    logger_->trace("Looking up commit referred to by the remote branch \"{}\".",
-                   branch);
-  }
+  LOOT_LOG_TRACE(logger_,
+                 "Looking up commit referred to by the remote branch \"{}\".",
+                 branch);
   Call(git_revparse_single(
       &data_.object, data_.repo, (remote + "/" + branch).c_str()));
   const git_oid* commit_id = git_object_id(data_.object);
 
-  if (logger_) {
-    logger_->trace("Creating the new branch.");
-  }
+  LOOT_LOG_TRACE(logger_, "Creating the new branch.");
   Call(git_commit_lookup(&data_.commit, data_.repo, commit_id));
   Call(git_branch_create(
       &data_.reference, data_.repo, branch.c_str(), data_.commit, 1));
 
-  if (logger_) {
-    logger_->trace("Setting the upstream for the new branch.");
-  }
+  LOOT_LOG_TRACE(logger_, "Setting the upstream for the new branch.");
   Call(git_branch_set_upstream(data_.reference,
                                (remote + "/" + branch).c_str()));
 
   // Check if HEAD points to the desired branch and set it to if not.
   if (!git_branch_is_head(data_.reference)) {
-    if (logger_) {
-      logger_->trace("Setting HEAD to follow branch: {}", branch);
-    }
+    LOOT_LOG_TRACE(logger_, "Setting HEAD to follow branch: {}", branch);
     Call(git_repository_set_head(data_.repo,
                                  (string("refs/heads/") + branch).c_str()));
   }
 
-  if (logger_) {
-    logger_->trace("Performing a Git checkout of HEAD.");
-  }
+  LOOT_LOG_TRACE(logger_, "Performing a Git checkout of HEAD.");
   Call(git_checkout_head(data_.repo, &data_.checkout_options));
 
   // Free tree and commit pointers. Reference pointer is still used below.
@@ -307,6 +736,8 @@ void GitHelper::CheckoutNewBranch(const std::string& remote,
 }
 
 void GitHelper::CheckoutRevision(const std::string& revision) {
+  TraceScope scope("CheckoutRevision", "git", revision);
+
   if (data_.repo == nullptr)
     throw GitStateError(
         "Cannot checkout revision for repository that has not been opened.");
@@ -323,9 +754,7 @@ void GitHelper::CheckoutRevision(const std::string& revision) {
   Call(git_repository_set_head_detached(data_.repo, oid));
 
   // Checkout the new HEAD.
-  if (logger_) {
-    logger_->trace("Performing a Git checkout of HEAD.");
-  }
+  LOOT_LOG_TRACE(logger_, "Performing a Git checkout of HEAD.");
   Call(git_checkout_head(data_.repo, &data_.checkout_options));
 
   git_object_free(data_.object);
@@ -346,15 +775,11 @@ std::string GitHelper::GetHeadShortId() {
     throw GitStateError(
         "Cannot fetch repository updates, buffer memory already allocated.");
 
-  if (logger_) {
-    logger_->trace("Getting the Git object for HEAD.");
-  }
+  LOOT_LOG_TRACE(logger_, "Getting the Git object for HEAD.");
   Call(git_repository_head(&data_.reference, data_.repo));
   Call(git_reference_peel(&data_.object, data_.reference, GIT_OBJ_COMMIT));
 
-  if (logger_) {
-    logger_->trace("Generating hex string for Git object ID.");
-  }
+  LOOT_LOG_TRACE(logger_, "Generating hex string for Git object ID.");
   Call(git_object_short_id(&data_.buffer, data_.object));
   string revision = data_.buffer.ptr;
 
@@ -368,6 +793,91 @@ std::string GitHelper::GetHeadShortId() {
   return revision;
 }
 
+bool GitHelper::GetFirstParentId(const git_oid& commitId, git_oid& parentId) {
+  if (data_.repo == nullptr)
+    throw GitStateError(
+        "Cannot get commit parent for repository that has not been opened.");
+  else if (data_.commit != nullptr)
+    throw GitStateError(
+        "Cannot get commit parent, commit memory already allocated.");
+
+  Call(git_commit_lookup(&data_.commit, data_.repo, &commitId));
+
+  const git_oid* firstParentId = git_commit_parent_id(data_.commit, 0);
+  if (firstParentId != nullptr)
+    git_oid_cpy(&parentId, firstParentId);
+
+  git_commit_free(data_.commit);
+  data_.commit = nullptr;
+
+  return firstParentId != nullptr;
+}
+
+bool GitHelper::HasCommit(const git_oid& commitId) {
+  if (data_.repo == nullptr)
+    throw GitStateError(
+        "Cannot look up commit in repository that has not been opened.");
+  else if (data_.odb != nullptr)
+    throw GitStateError(
+        "Cannot look up commit, object database memory already allocated.");
+
+  Call(git_repository_odb(&data_.odb, data_.repo));
+  bool hasCommit = git_odb_exists(data_.odb, &commitId) != 0;
+
+  git_odb_free(data_.odb);
+  data_.odb = nullptr;
+
+  return hasCommit;
+}
+
+std::string GitHelper::GetFileContent(const git_oid& commitId,
+                                      const std::string& filename) {
+  if (data_.repo == nullptr)
+    throw GitStateError(
+        "Cannot read file for repository that has not been opened.");
+  else if (data_.commit != nullptr)
+    throw GitStateError("Cannot read file, commit memory already allocated.");
+  else if (data_.tree != nullptr)
+    throw GitStateError("Cannot read file, tree memory already allocated.");
+  else if (data_.tree_entry != nullptr)
+    throw GitStateError(
+        "Cannot read file, tree entry memory already allocated.");
+  else if (data_.blob != nullptr)
+    throw GitStateError("Cannot read file, blob memory already allocated.");
+
+  LOOT_LOG_TRACE(logger_, "Reading \"{}\" from the object database.", filename);
+
+  // Free everything before handling errors, as a missing file is expected
+  // for some revisions and shouldn't stop this from being called again.
+  int ret = git_commit_lookup(&data_.commit, data_.repo, &commitId);
+  if (ret == 0)
+    ret = git_commit_tree(&data_.tree, data_.commit);
+  if (ret == 0)
+    ret = git_tree_entry_bypath(
+        &data_.tree_entry, data_.tree, filename.c_str());
+  if (ret == 0)
+    ret = git_blob_lookup(
+        &data_.blob, data_.repo, git_tree_entry_id(data_.tree_entry));
+
+  string content;
+  if (ret == 0)
+    content.assign(static_cast<const char*>(git_blob_rawcontent(data_.blob)),
+                   static_cast<size_t>(git_blob_rawsize(data_.blob)));
+
+  git_blob_free(data_.blob);
+  git_tree_entry_free(data_.tree_entry);
+  git_tree_free(data_.tree);
+  git_commit_free(data_.commit);
+  data_.blob = nullptr;
+  data_.tree_entry = nullptr;
+  data_.tree = nullptr;
+  data_.commit = nullptr;
+
+  Call(ret);
+
+  return content;
+}
+
 GitHelper::GitData& GitHelper::GetData() { return data_; }
 
 bool GitHelper::IsFileDifferent(const boost::filesystem::path& repoRoot,
@@ -382,37 +892,68 @@ bool GitHelper::IsFileDifferent(const boost::filesystem::path& repoRoot,
                         "\" working copy is edited, Git repository missing.");
   }
 
-  if (logger) {
-    logger->trace("Existing repository found, attempting to open it.");
-  }
+  LOOT_LOG_TRACE(logger, "Existing repository found, attempting to open it.");
   GitHelper git;
   git.Call(git_repository_open(&git.data_.repo, repoRoot.string().c_str()));
 
-  // Perform a git diff, then iterate the deltas to see if one exists for the
-  // masterlist.
-  if (logger) {
-    logger->trace("Getting the tree for the HEAD revision.");
-  }
+  LOOT_LOG_TRACE(logger, "Getting the tree for the HEAD revision.");
   git.Call(
       git_revparse_single(&git.data_.object, git.data_.repo, "HEAD^{tree}"));
   git.Call(git_tree_lookup(
       &git.data_.tree, git.data_.repo, git_object_id(git.data_.object)));
 
-  if (logger) {
-    logger->trace("Performing git diff.");
+  // Compare the blob ID recorded for the file in HEAD with the ID that the
+  // working copy would hash to, so that only the file itself is read.
+  LOOT_LOG_TRACE(logger, "Looking up \"{}\" in the HEAD tree.", filename);
+  int ret = git_tree_entry_bypath(
+      &git.data_.tree_entry, git.data_.tree, filename.c_str());
+  if (ret != GIT_ENOTFOUND) {
+    git.Call(ret);
+
+    LOOT_LOG_TRACE(logger, "Hashing the working copy of \"{}\".", filename);
+    git_oid workingCopyOid;
+    ret = git_repository_hashfile(&workingCopyOid,
+                                  git.data_.repo,
+                                  filename.c_str(),
+                                  GIT_OBJ_BLOB,
+                                  nullptr);
+    if (ret == 0) {
+      bool isDifferent =
+          git_oid_cmp(&workingCopyOid,
+                      git_tree_entry_id(git.data_.tree_entry)) != 0;
+      if (isDifferent && logger) {
+        logger->warn("Edited masterlist found.");
+      }
+
+      return isDifferent;
+    }
+
+    // The working copy couldn't be hashed, eg. because it has been deleted.
+    giterr_clear();
   }
-  git.Call(git_diff_tree_to_workdir_with_index(
-      &git.data_.diff, git.data_.repo, git.data_.tree, NULL));
 
-  if (logger) {
-    logger->trace("Iterating over git diff deltas.");
+  // The file isn't in HEAD or couldn't be hashed, so fall back to letting Git
+  // decide if it has changed.
+  return git.IsFileDifferentInDiff(filename);
+}
+
+bool GitHelper::IsFileDifferentInDiff(const std::string& filename) {
+  LOOT_LOG_TRACE(logger_, "Performing git diff limited to \"{}\".", filename);
+
+  char* path = const_cast<char*>(filename.c_str());
+  git_diff_options diff_options = GIT_DIFF_OPTIONS_INIT;
+  diff_options.flags = GIT_DIFF_DISABLE_PATHSPEC_MATCH;
+  diff_options.pathspec.strings = &path;
+  diff_options.pathspec.count = 1;
+
+  Call(git_diff_tree_to_workdir_with_index(
+      &data_.diff, data_.repo, data_.tree, &diff_options));
+
+  bool isDifferent = git_diff_num_deltas(data_.diff) > 0;
+  if (isDifferent && logger_) {
+    logger_->warn("Edited masterlist found.");
   }
-  GitHelper::DiffPayload payload;
-  payload.fileFound = false;
-  payload.fileToFind = filename.c_str();
-  git.Call(git_diff_foreach(
-      git.data_.diff, &git.DiffFileCallback, NULL, NULL, NULL, &payload));
 
-  return payload.fileFound;
+  return isDifferent;
 }
 }
@@ -25,20 +25,19 @@
 #ifndef LOOT_API_HELPERS_GIT_HELPER
 #define LOOT_API_HELPERS_GIT_HELPER
 
+#include <exception>
 #include <string>
+#include <vector>
 
 #include <git2.h>
 #include <spdlog/spdlog.h>
 #include <boost/filesystem.hpp>
 
+#include "loot/struct/transfer_progress.h"
+
 namespace loot {
 class GitHelper {
 public:
-  struct DiffPayload {
-    bool fileFound;
-    const char* fileToFind;
-  };
-
   struct GitData {
     GitData();
     ~GitData();
@@ -53,7 +52,10 @@ public:
     git_blob* blob;
     git_annotated_commit* annotated_commit;
     git_tree* tree;
+    git_tree_entry* tree_entry;
     git_diff* diff;
+    git_odb* odb;
+    git_odb_writepack* writepack;
     git_buf buffer;
 
     git_checkout_options checkout_options;
@@ -65,29 +67,105 @@ public:
 
   void Call(int error_code);
 
+  // The callback is passed the progress of clones and fetches, and cancels
+  // them if it returns false.
+  void SetTransferProgressCallback(const TransferProgressCallback& callback);
+
   static bool IsRepository(const boost::filesystem::path& path);
   static bool IsFileDifferent(const boost::filesystem::path& repoRoot,
                               const std::string& filename);
-  static int DiffFileCallback(const git_diff_delta* delta,
-                              float progress,
-                              void* payload);
 
-  void Clone(const boost::filesystem::path& path, const std::string& url);
-  void Fetch(const std::string& remote);
+  // If the clone options have a checkout branch, only that branch is cloned.
+  // If a depth is also given and the Git command line client is available,
+  // the clone is shallow and only has that many of the branch's latest
+  // commits.
+  void Clone(const boost::filesystem::path& path,
+             const std::string& url,
+             unsigned int depth = 0);
+
+  // Fetches only the given branch from the remote, without tags. Shallow
+  // clones are fetched using the Git command line client.
+  void Fetch(const std::string& remote, const std::string& branch);
+
+  // Fetches the given number of commits from the branch's history that are
+  // older than the oldest commits in a shallow clone. Returns false if the
+  // repository isn't a shallow clone or can't be deepened.
+  bool Deepen(const std::string& remote,
+              const std::string& branch,
+              unsigned int depth);
+
+  // Initialises a new repository at the given path with a remote that has the
+  // given name and URL, and opens it.
+  void Init(const boost::filesystem::path& path,
+            const std::string& remote,
+            const std::string& url);
+
+  // Writes the objects in a Git bundle to the repository's object database,
+  // then points the given remote's branch at the commit that the bundle has
+  // for that branch, as a fetch from the remote would.
+  void ApplyBundle(const boost::filesystem::path& bundlePath,
+                   const std::string& remote,
+                   const std::string& branch);
+
+  // Gets the ID of the commit that a branch points to in the given remote by
+  // listing the remote's refs, without fetching any objects.
+  git_oid GetRemoteBranchId(const std::string& remote,
+                            const std::string& branch);
 
   void CheckoutNewBranch(const std::string& remote, const std::string& branch);
   void CheckoutRevision(const std::string& revision);
 
   std::string GetHeadShortId();
+
+  // Returns false if the given commit has no parents.
+  bool GetFirstParentId(const git_oid& commitId, git_oid& parentId);
+
+  // Returns false if the commit isn't in the repository, e.g. because it's
+  // older than a shallow clone's history.
+  bool HasCommit(const git_oid& commitId);
+
+  // Reads a file's content at the given commit straight from the object
+  // database, without checking it out.
+  std::string GetFileContent(const git_oid& commitId,
+                             const std::string& filename);
   GitData& GetData();
 
 private:
+  static std::string GetBranchRefspec(const std::string& remote,
+                                      const std::string& branch);
+
+  static int CreateSingleBranchRemote(git_remote** out,
+                                      git_repository* repo,
+                                      const char* name,
+                                      const char* url,
+                                      void* payload);
+
+  static int OnTransferProgress(const git_transfer_progress* stats,
+                                void* payload);
+
+  void SetRemoteCallbacks(git_remote_callbacks& callbacks);
+
+  // Rethrows any exception thrown by the transfer progress callback, then
+  // handles the error code as Call() does.
+  void CallWithProgress(int error_code);
+
+  // Runs the Git command line client on the opened repository, or on no
+  // repository if none is open, passing its transfer progress to the
+  // progress callback. Throws if the client fails or the transfer is
+  // cancelled, as CallWithProgress() does.
+  void RunGit(const std::vector<std::string>& arguments);
+
+  // Diffs the HEAD tree against the working copy, limited to the given path.
+  bool IsFileDifferentInDiff(const std::string& filename);
+
   // Removes the read-only flag from some files in git repositories
   // created by libgit2.
   void FixRepoPermissions(const boost::filesystem::path& path);
 
   GitData data_;
   std::shared_ptr<spdlog::logger> logger_;
+  TransferProgressCallback progressCallback_;
+  std::exception_ptr progressException_;
 };
 }
 #endif
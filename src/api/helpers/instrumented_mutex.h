@@ -0,0 +1,62 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_INSTRUMENTED_MUTEX
+#define LOOT_API_HELPERS_INSTRUMENTED_MUTEX
+
+#include <mutex>
+
+#include "api/helpers/statistics.h"
+
+namespace loot {
+// A mutex that adds the time spent waiting to lock it to a statistic. Locking
+// it when it isn't held costs the same as locking a std::mutex, as the wait is
+// only timed if trying to lock it fails. The statistic is a template
+// parameter so that the mutex can be default-constructed, e.g. by spdlog's
+// sinks.
+template<Statistic waitTimeStatistic>
+class InstrumentedMutex {
+public:
+  InstrumentedMutex() = default;
+  InstrumentedMutex(const InstrumentedMutex&) = delete;
+  InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+  void lock() {
+    if (mutex_.try_lock())
+      return;
+
+    StatisticTimer timer(waitTimeStatistic);
+    mutex_.lock();
+  }
+
+  bool try_lock() { return mutex_.try_lock(); }
+
+  void unlock() { mutex_.unlock(); }
+
+private:
+  std::mutex mutex_;
+};
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/logging.h"
+
+#include <atomic>
+
+namespace loot {
+// Accessed atomically, as messages are logged from several threads.
+static std::shared_ptr<spdlog::logger> cachedLogger;
+static std::atomic<spdlog::level::level_enum> logLevel(spdlog::level::trace);
+
+std::shared_ptr<spdlog::logger> getLogger() {
+  return std::atomic_load(&cachedLogger);
+}
+
+void setLogger(std::shared_ptr<spdlog::logger> logger) {
+  if (logger) {
+    logger->set_level(logLevel);
+  }
+
+  std::atomic_store(&cachedLogger, logger);
+}
+
+void setLogLevel(spdlog::level::level_enum level) {
+  logLevel = level;
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->set_level(level);
+  }
+}
+}
@@ -26,16 +26,72 @@
 
 #include <spdlog/spdlog.h>
 
+#include "api/helpers/instrumented_mutex.h"
 #include "loot/enum/log_level.h"
 
+// Log messages at trace or debug level only if the logger exists and would
+// write them, so that disabled messages don't have their arguments formatted
+// or converted. Trace messages can be compiled out entirely by defining
+// LOOT_DISABLE_TRACE_LOGGING.
+#ifdef LOOT_DISABLE_TRACE_LOGGING
+#define LOOT_LOG_TRACE(logger, ...) \
+  do {                              \
+  } while (false)
+#else
+#define LOOT_LOG_TRACE(logger, ...)                               \
+  do {                                                            \
+    if ((logger) && (logger)->should_log(spdlog::level::trace)) { \
+      (logger)->trace(__VA_ARGS__);                               \
+    }                                                             \
+  } while (false)
+#endif
+
+#define LOOT_LOG_DEBUG(logger, ...)                               \
+  do {                                                            \
+    if ((logger) && (logger)->should_log(spdlog::level::debug)) { \
+      (logger)->debug(__VA_ARGS__);                               \
+    }                                                             \
+  } while (false)
+
 namespace loot {
 static const char* LOGGER_NAME = "loot_api_logger";
 
-inline std::shared_ptr<spdlog::logger> getLogger() {
-  return spdlog::get(LOGGER_NAME);
+// Returns a cached pointer to the logger, so that getting it doesn't need to
+// look it up in spdlog's locked registry. Returns null if no logging callback
+// has been set.
+std::shared_ptr<spdlog::logger> getLogger();
+
+// Replaces the cached logger and applies the current log level to it.
+void setLogger(std::shared_ptr<spdlog::logger> logger);
+
+// Sets the level of the current logger and of any logger set later.
+void setLogLevel(spdlog::level::level_enum level);
+
+inline spdlog::level::level_enum mapToSpdlog(LogLevel level) {
+  using spdlog::level::level_enum;
+  switch (level) {
+    case LogLevel::trace:
+      return level_enum::trace;
+    case LogLevel::debug:
+      return level_enum::debug;
+    case LogLevel::info:
+      return level_enum::info;
+    case LogLevel::warning:
+      return level_enum::warn;
+    case LogLevel::error:
+      return level_enum::err;
+    case LogLevel::fatal:
+      return level_enum::critical;
+    default:
+      return level_enum::trace;
+  }
 }
 
-class SpdLoggingSink : public spdlog::sinks::base_sink<std::mutex> {
+// The sink's mutex records the time that logging threads spend waiting for
+// each other to pass messages to the callback.
+class SpdLoggingSink
+    : public spdlog::sinks::base_sink<
+          InstrumentedMutex<Statistic::loggingLockWaitTime>> {
 public:
   SpdLoggingSink(std::function<void(LogLevel, const char*)> callback) {
     this->callback = callback;
@@ -0,0 +1,105 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/helpers/memory_accounting.h"
+
+#include <array>
+#include <atomic>
+
+namespace loot {
+namespace {
+// The counters have static storage and trivial constructors, so they are
+// zero before any dynamic initialisation runs and allocations made during it
+// are counted correctly.
+struct SubsystemCounters {
+  std::atomic<size_t> bytes;
+  std::atomic<size_t> peakBytes;
+};
+
+std::array<SubsystemCounters, MEMORY_SUBSYSTEM_COUNT> subsystemCounters;
+std::atomic<size_t> allocatedBytes;
+std::atomic<size_t> peakAllocatedBytes;
+std::atomic<size_t> allocationCount;
+
+thread_local MemorySubsystem currentSubsystem = MemorySubsystem::other;
+
+void UpdatePeak(std::atomic<size_t>& peak, size_t current) {
+  size_t previous = peak.load(std::memory_order_relaxed);
+  while (current > previous &&
+         !peak.compare_exchange_weak(previous, current)) {
+  }
+}
+
+SubsystemCounters& GetCounters(MemorySubsystem subsystem) {
+  return subsystemCounters[static_cast<size_t>(subsystem)];
+}
+}
+
+MemorySubsystem GetMemorySubsystem() { return currentSubsystem; }
+
+void RecordAllocation(MemorySubsystem subsystem, size_t bytes) {
+  auto& counters = GetCounters(subsystem);
+  UpdatePeak(counters.peakBytes, counters.bytes.fetch_add(bytes) + bytes);
+  UpdatePeak(peakAllocatedBytes, allocatedBytes.fetch_add(bytes) + bytes);
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RecordDeallocation(MemorySubsystem subsystem, size_t bytes) {
+  GetCounters(subsystem).bytes.fetch_sub(bytes);
+  allocatedBytes.fetch_sub(bytes);
+}
+
+size_t GetAllocatedBytes() { return allocatedBytes.load(); }
+
+size_t GetPeakAllocatedBytes() { return peakAllocatedBytes.load(); }
+
+size_t GetAllocationCount() { return allocationCount.load(); }
+
+void ResetPeakAllocatedBytes() {
+  peakAllocatedBytes.store(allocatedBytes.load());
+}
+
+MemoryUsage GetMemoryUsageBySubsystem() {
+  MemoryUsage usage;
+  usage.is_counted = GetAllocationCount() > 0;
+  usage.plugins_bytes = GetCounters(MemorySubsystem::plugins).bytes.load();
+  usage.metadata_lists_bytes =
+      GetCounters(MemorySubsystem::metadataLists).bytes.load();
+  usage.condition_cache_bytes =
+      GetCounters(MemorySubsystem::conditionCache).bytes.load();
+  usage.sorting_bytes = GetCounters(MemorySubsystem::sorting).bytes.load();
+  usage.sorting_peak_bytes =
+      GetCounters(MemorySubsystem::sorting).peakBytes.load();
+  usage.other_bytes = GetCounters(MemorySubsystem::other).bytes.load();
+
+  return usage;
+}
+
+MemoryScope::MemoryScope(MemorySubsystem subsystem) :
+    previousSubsystem_(currentSubsystem) {
+  currentSubsystem = subsystem;
+}
+
+MemoryScope::~MemoryScope() { currentSubsystem = previousSubsystem_; }
+}
@@ -0,0 +1,80 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_HELPERS_MEMORY_ACCOUNTING
+#define LOOT_API_HELPERS_MEMORY_ACCOUNTING
+
+#include <cstddef>
+
+#include "loot/struct/memory_usage.h"
+
+namespace loot {
+enum struct MemorySubsystem : size_t {
+  other,
+  plugins,
+  metadataLists,
+  conditionCache,
+  sorting,
+};
+
+static const size_t MEMORY_SUBSYSTEM_COUNT = 5;
+
+// Returns the subsystem that the calling thread's allocations are currently
+// attributed to.
+MemorySubsystem GetMemorySubsystem();
+
+// Called by the operator new and delete replacements in
+// memory_accounting_hook.cpp, which record the subsystem that each
+// allocation was attributed to so that it can be freed from the same one.
+// These don't allocate.
+void RecordAllocation(MemorySubsystem subsystem, size_t bytes);
+void RecordDeallocation(MemorySubsystem subsystem, size_t bytes);
+
+// Totals across all subsystems.
+size_t GetAllocatedBytes();
+size_t GetPeakAllocatedBytes();
+size_t GetAllocationCount();
+// Sets the peak to the number of bytes currently allocated.
+void ResetPeakAllocatedBytes();
+
+MemoryUsage GetMemoryUsageBySubsystem();
+
+// Attributes allocations made by the calling thread to a subsystem until it
+// is destroyed, when the previous subsystem is restored. Scopes only affect
+// the thread that they are created on, so threads started inside a scope
+// need their own.
+class MemoryScope {
+public:
+  explicit MemoryScope(MemorySubsystem subsystem);
+  ~MemoryScope();
+
+  MemoryScope(const MemoryScope&) = delete;
+  MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+  const MemorySubsystem previousSubsystem_;
+};
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+// Replaces the global operator new and delete to count heap allocations by
+// subsystem. This file isn't part of the API library unless it's built with
+// the LOOT_MEMORY_ACCOUNTING option, but is always linked into the tests and
+// benchmarks. Allocations made directly with malloc, eg. by libgit2, or by
+// Rust's allocator in esplugin and libloadorder, aren't counted. Each
+// allocation's size is stored before it, so memory allocated by another
+// operator new mustn't be freed here: that's why the option is refused for
+// Windows DLLs, which don't replace their clients' operators.
+
+#include <cstdlib>
+#include <new>
+
+#include "api/helpers/memory_accounting.h"
+
+namespace {
+struct AllocationHeader {
+  size_t size;
+  loot::MemorySubsystem subsystem;
+};
+
+// Each allocation is prefixed with its header, padded to keep the memory
+// returned suitably aligned.
+const size_t prefixSize =
+    (sizeof(AllocationHeader) + alignof(std::max_align_t) - 1) /
+    alignof(std::max_align_t) * alignof(std::max_align_t);
+
+void* Allocate(size_t size) noexcept {
+  void* block = std::malloc(prefixSize + size);
+  if (block == nullptr)
+    return nullptr;
+
+  auto header = static_cast<AllocationHeader*>(block);
+  header->size = size;
+  header->subsystem = loot::GetMemorySubsystem();
+  loot::RecordAllocation(header->subsystem, size);
+
+  return static_cast<char*>(block) + prefixSize;
+}
+
+void Deallocate(void* pointer) noexcept {
+  if (pointer == nullptr)
+    return;
+
+  void* block = static_cast<char*>(pointer) - prefixSize;
+  auto header = static_cast<AllocationHeader*>(block);
+  loot::RecordDeallocation(header->subsystem, header->size);
+  std::free(block);
+}
+
+void* AllocateOrThrow(size_t size) {
+  void* pointer = Allocate(size);
+  if (pointer == nullptr)
+    throw std::bad_alloc();
+
+  return pointer;
+}
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size); }
+
+void* operator new[](size_t size) { return AllocateOrThrow(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept { Deallocate(pointer); }
+
+void operator delete[](void* pointer) noexcept { Deallocate(pointer); }
+
+void operator delete(void* pointer, size_t) noexcept { Deallocate(pointer); }
+
+void operator delete[](void* pointer, size_t) noexcept { Deallocate(pointer); }
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  Deallocate(pointer);
+}
@@ -0,0 +1,184 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#include "api/helpers/statistics.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+
+namespace loot {
+namespace {
+struct ThreadStatistics {
+  ThreadStatistics() {
+    for (auto& value : values) {
+      value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::array<std::atomic<uint64_t>, STATISTIC_COUNT> values;
+};
+
+// Holds every live thread's counters, and the totals of exited threads.
+class StatisticsRegistry {
+public:
+  StatisticsRegistry() { retiredValues_.fill(0); }
+
+  void Register(ThreadStatistics* statistics) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    liveStatistics_.insert(statistics);
+  }
+
+  void Retire(ThreadStatistics* statistics) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (size_t i = 0; i < STATISTIC_COUNT; ++i) {
+      retiredValues_[i] +=
+          statistics->values[i].load(std::memory_order_relaxed);
+    }
+    liveStatistics_.erase(statistics);
+  }
+
+  StatisticValues Sum() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    StatisticValues values = retiredValues_;
+    for (const auto& statistics : liveStatistics_) {
+      for (size_t i = 0; i < STATISTIC_COUNT; ++i) {
+        values[i] += statistics->values[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    return values;
+  }
+
+private:
+  std::set<ThreadStatistics*> liveStatistics_;
+  StatisticValues retiredValues_;
+  mutable std::mutex mutex_;
+};
+
+// Statistics are also counted here while the thread is in a statistics scope.
+thread_local StatisticCounters* currentCounters = nullptr;
+
+// Never destroyed, so that threads that exit during static destruction can
+// still retire their counters.
+StatisticsRegistry& GetRegistry() {
+  static StatisticsRegistry* registry = new StatisticsRegistry();
+  return *registry;
+}
+
+class ThreadStatisticsHandle {
+public:
+  ThreadStatisticsHandle() { GetRegistry().Register(&statistics_); }
+  ~ThreadStatisticsHandle() { GetRegistry().Retire(&statistics_); }
+
+  ThreadStatistics& Get() { return statistics_; }
+
+private:
+  ThreadStatistics statistics_;
+};
+}
+
+void IncrementStatistic(Statistic statistic, uint64_t amount) {
+  thread_local ThreadStatisticsHandle handle;
+
+  // Only this thread writes to its counters, so a relaxed load and store is
+  // enough and avoids a locked read-modify-write.
+  auto& value = handle.Get().values[static_cast<size_t>(statistic)];
+  value.store(value.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+
+  if (currentCounters != nullptr)
+    currentCounters->Add(statistic, amount);
+}
+
+StatisticCounters::StatisticCounters() { Reset(); }
+
+void StatisticCounters::Add(Statistic statistic, uint64_t amount) {
+  values_[static_cast<size_t>(statistic)].fetch_add(amount,
+                                                    std::memory_order_relaxed);
+}
+
+StatisticValues StatisticCounters::GetValues() const {
+  StatisticValues values;
+  for (size_t i = 0; i < STATISTIC_COUNT; ++i) {
+    values[i] = values_[i].load(std::memory_order_relaxed);
+  }
+
+  return values;
+}
+
+void StatisticCounters::Reset() {
+  for (auto& value : values_) {
+    value.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::shared_ptr<StatisticCounters> GetStatisticCounters() {
+  if (currentCounters == nullptr)
+    return nullptr;
+
+  return currentCounters->shared_from_this();
+}
+
+StatisticsScope::StatisticsScope(StatisticCounters* counters) :
+    previousCounters_(currentCounters) {
+  currentCounters = counters;
+}
+
+StatisticsScope::~StatisticsScope() { currentCounters = previousCounters_; }
+
+StatisticValues GetStatisticValues() { return GetRegistry().Sum(); }
+
+GameStatistics ToGameStatistics(const StatisticValues& values,
+                                const StatisticValues& baseline) {
+  auto get = [&](Statistic statistic) {
+    size_t index = static_cast<size_t>(statistic);
+    return values[index] - baseline[index];
+  };
+
+  GameStatistics statistics;
+  statistics.plugins_parsed = get(Statistic::pluginsParsed);
+  statistics.bytes_read = get(Statistic::bytesRead);
+  statistics.crcs_computed = get(Statistic::crcsComputed);
+  statistics.esplugin_calls = get(Statistic::espluginCalls);
+  statistics.libloadorder_calls = get(Statistic::libloadorderCalls);
+  statistics.condition_cache_hits = get(Statistic::conditionCacheHits);
+  statistics.condition_cache_misses = get(Statistic::conditionCacheMisses);
+  statistics.regex_compilations = get(Statistic::regexCompilations);
+  statistics.metadata_lookups = get(Statistic::metadataLookups);
+  statistics.load_plugins_time =
+      std::chrono::nanoseconds(get(Statistic::loadPluginsTime));
+  statistics.sort_plugins_time =
+      std::chrono::nanoseconds(get(Statistic::sortPluginsTime));
+  statistics.load_lists_time =
+      std::chrono::nanoseconds(get(Statistic::loadListsTime));
+  statistics.update_masterlist_time =
+      std::chrono::nanoseconds(get(Statistic::updateMasterlistTime));
+  statistics.game_cache_lock_wait_time =
+      std::chrono::nanoseconds(get(Statistic::gameCacheLockWaitTime));
+  statistics.logging_lock_wait_time =
+      std::chrono::nanoseconds(get(Statistic::loggingLockWaitTime));
+
+  return statistics;
+}
+}
@@ -0,0 +1,127 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_API_HELPERS_STATISTICS
+#define LOOT_API_HELPERS_STATISTICS
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "loot/struct/game_statistics.h"
+
+namespace loot {
+enum struct Statistic : size_t {
+  pluginsParsed,
+  bytesRead,
+  crcsComputed,
+  espluginCalls,
+  libloadorderCalls,
+  conditionCacheHits,
+  conditionCacheMisses,
+  regexCompilations,
+  metadataLookups,
+  loadPluginsTime,
+  sortPluginsTime,
+  loadListsTime,
+  updateMasterlistTime,
+  gameCacheLockWaitTime,
+  loggingLockWaitTime,
+};
+
+static const size_t STATISTIC_COUNT = 15;
+
+typedef std::array<uint64_t, STATISTIC_COUNT> StatisticValues;
+
+// A game handle's statistics, which are counted in addition to the
+// process-wide counters by threads inside a StatisticsScope for them. Any
+// number of threads may add to them at once.
+class StatisticCounters
+    : public std::enable_shared_from_this<StatisticCounters> {
+public:
+  StatisticCounters();
+
+  void Add(Statistic statistic, uint64_t amount);
+  StatisticValues GetValues() const;
+  void Reset();
+
+private:
+  std::array<std::atomic<uint64_t>, STATISTIC_COUNT> values_;
+};
+
+// Adds to the calling thread's counter for the statistic, and to the counters
+// of its current statistics scope if it has one. Each thread only writes to
+// its own process-wide counters, so they don't contend with other threads.
+void IncrementStatistic(Statistic statistic, uint64_t amount = 1);
+
+// Returns the counters of the calling thread's current statistics scope, or
+// null if it isn't in one.
+std::shared_ptr<StatisticCounters> GetStatisticCounters();
+
+// Counts the calling thread's statistics in the given counters until it is
+// destroyed, when the previous counters are restored. The counters must
+// outlive the scope. Scopes only affect the thread that they are created on,
+// so threads started inside a scope need their own.
+class StatisticsScope {
+public:
+  explicit StatisticsScope(StatisticCounters* counters);
+  ~StatisticsScope();
+
+  StatisticsScope(const StatisticsScope&) = delete;
+  StatisticsScope& operator=(const StatisticsScope&) = delete;
+
+private:
+  StatisticCounters* const previousCounters_;
+};
+
+// Sums the counters of all threads, including threads that have exited.
+StatisticValues GetStatisticValues();
+
+// Converts the difference between two sets of values into the public
+// structure, with times in nanoseconds.
+GameStatistics ToGameStatistics(const StatisticValues& values,
+                                const StatisticValues& baseline);
+
+// Adds the time between its construction and destruction to a statistic.
+class StatisticTimer {
+public:
+  explicit StatisticTimer(Statistic statistic) :
+      statistic_(statistic),
+      start_(std::chrono::steady_clock::now()) {}
+
+  ~StatisticTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    IncrementStatistic(
+        statistic_,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+private:
+  const Statistic statistic_;
+  const std::chrono::steady_clock::time_point start_;
+};
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#include "api/helpers/tracing.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "loot/exception/file_access_error.h"
+
+namespace loot {
+std::atomic<bool> tracingEnabled(false);
+
+const std::string TraceScope::emptyArgument;
+
+namespace {
+struct TraceEvent {
+  const char* name;
+  const char* category;
+  std::string argument;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+};
+
+// Each thread appends to its own buffer, so threads only contend with the
+// thread writing the trace. Buffers outlive their threads so that events
+// recorded by short-lived worker threads are kept.
+struct ThreadTraceBuffer {
+  explicit ThreadTraceBuffer(unsigned int threadId) : threadId(threadId) {}
+
+  const unsigned int threadId;
+  std::vector<TraceEvent> events;
+  std::mutex mutex;
+};
+
+class TraceRegistry {
+public:
+  TraceRegistry() : nextThreadId_(1) {}
+
+  std::shared_ptr<ThreadTraceBuffer> CreateBuffer() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    buffers_.push_back(std::make_shared<ThreadTraceBuffer>(nextThreadId_));
+    ++nextThreadId_;
+
+    return buffers_.back();
+  }
+
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> GetBuffers() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return buffers_;
+  }
+
+  // Empties all buffers, and forgets those of threads that have exited.
+  void Clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> liveBuffers;
+    for (const auto& buffer : buffers_) {
+      std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+      buffer->events.clear();
+      if (buffer.use_count() > 1)
+        liveBuffers.push_back(buffer);
+    }
+    buffers_ = liveBuffers;
+  }
+
+  void SetStartTime(std::chrono::steady_clock::time_point startTime) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    startTime_ = startTime;
+  }
+
+  std::chrono::steady_clock::time_point GetStartTime() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return startTime_;
+  }
+
+private:
+  std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers_;
+  std::chrono::steady_clock::time_point startTime_;
+  unsigned int nextThreadId_;
+  std::mutex mutex_;
+};
+
+// Never destroyed, so that threads that exit during static destruction can
+// still release their buffers.
+TraceRegistry& GetRegistry() {
+  static TraceRegistry* registry = new TraceRegistry();
+  return *registry;
+}
+
+ThreadTraceBuffer& GetThreadBuffer() {
+  thread_local std::shared_ptr<ThreadTraceBuffer> buffer =
+      GetRegistry().CreateBuffer();
+  return *buffer;
+}
+
+std::string EscapeJson(const std::string& text) {
+  std::string escaped;
+  for (const char character : text) {
+    if (character == '"' || character == '\\') {
+      escaped += '\\';
+      escaped += character;
+    } else if (static_cast<unsigned char>(character) < 0x20) {
+      char buffer[8];
+      std::snprintf(buffer,
+                    sizeof(buffer),
+                    "\\u%04x",
+                    static_cast<unsigned char>(character));
+      escaped += buffer;
+    } else {
+      escaped += character;
+    }
+  }
+
+  return escaped;
+}
+
+long long ToMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+}
+
+void startTracing() {
+  tracingEnabled = false;
+  GetRegistry().Clear();
+  GetRegistry().SetStartTime(std::chrono::steady_clock::now());
+  tracingEnabled = true;
+}
+
+void stopTracing(const boost::filesystem::path& outputFile) {
+  tracingEnabled = false;
+
+  boost::filesystem::ofstream out(outputFile);
+  if (out.fail())
+    throw FileAccessError("Couldn't open output file: " + outputFile.string());
+
+  auto startTime = GetRegistry().GetStartTime();
+  bool isFirstEvent = true;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (const auto& buffer : GetRegistry().GetBuffers()) {
+    std::lock_guard<std::mutex> guard(buffer->mutex);
+    if (buffer->events.empty())
+      continue;
+
+    if (!isFirstEvent)
+      out << ",";
+    isFirstEvent = false;
+
+    out << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << buffer->threadId << ",\"args\":{\"name\":\"Thread "
+        << buffer->threadId << "\"}}";
+
+    for (const auto& event : buffer->events) {
+      // Skip events that started before tracing did.
+      if (event.start < startTime)
+        continue;
+
+      out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\""
+          << event.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+          << buffer->threadId
+          << ",\"ts\":" << ToMicroseconds(event.start - startTime)
+          << ",\"dur\":" << ToMicroseconds(event.end - event.start);
+      if (!event.argument.empty())
+        out << ",\"args\":{\"name\":\"" << EscapeJson(event.argument) << "\"}";
+      out << "}";
+    }
+  }
+  out << "\n]}\n";
+
+  GetRegistry().Clear();
+}
+
+void TraceScope::Record() {
+  TraceEvent event;
+  event.name = name_;
+  event.category = category_;
+  event.argument = std::move(argument_);
+  event.start = start_;
+  event.end = std::chrono::steady_clock::now();
+
+  auto& buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mutex);
+  buffer.events.push_back(std::move(event));
+}
+}
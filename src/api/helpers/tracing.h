@@ -0,0 +1,84 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_API_HELPERS_TRACING
+#define LOOT_API_HELPERS_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+namespace loot {
+extern std::atomic<bool> tracingEnabled;
+
+// Discards any recorded events and starts recording new events.
+void startTracing();
+
+// Stops recording events and writes those recorded as Chrome trace-event
+// JSON.
+void stopTracing(const boost::filesystem::path& outputFile);
+
+// Records the time between its construction and destruction as a complete
+// event on the calling thread. If tracing is disabled when it's constructed,
+// it does nothing, so that disabled tracing costs only an atomic load. The
+// name and category must be string literals, as only the pointers are kept.
+class TraceScope {
+public:
+  TraceScope(const char* name, const char* category) :
+      TraceScope(name, category, emptyArgument) {}
+
+  // The argument, eg. a filename, is shown with the event, and is only copied
+  // if tracing is enabled.
+  TraceScope(const char* name,
+             const char* category,
+             const std::string& argument) :
+      isEnabled_(tracingEnabled.load(std::memory_order_relaxed)),
+      name_(name),
+      category_(category) {
+    if (isEnabled_) {
+      argument_ = argument;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceScope() {
+    if (isEnabled_)
+      Record();
+  }
+
+private:
+  void Record();
+
+  static const std::string emptyArgument;
+
+  const bool isEnabled_;
+  const char* const name_;
+  const char* const category_;
+  std::string argument_;
+  std::chrono::steady_clock::time_point start_;
+};
+}
+
+#endif
@@ -24,14 +24,18 @@
 
 #include "api/masterlist.h"
 
+#include <functional>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
 #include <boost/format.hpp>
 
 #include "api/game/game.h"
 #include "api/helpers/git_helper.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
+#include "api/helpers/tracing.h"
 #include "loot/exception/file_access_error.h"
 #include "loot/exception/git_state_error.h"
 
@@ -41,8 +45,105 @@ using std::string;
 namespace fs = boost::filesystem;
 
 namespace loot {
+namespace {
+// Masterlists only need their recent history to roll back to a revision that
+// can be parsed, so only clone that much of it if possible.
+const unsigned int masterlistCloneDepth = 16;
+
+// Fetches the given number of older commits into a shallow clone's history.
+// Returns false if no more history can be fetched.
+typedef std::function<bool(unsigned int)> DeepenHistory;
+
+bool IsParseableRevision(GitHelper& git,
+                         const git_oid& commitId,
+                         const std::string& filename) {
+  try {
+    MetadataList masterlist;
+    masterlist.LoadFromString(git.GetFileContent(commitId, filename));
+
+    return true;
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      char revision[GIT_OID_HEXSZ + 1];
+      git_oid_tostr(revision, GIT_OID_HEXSZ + 1, &commitId);
+      logger->error("Masterlist parsing failed. Masterlist revision {}: {}",
+                    revision,
+                    e.what());
+    }
+
+    return false;
+  }
+}
+
+// Finds the newest revision in HEAD's first-parent history with a masterlist
+// that can be parsed, given that HEAD's masterlist can't be. Revisions are read
+// from the object database, probing exponentially further back from HEAD until
+// a parseable one is found and then bisecting the range between it and the
+// last unparseable probe. This assumes that all the unparseable revisions are
+// newer than all the parseable ones. If the search reaches the oldest commit in
+// a shallow clone, its history is deepened if a function to do so is given.
+git_oid FindLatestParseableRevision(GitHelper& git,
+                                    const std::string& filename,
+                                    const DeepenHistory& deepenHistory) {
+  std::vector<git_oid> history(1);
+  git.Call(git_reference_name_to_id(&history[0], git.GetData().repo, "HEAD"));
+
+  // Returns false if the history doesn't go back far enough.
+  auto extendHistory = [&](size_t index) {
+    while (history.size() <= index) {
+      git_oid parentId;
+      if (!git.GetFirstParentId(history.back(), parentId))
+        return false;
+
+      // Fetch as many older commits as there are newer ones, so that deepening
+      // keeps up with the exponential probes.
+      if (!git.HasCommit(parentId) &&
+          !(deepenHistory && deepenHistory(history.size()) &&
+            git.HasCommit(parentId)))
+        return false;
+
+      history.push_back(parentId);
+    }
+    return true;
+  };
+
+  size_t lastUnparseable = 0;
+  size_t firstParseable = 0;
+  for (size_t distance = 1; firstParseable == 0; distance *= 2) {
+    bool reachedRoot = !extendHistory(distance);
+    size_t index = reachedRoot ? history.size() - 1 : distance;
+
+    if (index == lastUnparseable)
+      break;
+
+    if (IsParseableRevision(git, history[index], filename))
+      firstParseable = index;
+    else if (reachedRoot)
+      break;
+    else
+      lastUnparseable = index;
+  }
+
+  if (firstParseable == 0)
+    throw GitStateError("No revision of the masterlist could be parsed.");
+
+  while (firstParseable - lastUnparseable > 1) {
+    size_t middle = lastUnparseable + (firstParseable - lastUnparseable) / 2;
+    if (IsParseableRevision(git, history[middle], filename))
+      firstParseable = middle;
+    else
+      lastUnparseable = middle;
+  }
+
+  return history[firstParseable];
+}
+}
+
 MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
                                    bool shortID) {
+  TraceScope scope("GetMasterlistInfo", "git", path.string());
+
   // Compare HEAD and working copy, and get revision info.
   GitHelper git;
   MasterlistInfo info;
@@ -63,9 +164,7 @@ MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
                         "\" is not a Git repository.");
   }
 
-  if (logger) {
-    logger->debug("Existing repository found, attempting to open it.");
-  }
+  LOOT_LOG_DEBUG(logger, "Existing repository found, attempting to open it.");
   git.Call(git_repository_open(&git.GetData().repo,
                                path.parent_path().string().c_str()));
 
@@ -77,9 +176,7 @@ MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
   git.Call(
       git_revparse_single(&git.GetData().object, git.GetData().repo, "HEAD"));
 
-  if (logger) {
-    logger->trace("Generating hex string for Git object ID.");
-  }
+  LOOT_LOG_TRACE(logger, "Generating hex string for Git object ID.");
   if (shortID) {
     git.Call(git_object_short_id(&git.GetData().buffer, git.GetData().object));
     info.revision_id = git.GetData().buffer.ptr;
@@ -89,9 +186,7 @@ MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
         c_rev, GIT_OID_HEXSZ + 1, git_object_id(git.GetData().object));
   }
 
-  if (logger) {
-    logger->trace("Getting date for Git object.");
-  }
+  LOOT_LOG_TRACE(logger, "Getting date for Git object.");
   const git_oid* oid = git_object_id(git.GetData().object);
   git.Call(git_commit_lookup(&git.GetData().commit, git.GetData().repo, oid));
   git_time_t time = git_commit_time(git.GetData().commit);
@@ -100,9 +195,7 @@ MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
   out << std::put_time(std::gmtime(&time), "%Y-%m-%d");
   info.revision_date = out.str();
 
-  if (logger) {
-    logger->trace("Diffing masterlist HEAD and working copy.");
-  }
+  LOOT_LOG_TRACE(logger, "Diffing masterlist HEAD and working copy.");
   info.is_modified =
       GitHelper::IsFileDifferent(path.parent_path(), path.filename().string());
 
@@ -111,6 +204,8 @@ MasterlistInfo Masterlist::GetInfo(const boost::filesystem::path& path,
 
 bool Masterlist::IsLatest(const boost::filesystem::path& path,
                           const std::string& repoBranch) {
+  TraceScope scope("IsLatestMasterlist", "git", path.string());
+
   if (repoBranch.empty())
     throw std::invalid_argument("Repository branch must not be empty.");
 
@@ -132,14 +227,9 @@ bool Masterlist::IsLatest(const boost::filesystem::path& path,
   git.Call(git_repository_open(&git.GetData().repo,
                                path.parent_path().string().c_str()));
 
-  git.Fetch("origin");
-
-  // Get the remote branch's commit ID.
-  git_oid branchOid;
-  git.Call(git_reference_name_to_id(
-      &branchOid,
-      git.GetData().repo,
-      (string("refs/remotes/origin/") + repoBranch).c_str()));
+  // Only the remote branch's commit ID is needed, so list the remote's refs
+  // instead of fetching.
+  git_oid branchOid = git.GetRemoteBranchId("origin", repoBranch);
 
   // Get HEAD's commit ID.
   git_oid headOid;
@@ -148,11 +238,127 @@ bool Masterlist::IsLatest(const boost::filesystem::path& path,
   return memcmp(branchOid.id, headOid.id, 20) == 0;
 }
 
+namespace {
+// Brings the local branch up to date with the branch of the same name in the
+// "origin" remote and checks it out, creating the local branch if necessary.
+// Returns false if the branch and masterlist file were already up to date.
+bool UpdateLocalBranch(GitHelper& git,
+                       const fs::path& repoPath,
+                       const std::string& filename,
+                       const std::string& repoBranch) {
+  auto logger = getLogger();
+
+  // Check that a local branch with the correct name exists.
+  int ret = git_branch_lookup(&git.GetData().reference,
+                              git.GetData().repo,
+                              repoBranch.c_str(),
+                              GIT_BRANCH_LOCAL);
+  if (ret == GIT_ENOTFOUND)
+    // Branch doesn't exist. Create a new branch using the remote branch's
+    // latest commit.
+    git.CheckoutNewBranch("origin", repoBranch);
+  else {
+    // The local branch exists, so bring it up to date.
+    git.Call(ret);  // Handle other errors from preceding branch lookup.
+
+    // Check if HEAD points to the desired branch and set it to if not.
+    if (!git_branch_is_head(git.GetData().reference)) {
+      LOOT_LOG_TRACE(logger, "Setting HEAD to follow branch: {}", repoBranch);
+      git.Call(git_repository_set_head(
+          git.GetData().repo, (string("refs/heads/") + repoBranch).c_str()));
+    }
+
+    // Get remote branch reference.
+    git.Call(git_branch_upstream(&git.GetData().reference2,
+                                 git.GetData().reference));
+
+    // LOOT never commits to the local branch, so it's always just moved to
+    // the remote branch's commit, instead of finding their merge base. That
+    // history walk could fail in a shallow clone by reaching its oldest
+    // commits.
+    git_oid remoteCommitId;
+    git_oid_cpy(&remoteCommitId,
+                git_reference_target(git.GetData().reference2));
+    git_reference_free(git.GetData().reference2);
+    git.GetData().reference2 = nullptr;
+
+    if (git_oid_equal(git_reference_target(git.GetData().reference),
+                      &remoteCommitId)) {
+      // If the masterlist in HEAD also matches the masterlist file, no
+      // further action needs to be taken. Otherwise, a checkout must be
+      // performed and the checked-out file parsed.
+      LOOT_LOG_TRACE(logger, "Local and remote branch heads are equal.");
+      if (!GitHelper::IsFileDifferent(repoPath, filename)) {
+        if (logger) {
+          logger->info(
+              "Local branch and masterlist file are already up to date.");
+        }
+        return false;
+      }
+    } else {
+      // Update the local branch reference to point to the same commit as
+      // the remote branch reference.
+      LOOT_LOG_TRACE(logger,
+                     "Syncing local branch head with remote branch head.");
+      git.Call(git_reference_set_target(&git.GetData().reference2,
+                                        git.GetData().reference,
+                                        &remoteCommitId,
+                                        "Setting branch reference."));
+
+      git_reference_free(git.GetData().reference2);
+      git.GetData().reference2 = nullptr;
+    }
+
+    git_reference_free(git.GetData().reference);
+    git.GetData().reference = nullptr;
+
+    LOOT_LOG_TRACE(logger, "Performing a Git checkout of HEAD.");
+    git.Call(git_checkout_head(git.GetData().repo,
+                               &git.GetData().checkout_options));
+  }
+
+  return true;
+}
+
+// Loads the checked-out masterlist. If it can't be parsed, the newest revision
+// that can be is found without checking any out, then HEAD is detached to that
+// revision and its masterlist is loaded.
+void LoadLatestParseableRevision(Masterlist& masterlist,
+                                 GitHelper& git,
+                                 const fs::path& path,
+                                 const DeepenHistory& deepenHistory) {
+  try {
+    masterlist.Load(path);
+  } catch (std::exception& e) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Masterlist parsing failed. Masterlist revision {}: {}",
+                    git.GetHeadShortId(),
+                    e.what());
+    }
+
+    git_oid commitId = FindLatestParseableRevision(
+        git, path.filename().string(), deepenHistory);
+
+    char revision[GIT_OID_HEXSZ + 1];
+    git_oid_tostr(revision, GIT_OID_HEXSZ + 1, &commitId);
+    git.CheckoutRevision(revision);
+
+    masterlist.Load(path);
+  }
+}
+}
+
 bool Masterlist::Update(const boost::filesystem::path& path,
                         const std::string& repoUrl,
-                        const std::string& repoBranch) {
+                        const std::string& repoBranch,
+                        const TransferProgressCallback& progressCallback) {
+  StatisticTimer timer(Statistic::updateMasterlistTime);
+  TraceScope scope("UpdateMasterlist", "git", path.string());
+
   GitHelper git;
   auto logger = getLogger();
+  git.SetTransferProgressCallback(progressCallback);
   fs::path repoPath = path.parent_path();
   string filename = path.filename().string();
 
@@ -160,9 +366,7 @@ bool Masterlist::Update(const boost::filesystem::path& path,
     throw std::invalid_argument("Repository URL and branch must not be empty.");
 
   // Initialise checkout options.
-  if (logger) {
-    logger->debug("Setting up checkout options.");
-  }
+  LOOT_LOG_DEBUG(logger, "Setting up checkout options.");
   char* paths = new char[filename.length() + 1];
   strcpy(paths, filename.c_str());
   git.GetData().checkout_options.checkout_strategy =
@@ -176,12 +380,11 @@ bool Masterlist::Update(const boost::filesystem::path& path,
   git.GetData().clone_options.checkout_branch = repoBranch.c_str();
 
   // Now try to access the repository if it exists, or clone one if it doesn't.
-  if (logger) {
-    logger->trace("Attempting to open the Git repository at: {}",
-                  repoPath.string());
-  }
+  LOOT_LOG_TRACE(logger,
+                 "Attempting to open the Git repository at: {}",
+                 repoPath.string());
   if (!git.IsRepository(repoPath))
-    git.Clone(repoPath, repoUrl);
+    git.Clone(repoPath, repoUrl, masterlistCloneDepth);
   else {
     // Repository exists: check settings are correct, then pull updates.
 
@@ -199,182 +402,68 @@ bool Masterlist::Update(const boost::filesystem::path& path,
     git.Call(git_remote_set_url(git.GetData().repo, "origin", repoUrl.c_str()));
 
     // Now fetch updates from the remote.
-    git.Fetch("origin");
-
-    // Check that a local branch with the correct name exists.
-    int ret = git_branch_lookup(&git.GetData().reference,
-                                git.GetData().repo,
-                                repoBranch.c_str(),
-                                GIT_BRANCH_LOCAL);
-    if (ret == GIT_ENOTFOUND)
-      // Branch doesn't exist. Create a new branch using the remote branch's
-      // latest commit.
-      git.CheckoutNewBranch("origin", repoBranch);
-    else {
-      // The local branch exists. Need to merge the remote branch
-      // into it.
-      git.Call(ret);  // Handle other errors from preceding branch lookup.
-
-      // Check if HEAD points to the desired branch and set it to if not.
-      if (!git_branch_is_head(git.GetData().reference)) {
-        if (logger) {
-          logger->trace("Setting HEAD to follow branch: {}", repoBranch);
-        }
-        git.Call(git_repository_set_head(
-            git.GetData().repo, (string("refs/heads/") + repoBranch).c_str()));
-      }
+    git.Fetch("origin", repoBranch);
 
-      // Get remote branch reference.
-      git.Call(git_branch_upstream(&git.GetData().reference2,
-                                   git.GetData().reference));
+    if (!UpdateLocalBranch(git, repoPath, filename, repoBranch))
+      return false;
+  }
 
-      if (logger) {
-        logger->trace("Checking HEAD and remote branch's mergeability.");
-      }
-      git_merge_analysis_t analysis;
-      git_merge_preference_t pref;
-      git.Call(git_annotated_commit_from_ref(&git.GetData().annotated_commit,
-                                             git.GetData().repo,
-                                             git.GetData().reference2));
-      git.Call(git_merge_analysis(
-          &analysis,
-          &pref,
-          git.GetData().repo,
-          (const git_annotated_commit**)&git.GetData().annotated_commit,
-          1));
-
-      if ((analysis & GIT_MERGE_ANALYSIS_FASTFORWARD) == 0 &&
-          (analysis & GIT_MERGE_ANALYSIS_UP_TO_DATE) == 0) {
-        // The local branch can't be easily merged. Best just to delete and
-        // recreate it.
-        if (logger) {
-          logger->trace(
-              "Local branch cannot be easily merged with remote branch.");
-        }
+  // Now whether the repository was cloned or updated, the working directory
+  // contains the latest masterlist.
+  LoadLatestParseableRevision(*this, git, path, [&](unsigned int depth) {
+    return git.Deepen("origin", repoBranch, depth);
+  });
 
-        if (logger) {
-          logger->trace("Detaching HEAD so that the branch can be recreated.");
-        }
-        git.Call(git_repository_detach_head(git.GetData().repo));
-
-        // Need to free ref before calling git.CheckoutNewBranch()
-        git_reference_free(git.GetData().reference);
-        git.GetData().reference = nullptr;
-        git_reference_free(git.GetData().reference2);
-        git.GetData().reference2 = nullptr;
-
-        git.CheckoutNewBranch("origin", repoBranch);
-      } else {
-        // Get remote branch commit ID.
-        git.Call(git_reference_peel(
-            &git.GetData().object, git.GetData().reference2, GIT_OBJ_COMMIT));
-        const git_oid* remote_commit_id = git_object_id(git.GetData().object);
-
-        git_object_free(git.GetData().object);
-        git.GetData().object = nullptr;
-        git_reference_free(git.GetData().reference2);
-        git.GetData().reference2 = nullptr;
-
-        bool updateBranchHead = true;
-        if ((analysis & GIT_MERGE_ANALYSIS_UP_TO_DATE) != 0) {
-          // No merge is required, but HEAD might be ahead of the remote branch.
-          // Check to see if that's the case, and move HEAD back to match the
-          // remote branch if so.
-          if (logger) {
-            logger->trace(
-                "Local branch is up-to-date with remote branch. Checking to "
-                "see if local and remote branch heads are equal.");
-          }
-
-          // Get local branch commit ID.
-          git.Call(git_reference_peel(
-              &git.GetData().object, git.GetData().reference, GIT_OBJ_COMMIT));
-          const git_oid* local_commit_id = git_object_id(git.GetData().object);
-
-          git_object_free(git.GetData().object);
-          git.GetData().object = nullptr;
-
-          updateBranchHead = local_commit_id->id != remote_commit_id->id;
-
-          // If the masterlist in
-          // HEAD also matches the masterlist file, no further
-          // action needs to be taken. Otherwise, a checkout
-          // must be performed and the checked-out file parsed.
-          if (!updateBranchHead) {
-            if (logger) {
-              logger->trace("Local and remote branch heads are equal.");
-            }
-            if (!GitHelper::IsFileDifferent(repoPath, filename)) {
-              if (logger) {
-                logger->info(
-                    "Local branch and masterlist file are already up to date.");
-              }
-              return false;
-            }
-          } else if (logger) {
-            logger->trace("Local branch heads is ahead of remote branch head.");
-          }
-        } else if (logger) {
-          logger->trace("Local branch can be fast-forwarded to remote branch.");
-        }
+  return true;
+}
 
-        if (updateBranchHead) {
-          // The remote branch reference points to a particular
-          // commit. Update the local branch reference to point
-          // to the same commit.
-          if (logger) {
-            logger->trace("Syncing local branch head with remote branch head.");
-          }
-          git.Call(git_reference_set_target(&git.GetData().reference2,
-                                            git.GetData().reference,
-                                            remote_commit_id,
-                                            "Setting branch reference."));
-
-          git_reference_free(git.GetData().reference2);
-          git.GetData().reference2 = nullptr;
-        }
+bool Masterlist::UpdateFromBundle(const boost::filesystem::path& path,
+                                  const boost::filesystem::path& bundlePath,
+                                  const std::string& repoBranch) {
+  StatisticTimer timer(Statistic::updateMasterlistTime);
+  TraceScope scope("UpdateMasterlistFromBundle", "git", path.string());
+
+  GitHelper git;
+  auto logger = getLogger();
+  fs::path repoPath = path.parent_path();
+  string filename = path.filename().string();
 
-        git_reference_free(git.GetData().reference);
-        git.GetData().reference = nullptr;
+  if (bundlePath.empty() || repoBranch.empty())
+    throw std::invalid_argument("Bundle path and branch must not be empty.");
 
-        if (logger) {
-          logger->trace("Performing a Git checkout of HEAD.");
-        }
-        git.Call(git_checkout_head(git.GetData().repo,
-                                   &git.GetData().checkout_options));
-      }
+  if (!fs::exists(bundlePath))
+    throw FileAccessError("The given bundle path does not exist: " +
+                          bundlePath.string());
+
+  // Initialise checkout options.
+  LOOT_LOG_DEBUG(logger, "Setting up checkout options.");
+  char* paths = new char[filename.length() + 1];
+  strcpy(paths, filename.c_str());
+  git.GetData().checkout_options.checkout_strategy =
+      GIT_CHECKOUT_FORCE | GIT_CHECKOUT_DONT_REMOVE_EXISTING;
+  git.GetData().checkout_options.paths.strings = &paths;
+  git.GetData().checkout_options.paths.count = 1;
+
+  // Open the repository, or create one if it doesn't exist. The bundle is
+  // then applied as if it had been fetched from the "origin" remote.
+  if (!git.IsRepository(repoPath)) {
+    git.Init(repoPath, "origin", fs::absolute(bundlePath).generic_string());
+  } else {
+    if (logger) {
+      logger->info("Existing repository found, attempting to open it.");
     }
+    git.Call(
+        git_repository_open(&git.GetData().repo, repoPath.string().c_str()));
   }
 
-  // Now whether the repository was cloned or updated, the working directory
-  // contains the latest masterlist. Try parsing it: on failure, detach the HEAD
-  // back one commit and try again.
+  git.ApplyBundle(bundlePath, "origin", repoBranch);
 
-  bool parsingFailed = false;
-  do {
-    // Get the HEAD revision's short ID.
-    string revision = git.GetHeadShortId();
+  if (!UpdateLocalBranch(git, repoPath, filename, repoBranch))
+    return false;
 
-    // Now try parsing the masterlist.
-    if (logger) {
-      logger->debug("Testing masterlist parsing.");
-    }
-    try {
-      this->Load(path);
-
-      parsingFailed = false;
-    } catch (std::exception& e) {
-      parsingFailed = true;
-
-      // There was an error, roll back one revision.
-      if (logger) {
-        logger->error("Masterlist parsing failed. Masterlist revision {}: {}",
-                      revision,
-                      e.what());
-      }
-      git.CheckoutRevision("HEAD^");
-    }
-  } while (parsingFailed);
+  // Bundle updates don't access the network, so a shallow clone's history
+  // isn't deepened.
+  LoadLatestParseableRevision(*this, git, path, nullptr);
 
   return true;
 }
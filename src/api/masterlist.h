@@ -31,13 +31,19 @@
 
 #include "api/metadata_list.h"
 #include "loot/struct/masterlist_info.h"
+#include "loot/struct/transfer_progress.h"
 
 namespace loot {
 class Masterlist : public MetadataList {
 public:
   bool Update(const boost::filesystem::path& path,
               const std::string& repoURL,
-              const std::string& repoBranch);
+              const std::string& repoBranch,
+              const TransferProgressCallback& progressCallback = nullptr);
+
+  bool UpdateFromBundle(const boost::filesystem::path& path,
+                        const boost::filesystem::path& bundlePath,
+                        const std::string& repoBranch);
 
   static MasterlistInfo GetInfo(const boost::filesystem::path& path,
                                 bool shortID);
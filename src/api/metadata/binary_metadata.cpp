@@ -0,0 +1,219 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/metadata/binary_metadata.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace loot {
+namespace {
+void WriteMetadata(BinaryWriter& writer, const MessageContent& content) {
+  writer.Write(content.GetText());
+  writer.Write(content.GetLanguage());
+}
+
+void WriteMetadata(BinaryWriter& writer, const File& file) {
+  writer.Write(file.GetName());
+  writer.Write(file.GetDisplayName());
+  writer.Write(file.GetCondition());
+}
+
+void WriteMetadata(BinaryWriter& writer, const Tag& tag) {
+  writer.Write(tag.GetName());
+  writer.Write(tag.IsAddition());
+  writer.Write(tag.GetCondition());
+}
+
+void WriteMetadata(BinaryWriter& writer, const PluginCleaningData& info) {
+  writer.Write(info.GetCRC());
+  writer.Write(info.GetCleaningUtility());
+  writer.Write(static_cast<uint32_t>(info.GetITMCount()));
+  writer.Write(static_cast<uint32_t>(info.GetDeletedReferenceCount()));
+  writer.Write(static_cast<uint32_t>(info.GetDeletedNavmeshCount()));
+
+  auto content = info.GetInfo();
+  writer.Write(static_cast<uint32_t>(content.size()));
+  for (const auto& item : content) {
+    WriteMetadata(writer, item);
+  }
+}
+
+void WriteMetadata(BinaryWriter& writer, const Location& location) {
+  writer.Write(location.GetURL());
+  writer.Write(location.GetName());
+}
+
+void WriteMetadata(BinaryWriter& writer, const Priority& priority) {
+  writer.Write(priority.IsExplicit());
+  writer.Write(static_cast<int16_t>(priority.GetValue()));
+}
+
+template<typename T>
+void WriteMetadata(BinaryWriter& writer, const std::set<T>& values) {
+  writer.Write(static_cast<uint32_t>(values.size()));
+  for (const auto& value : values) {
+    WriteMetadata(writer, value);
+  }
+}
+
+MessageContent ReadMessageContent(BinaryReader& reader) {
+  std::string text = reader.Read<std::string>();
+  std::string language = reader.Read<std::string>();
+
+  return MessageContent(text, language);
+}
+
+std::vector<MessageContent> ReadMessageContents(BinaryReader& reader) {
+  std::vector<MessageContent> contents;
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    contents.push_back(ReadMessageContent(reader));
+  }
+
+  return contents;
+}
+
+File ReadFile(BinaryReader& reader) {
+  std::string name = reader.Read<std::string>();
+  std::string display = reader.Read<std::string>();
+  std::string condition = reader.Read<std::string>();
+
+  return File(name, display, condition);
+}
+
+Tag ReadTag(BinaryReader& reader) {
+  std::string name = reader.Read<std::string>();
+  bool isAddition = reader.Read<bool>();
+  std::string condition = reader.Read<std::string>();
+
+  return Tag(name, isAddition, condition);
+}
+
+PluginCleaningData ReadPluginCleaningData(BinaryReader& reader) {
+  uint32_t crc = reader.Read<uint32_t>();
+  std::string utility = reader.Read<std::string>();
+  uint32_t itm = reader.Read<uint32_t>();
+  uint32_t ref = reader.Read<uint32_t>();
+  uint32_t nav = reader.Read<uint32_t>();
+  auto info = ReadMessageContents(reader);
+
+  return PluginCleaningData(crc, utility, info, itm, ref, nav);
+}
+
+Location ReadLocation(BinaryReader& reader) {
+  std::string url = reader.Read<std::string>();
+  std::string name = reader.Read<std::string>();
+
+  return Location(url, name);
+}
+
+Priority ReadPriority(BinaryReader& reader) {
+  bool isExplicit = reader.Read<bool>();
+  int16_t value = reader.Read<int16_t>();
+
+  if (isExplicit)
+    return Priority(value);
+
+  return Priority();
+}
+
+template<typename T>
+std::set<T> ReadSet(BinaryReader& reader, T (*readValue)(BinaryReader&)) {
+  std::set<T> values;
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    values.insert(readValue(reader));
+  }
+
+  return values;
+}
+}
+
+void WriteMetadata(BinaryWriter& writer, const PluginMetadata& plugin) {
+  writer.Write(plugin.GetName());
+  writer.Write(plugin.IsEnabled());
+  WriteMetadata(writer, plugin.GetLocalPriority());
+  WriteMetadata(writer, plugin.GetGlobalPriority());
+  WriteMetadata(writer, plugin.GetLoadAfterFiles());
+  WriteMetadata(writer, plugin.GetRequirements());
+  WriteMetadata(writer, plugin.GetIncompatibilities());
+
+  auto messages = plugin.GetMessages();
+  writer.Write(static_cast<uint32_t>(messages.size()));
+  for (const auto& message : messages) {
+    WriteMetadata(writer, message);
+  }
+
+  WriteMetadata(writer, plugin.GetTags());
+  WriteMetadata(writer, plugin.GetDirtyInfo());
+  WriteMetadata(writer, plugin.GetCleanInfo());
+  WriteMetadata(writer, plugin.GetLocations());
+}
+
+void WriteMetadata(BinaryWriter& writer, const Message& message) {
+  writer.Write(static_cast<uint32_t>(message.GetType()));
+
+  auto content = message.GetContent();
+  writer.Write(static_cast<uint32_t>(content.size()));
+  for (const auto& item : content) {
+    WriteMetadata(writer, item);
+  }
+
+  writer.Write(message.GetCondition());
+}
+
+PluginMetadata ReadPluginMetadata(BinaryReader& reader) {
+  PluginMetadata plugin(reader.Read<std::string>());
+  plugin.SetEnabled(reader.Read<bool>());
+  plugin.SetLocalPriority(ReadPriority(reader));
+  plugin.SetGlobalPriority(ReadPriority(reader));
+  plugin.SetLoadAfterFiles(ReadSet(reader, &ReadFile));
+  plugin.SetRequirements(ReadSet(reader, &ReadFile));
+  plugin.SetIncompatibilities(ReadSet(reader, &ReadFile));
+
+  std::vector<Message> messages;
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    messages.push_back(ReadMessage(reader));
+  }
+  plugin.SetMessages(messages);
+
+  plugin.SetTags(ReadSet(reader, &ReadTag));
+  plugin.SetDirtyInfo(ReadSet(reader, &ReadPluginCleaningData));
+  plugin.SetCleanInfo(ReadSet(reader, &ReadPluginCleaningData));
+  plugin.SetLocations(ReadSet(reader, &ReadLocation));
+
+  return plugin;
+}
+
+Message ReadMessage(BinaryReader& reader) {
+  MessageType type = static_cast<MessageType>(reader.Read<uint32_t>());
+  auto content = ReadMessageContents(reader);
+  std::string condition = reader.Read<std::string>();
+
+  return Message(type, content, condition);
+}
+}
@@ -0,0 +1,44 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_METADATA_BINARY_METADATA
+#define LOOT_API_METADATA_BINARY_METADATA
+
+#include "api/helpers/binary_stream.h"
+#include "loot/metadata/message.h"
+#include "loot/metadata/plugin_metadata.h"
+
+namespace loot {
+// Metadata is written in a compact binary form for game handle snapshots.
+// Conditions are written unparsed, and are parsed again when they are next
+// evaluated.
+void WriteMetadata(BinaryWriter& writer, const PluginMetadata& plugin);
+void WriteMetadata(BinaryWriter& writer, const Message& message);
+
+// Throws if the data is truncated.
+PluginMetadata ReadPluginMetadata(BinaryReader& reader);
+Message ReadMessage(BinaryReader& reader);
+}
+
+#endif
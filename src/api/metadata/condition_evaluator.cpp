@@ -29,6 +29,8 @@
 
 #include "api/helpers/crc.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
+#include "api/helpers/tracing.h"
 #include "api/metadata/condition_grammar.h"
 #include "loot/exception/condition_syntax_error.h"
 
@@ -60,9 +62,7 @@ bool ConditionEvaluator::evaluate(const std::string& condition) const {
     return true;
 
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Evaluating condition: {}", condition);
-  }
+  LOOT_LOG_TRACE(logger, "Evaluating condition: {}", condition);
 
   auto cachedValue = gameCache_->GetCachedCondition(condition);
   if (cachedValue.second)
@@ -106,6 +106,9 @@ PluginMetadata ConditionEvaluator::evaluateAll(
   if (shouldParseOnly())
     return pluginMetadata;
 
+  TraceScope scope(
+      "EvaluatePluginConditions", "conditions", pluginMetadata.GetName());
+
   PluginMetadata evaluatedMetadata(pluginMetadata.GetName());
   evaluatedMetadata.SetEnabled(pluginMetadata.IsEnabled());
   evaluatedMetadata.SetLocalPriority(pluginMetadata.GetLocalPriority());
@@ -292,9 +295,7 @@ bool ConditionEvaluator::compareVersions(const std::string& filePath,
   Version trueVersion = getVersion(filePath);
 
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Version extracted: {}", trueVersion.AsString());
-  }
+  LOOT_LOG_TRACE(logger, "Version extracted: {}", trueVersion.AsString());
 
   return ((comparator == "==" && trueVersion == givenVersion) ||
           (comparator == "!=" && trueVersion != givenVersion) ||
@@ -306,9 +307,8 @@ bool ConditionEvaluator::compareVersions(const std::string& filePath,
 
 void ConditionEvaluator::validatePath(const boost::filesystem::path& path) {
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Checking to see if the path \"{}\" is safe.", path.string());
-  }
+  LOOT_LOG_TRACE(
+      logger, "Checking to see if the path \"{}\" is safe.", path.string());
 
   boost::filesystem::path temp;
   for (const auto& component : path) {
@@ -324,6 +324,7 @@ void ConditionEvaluator::validatePath(const boost::filesystem::path& path) {
   }
 }
 void ConditionEvaluator::validateRegex(const std::string& regexString) {
+  IncrementStatistic(Statistic::regexCompilations);
   try {
     std::regex(regexString, std::regex::ECMAScript | std::regex::icase);
   } catch (std::regex_error& e) {
@@ -368,6 +369,7 @@ std::pair<boost::filesystem::path, std::regex> ConditionEvaluator::splitRegex(
   validatePath(parent);
 
   std::regex reg;
+  IncrementStatistic(Statistic::regexCompilations);
   try {
     reg = std::regex(filename, std::regex::ECMAScript | std::regex::icase);
   } catch (std::regex_error& e) {
@@ -394,10 +396,9 @@ bool ConditionEvaluator::isRegexMatchInDataDirectory(
   // parent path exists and is a directory.
   if (!isGameSubdirectory(pathRegex.first)) {
     auto logger = getLogger();
-    if (logger) {
-      logger->trace("The path \"{}\" is not a game subdirectory.",
-                    pathRegex.first.string());
-    }
+    LOOT_LOG_TRACE(logger,
+                   "The path \"{}\" is not a game subdirectory.",
+                   pathRegex.first.string());
     return false;
   }
 
@@ -200,9 +200,7 @@ private:
 
   // Eval's exact paths. Check for files and ghosted plugins.
   void CheckFile(bool& result, const std::string& file) const {
-    if (logger_) {
-      logger_->trace("Checking to see if the file \"{}\" exists.", file);
-    }
+    LOOT_LOG_TRACE(logger_, "Checking to see if the file \"{}\" exists.", file);
 
     result = false;
     if (IsRegex(file))
@@ -210,18 +208,15 @@ private:
     else
       result = evaluator_.fileExists(file);
 
-    if (logger_) {
-      logger_->trace("File check result: {}", result);
-    }
+    LOOT_LOG_TRACE(logger_, "File check result: {}", result);
   }
 
   void CheckMany(bool& result, const std::string& regexStr) const {
-    if (logger_) {
-      logger_->trace(
-          "Checking to see if more than one file matching the regex \"{}\" "
-          "exists.",
-          regexStr);
-    }
+    LOOT_LOG_TRACE(
+        logger_,
+        "Checking to see if more than one file matching the regex \"{}\" "
+        "exists.",
+        regexStr);
 
     result = false;
     result = evaluator_.regexMatchesExist(regexStr);
@@ -230,9 +225,7 @@ private:
   void CheckSum(bool& result,
                 const std::string& file,
                 const uint32_t checksum) {
-    if (logger_) {
-      logger_->trace("Checking the CRC of the file \"{}\".", file);
-    }
+    LOOT_LOG_TRACE(logger_, "Checking the CRC of the file \"{}\".", file);
 
     result = false;
     result = evaluator_.checksumMatches(file, checksum);
@@ -242,16 +235,12 @@ private:
                     const std::string& file,
                     const std::string& version,
                     const std::string& comparator) const {
-    if (logger_) {
-      logger_->trace("Checking the version of the file \"{}\".", file);
-    }
+    LOOT_LOG_TRACE(logger_, "Checking the version of the file \"{}\".", file);
 
     result = false;
     result = evaluator_.compareVersions(file, version, comparator);
 
-    if (logger_) {
-      logger_->trace("Version check result: {}", result);
-    }
+    LOOT_LOG_TRACE(logger_, "Version check result: {}", result);
   }
 
   void CheckActive(bool& result, const std::string& file) const {
@@ -261,18 +250,15 @@ private:
     else
       result = evaluator_.isPluginActive(file);
 
-    if (logger_) {
-      logger_->trace("Active check result: {}", result);
-    }
+    LOOT_LOG_TRACE(logger_, "Active check result: {}", result);
   }
 
   void CheckManyActive(bool& result, const std::string& regexStr) const {
-    if (logger_) {
-      logger_->trace(
-          "Checking to see if more than one file matching the regex \"{}\" is "
-          "active.",
-          regexStr);
-    }
+    LOOT_LOG_TRACE(
+        logger_,
+        "Checking to see if more than one file matching the regex \"{}\" is "
+        "active.",
+        regexStr);
 
     result = false;
     result = evaluator_.arePluginsActive(regexStr);
@@ -43,9 +43,7 @@ std::string ConditionalMetadata::GetCondition() const { return condition_; }
 void ConditionalMetadata::ParseCondition() const {
   if (!condition_.empty()) {
     auto logger = getLogger();
-    if (logger) {
-      logger->trace("Testing condition syntax: {}", condition_);
-    }
+    LOOT_LOG_TRACE(logger, "Testing condition syntax: {}", condition_);
     ConditionEvaluator().evaluate(condition_);
   }
 }
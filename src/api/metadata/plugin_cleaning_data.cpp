@@ -79,9 +79,7 @@ std::vector<MessageContent> PluginCleaningData::GetInfo() const {
 MessageContent PluginCleaningData::ChooseInfo(
     const std::string& language) const {
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Choosing dirty info content.");
-  }
+  LOOT_LOG_TRACE(logger, "Choosing dirty info content.");
   return MessageContent::Choose(info_, language);
 }
 }
@@ -32,6 +32,7 @@
 
 #include "api/game/game.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
 
 using std::inserter;
 using std::regex;
@@ -52,9 +53,7 @@ PluginMetadata::PluginMetadata(const std::string& n) :
 
 void PluginMetadata::MergeMetadata(const PluginMetadata& plugin) {
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Merging metadata for: {}", name_);
-  }
+  LOOT_LOG_TRACE(logger, "Merging metadata for: {}", name_);
 
   if (plugin.HasNameOnly())
     return;
@@ -100,9 +99,7 @@ PluginMetadata PluginMetadata::NewMetadata(const PluginMetadata& plugin) const {
   using std::set_difference;
 
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Comparing new metadata for: {}", name_);
-  }
+  LOOT_LOG_TRACE(logger, "Comparing new metadata for: {}", name_);
 
   PluginMetadata p(*this);
 
@@ -284,6 +281,7 @@ bool PluginMetadata::operator==(const PluginMetadata& rhs) const {
   if (IsRegexPlugin() == rhs.IsRegexPlugin())
     return boost::iequals(name_, rhs.GetName());
 
+  IncrementStatistic(Statistic::regexCompilations);
   if (IsRegexPlugin())
     return regex_match(rhs.GetName(),
                        regex(name_, regex::ECMAScript | regex::icase));
@@ -297,11 +295,12 @@ bool PluginMetadata::operator!=(const PluginMetadata& rhs) const {
 }
 
 bool PluginMetadata::operator==(const std::string& rhs) const {
-  if (IsRegexPlugin())
-    return regex_match(PluginMetadata(rhs).GetName(),
-                       regex(name_, regex::ECMAScript | regex::icase));
-  else
+  if (!IsRegexPlugin())
     return boost::iequals(name_, PluginMetadata(rhs).GetName());
+
+  IncrementStatistic(Statistic::regexCompilations);
+  return regex_match(PluginMetadata(rhs).GetName(),
+                     regex(name_, regex::ECMAScript | regex::icase));
 }
 
 bool PluginMetadata::operator!=(const std::string& rhs) const {
@@ -29,18 +29,23 @@
 
 #include "api/game/game.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/memory_accounting.h"
+#include "api/helpers/statistics.h"
+#include "api/helpers/tracing.h"
+#include "api/metadata/binary_metadata.h"
 #include "api/metadata/condition_evaluator.h"
 #include "api/metadata/yaml/plugin_metadata.h"
 #include "loot/exception/file_access_error.h"
 
 namespace loot {
 void MetadataList::Load(const boost::filesystem::path& filepath) {
+  TraceScope scope("LoadMetadataList", "yaml", filepath.string());
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
   Clear();
 
   auto logger = getLogger();
-  if (logger) {
-    logger->debug("Loading file: {}", filepath.string());
-  }
+  LOOT_LOG_DEBUG(logger, "Loading file: {}", filepath.string());
 
   boost::filesystem::ifstream in(filepath);
   if (!in.good())
@@ -49,8 +54,24 @@ void MetadataList::Load(const boost::filesystem::path& filepath) {
   YAML::Node metadataList = YAML::Load(in);
   in.close();
 
+  Load(metadataList, filepath.string());
+
+  LOOT_LOG_DEBUG(logger, "File loaded successfully.");
+}
+
+void MetadataList::LoadFromString(const std::string& yaml) {
+  TraceScope scope("LoadMetadataListFromString", "yaml");
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
+  Clear();
+
+  Load(YAML::Load(yaml), "string");
+}
+
+void MetadataList::Load(const YAML::Node& metadataList,
+                        const std::string& source) {
   if (!metadataList.IsMap())
-    throw FileAccessError("The root of the metadata file " + filepath.string() +
+    throw FileAccessError("The root of the metadata file " + source +
                           " is not a YAML map.");
 
   if (metadataList["plugins"]) {
@@ -68,17 +89,13 @@ void MetadataList::Load(const boost::filesystem::path& filepath) {
 
   if (metadataList["bash_tags"])
     bashTags_ = metadataList["bash_tags"].as<std::set<std::string>>();
-
-  if (logger) {
-    logger->debug("File loaded successfully.");
-  }
 }
 
 void MetadataList::Save(const boost::filesystem::path& filepath) const {
+  TraceScope scope("SaveMetadataList", "yaml", filepath.string());
+
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Saving metadata list to: {}", filepath.string());
-  }
+  LOOT_LOG_TRACE(logger, "Saving metadata list to: {}", filepath.string());
   YAML::Emitter emitter;
   emitter.SetIndent(2);
   emitter << YAML::BeginMap;
@@ -107,6 +124,76 @@ void MetadataList::Save(const boost::filesystem::path& filepath) const {
   out.close();
 }
 
+namespace {
+template<typename Container>
+void WritePlugins(BinaryWriter& writer, const Container& plugins) {
+  writer.Write(static_cast<uint32_t>(plugins.size()));
+  for (const auto& plugin : plugins) {
+    WriteMetadata(writer, plugin);
+  }
+}
+
+void WriteMessages(BinaryWriter& writer, const std::vector<Message>& messages) {
+  writer.Write(static_cast<uint32_t>(messages.size()));
+  for (const auto& message : messages) {
+    WriteMetadata(writer, message);
+  }
+}
+
+template<typename Container>
+void ReadPlugins(BinaryReader& reader, Container& plugins) {
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    plugins.insert(plugins.end(), ReadPluginMetadata(reader));
+  }
+}
+
+void ReadMessages(BinaryReader& reader, std::vector<Message>& messages) {
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    messages.push_back(ReadMessage(reader));
+  }
+}
+}
+
+void MetadataList::Write(BinaryWriter& writer) const {
+  writer.Write(static_cast<uint32_t>(bashTags_.size()));
+  for (const auto& tag : bashTags_) {
+    writer.Write(tag);
+  }
+
+  // Only the metadata as loaded is written, because condition results may have
+  // changed by the time the snapshot is restored. The unevaluated containers
+  // are only empty if conditions haven't been evaluated or there's nothing to
+  // evaluate.
+  WritePlugins(writer,
+               unevaluatedPlugins_.empty() ? plugins_ : unevaluatedPlugins_);
+  WritePlugins(writer,
+               unevaluatedRegexPlugins_.empty() ? regexPlugins_
+                                                : unevaluatedRegexPlugins_);
+  WriteMessages(writer,
+                unevaluatedMessages_.empty() ? messages_
+                                             : unevaluatedMessages_);
+}
+
+void MetadataList::Read(BinaryReader& reader) {
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
+  Clear();
+  unevaluatedPlugins_.clear();
+  unevaluatedRegexPlugins_.clear();
+  unevaluatedMessages_.clear();
+
+  uint32_t count = reader.Read<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    bashTags_.insert(reader.Read<std::string>());
+  }
+
+  ReadPlugins(reader, plugins_);
+  ReadPlugins(reader, regexPlugins_);
+  ReadMessages(reader, messages_);
+}
+
 void MetadataList::Clear() {
   bashTags_.clear();
   plugins_.clear();
@@ -129,6 +216,8 @@ std::set<std::string> MetadataList::BashTags() const { return bashTags_; }
 
 // Merges multiple matching regex entries if any are found.
 PluginMetadata MetadataList::FindPlugin(const PluginMetadata& plugin) const {
+  IncrementStatistic(Statistic::metadataLookups);
+
   PluginMetadata match(plugin.GetName());
 
   auto it = plugins_.find(plugin);
@@ -175,6 +264,9 @@ void MetadataList::AppendMessage(const Message& message) {
 
 void MetadataList::EvalAllConditions(
     const ConditionEvaluator& conditionEvaluator) {
+  TraceScope scope("EvalAllConditions", "conditions");
+  MemoryScope memoryScope(MemorySubsystem::metadataLists);
+
   if (unevaluatedPlugins_.empty())
     unevaluatedPlugins_.swap(plugins_);
   else
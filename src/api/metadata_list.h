@@ -30,7 +30,9 @@
 #include <vector>
 
 #include <boost/filesystem.hpp>
+#include <yaml-cpp/yaml.h>
 
+#include "api/helpers/binary_stream.h"
 #include "api/metadata/condition_evaluator.h"
 #include "loot/metadata/plugin_metadata.h"
 
@@ -38,9 +40,18 @@ namespace loot {
 class MetadataList {
 public:
   void Load(const boost::filesystem::path& filepath);
+  // Loads metadata from YAML that has already been read into memory, eg. from
+  // a Git blob.
+  void LoadFromString(const std::string& yaml);
   void Save(const boost::filesystem::path& filepath) const;
   void Clear();
 
+  // Writes and reads the list in a binary form for game handle snapshots,
+  // which is much quicker to read than YAML. Evaluated conditions aren't kept,
+  // so a list that is read back holds its metadata as it was loaded.
+  void Write(BinaryWriter& writer) const;
+  void Read(BinaryReader& reader);
+
   std::list<PluginMetadata> Plugins() const;
   std::vector<Message> Messages() const;
   std::set<std::string> BashTags() const;
@@ -59,6 +70,8 @@ public:
   void EvalAllConditions(const ConditionEvaluator& conditionEvaluator);
 
 protected:
+  void Load(const YAML::Node& metadataList, const std::string& source);
+
   std::set<std::string> bashTags_;
   std::unordered_set<PluginMetadata> plugins_;
   std::list<PluginMetadata> regexPlugins_;
@@ -34,6 +34,7 @@
 #include "api/game/game.h"
 #include "api/helpers/crc.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
 #include "api/helpers/version.h"
 #include "loot/exception/file_access_error.h"
 
@@ -41,83 +42,55 @@ using std::set;
 using std::string;
 
 namespace loot {
+namespace {
+void ThrowIfError(int returnCode, const std::string& pluginName) {
+  if (returnCode != ESP_OK) {
+    throw FileAccessError(pluginName + " : Libespm error code: " +
+                          std::to_string(returnCode));
+  }
+}
+}
+
 Plugin::Plugin(const GameType gameType,
                const boost::filesystem::path& dataPath,
                std::shared_ptr<LoadOrderHandler> loadOrderHandler,
                const std::string& name,
                const bool headerOnly) :
     name_(name),
-    esPlugin(nullptr),
     isEmpty_(true),
+    isMaster_(false),
+    isLightMaster_(false),
     isActive_(false),
     loadsArchive_(false),
     crc_(0),
-    numOverrideRecords_(0) {
+    numOverrideRecords_(0),
+    gameType_(gameType),
+    isHeaderOnly_(headerOnly),
+    esPluginMutex_(std::make_shared<std::mutex>()),
+    esPlugin(nullptr) {
   auto logger = getLogger();
 
   try {
-    boost::filesystem::path filepath = dataPath / name_;
-
-    // In case the plugin is ghosted.
-    if (!boost::filesystem::exists(filepath) &&
-        boost::filesystem::exists(filepath.string() + ".ghost"))
-      filepath += ".ghost";
-
-    Load(filepath, gameType, headerOnly);
-
-    auto ret = esp_plugin_is_empty(esPlugin.get(), &isEmpty_);
-    if (ret != ESP_OK) {
-      throw FileAccessError(name +
-                            " : Libespm error code: " + std::to_string(ret));
-    }
-
-    if (!headerOnly) {
-      if (logger) {
-        logger->trace("{}: Caching CRC value.", name_);
-      }
-      crc_ = GetCrc32(filepath);
-
-      if (logger) {
-        logger->trace("{}: Counting override FormIDs.", name_);
-      }
-      ret = esp_plugin_count_override_records(esPlugin.get(),
-                                              &numOverrideRecords_);
-      if (ret != ESP_OK) {
-        throw FileAccessError(name +
-                              " : Libespm error code: " + std::to_string(ret));
-      }
-    }
-
-    // Also read Bash Tags applied and version string in description.
-    if (logger) {
-      logger->trace("{}: Attempting to extract Bash Tags from the description.",
-                    name_);
+    path_ = GetPath(name_, dataPath);
+
+    // The file's size and modification time are read before it is, so that
+    // a change while it's being read doesn't go unnoticed.
+    fileKey_ = PluginFileKey::Get(gameType, path_);
+
+    auto sharedCache = getSharedPluginCache();
+    SharedPluginRecord record;
+    if (sharedCache && sharedCache->Find(fileKey_, headerOnly, record)) {
+      LOOT_LOG_TRACE(
+          logger, "{}: Read plugin from the shared plugin cache.", name_);
+    } else {
+      esPlugin = Load(path_, gameType, headerOnly);
+      record = Read(name_, path_, esPlugin, headerOnly);
+
+      if (sharedCache)
+        sharedCache->Store(fileKey_, record);
     }
 
-    string text = GetDescription();
-    size_t pos1 = text.find("{{BASH:");
-    if (pos1 != string::npos && pos1 + 7 != text.length()) {
-      pos1 += 7;
-
-      size_t pos2 = text.find("}}", pos1);
-      if (pos2 != string::npos && pos1 != pos2) {
-        text = text.substr(pos1, pos2 - pos1);
-
-        std::vector<string> bashTags;
-        boost::split(bashTags, text, [](char c) { return c == ','; });
-
-        for (auto& tag : bashTags) {
-          boost::trim(tag);
-          tags_.insert(Tag(tag));
-
-          if (logger) {
-            logger->trace("{}: Extracted Bash Tag: {}", name_, tag);
-          }
-        }
-      }
-    }
-    // Get whether the plugin is active or not.
-    isActive_ = loadOrderHandler->IsPluginActive(name_);
+    Init(record, *loadOrderHandler);
 
     loadsArchive_ = LoadsArchive(name_, gameType, dataPath);
   } catch (std::exception& e) {
@@ -130,9 +103,30 @@ Plugin::Plugin(const GameType gameType,
             .str());
   }
 
-  if (logger) {
-    logger->trace("{}: Plugin loading complete.", name_);
-  }
+  LOOT_LOG_TRACE(logger, "{}: Plugin loading complete.", name_);
+}
+
+Plugin::Plugin(const GameType gameType,
+               std::shared_ptr<LoadOrderHandler> loadOrderHandler,
+               const std::string& name,
+               const PluginFileKey& fileKey,
+               const SharedPluginRecord& record,
+               const bool loadsArchive) :
+    name_(name),
+    isEmpty_(true),
+    isMaster_(false),
+    isLightMaster_(false),
+    isActive_(false),
+    loadsArchive_(loadsArchive),
+    crc_(0),
+    numOverrideRecords_(0),
+    gameType_(gameType),
+    path_(fileKey.path),
+    fileKey_(fileKey),
+    isHeaderOnly_(record.isHeaderOnly),
+    esPluginMutex_(std::make_shared<std::mutex>()),
+    esPlugin(nullptr) {
+  Init(record, *loadOrderHandler);
 }
 
 std::string Plugin::GetName() const { return name_; }
@@ -142,49 +136,18 @@ std::string Plugin::GetLowercasedName() const {
 }
 
 std::string Plugin::GetVersion() const {
-  return Version(GetDescription()).AsString();
+  return Version(description_).AsString();
 }
 
-std::vector<std::string> Plugin::GetMasters() const {
-  char** masters;
-  uint8_t numMasters;
-  auto ret = esp_plugin_masters(esPlugin.get(), &masters, &numMasters);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : Libespm error code: " + std::to_string(ret));
-  }
-
-  std::vector<std::string> mastersVec(masters, masters + numMasters);
-  esp_string_array_free(masters, numMasters);
-
-  return mastersVec;
-}
+std::vector<std::string> Plugin::GetMasters() const { return masters_; }
 
 std::set<Tag> Plugin::GetBashTags() const { return tags_; }
 
 uint32_t Plugin::GetCRC() const { return crc_; }
 
-bool Plugin::IsMaster() const {
-  bool isMaster;
-  auto ret = esp_plugin_is_master(esPlugin.get(), &isMaster);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : Libespm error code: " + std::to_string(ret));
-  }
+bool Plugin::IsMaster() const { return isMaster_; }
 
-  return isMaster;
-}
-
-bool Plugin::IsLightMaster() const {
-  bool isLightMaster;
-  auto ret = esp_plugin_is_light_master(esPlugin.get(), &isLightMaster);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : Libespm error code: " + std::to_string(ret));
-  }
-
-  return isLightMaster;
-}
+bool Plugin::IsLightMaster() const { return isLightMaster_; }
 
 bool Plugin::IsEmpty() const { return isEmpty_; }
 
@@ -192,15 +155,15 @@ bool Plugin::LoadsArchive() const { return loadsArchive_; }
 
 bool Plugin::DoFormIDsOverlap(const PluginInterface& plugin) const {
   try {
-    auto otherPlugin = dynamic_cast<const Plugin&>(plugin);
+    const auto& otherPlugin = dynamic_cast<const Plugin&>(plugin);
+    auto ownEsplugin = GetEsplugin();
+    auto otherEsplugin = otherPlugin.GetEsplugin();
 
     bool doPluginsOverlap;
+    IncrementStatistic(Statistic::espluginCalls);
     auto ret = esp_plugin_do_records_overlap(
-        esPlugin.get(), otherPlugin.esPlugin.get(), &doPluginsOverlap);
-    if (ret != ESP_OK) {
-      throw FileAccessError(name_ +
-                            " : Libespm error code: " + std::to_string(ret));
-    }
+        ownEsplugin.get(), otherEsplugin.get(), &doPluginsOverlap);
+    ThrowIfError(ret, name_);
 
     return doPluginsOverlap;
   } catch (std::bad_cast&) {
@@ -217,13 +180,28 @@ bool Plugin::DoFormIDsOverlap(const PluginInterface& plugin) const {
 
 size_t Plugin::NumOverrideFormIDs() const { return numOverrideRecords_; }
 
+const PluginFileKey& Plugin::GetFileKey() const { return fileKey_; }
+
+SharedPluginRecord Plugin::GetRecord() const {
+  SharedPluginRecord record;
+  record.isHeaderOnly = isHeaderOnly_;
+  record.isEmpty = isEmpty_;
+  record.isMaster = isMaster_;
+  record.isLightMaster = isLightMaster_;
+  record.crc = crc_;
+  record.numOverrideRecords = numOverrideRecords_;
+  record.description = description_;
+  record.masters = masters_;
+
+  return record;
+}
+
 bool Plugin::IsValid(const std::string& filename,
                      const GameType gameType,
                      const boost::filesystem::path& dataPath) {
   auto logger = getLogger();
-  if (logger) {
-    logger->trace("Checking to see if \"{}\" is a valid plugin.", filename);
-  }
+  LOOT_LOG_TRACE(
+      logger, "Checking to see if \"{}\" is a valid plugin.", filename);
 
   // If the filename passed ends in '.ghost', that should be trimmed.
   std::string name;
@@ -238,6 +216,7 @@ bool Plugin::IsValid(const std::string& filename,
 
   bool isValid;
   auto path = dataPath / filename;
+  IncrementStatistic(Statistic::espluginCalls);
   int ret = esp_plugin_is_valid(
       GetEspluginGameId(gameType), path.string().c_str(), true, &isValid);
 
@@ -253,11 +232,18 @@ bool Plugin::IsValid(const std::string& filename,
 
 uintmax_t Plugin::GetFileSize(const std::string& filename,
                               const boost::filesystem::path& dataPath) {
-  boost::filesystem::path realPath = dataPath / filename;
-  if (!boost::filesystem::exists(realPath))
-    realPath += ".ghost";
+  return boost::filesystem::file_size(GetPath(filename, dataPath));
+}
+
+boost::filesystem::path Plugin::GetPath(
+    const std::string& filename,
+    const boost::filesystem::path& dataPath) {
+  boost::filesystem::path path = dataPath / filename;
+  if (!boost::filesystem::exists(path) &&
+      boost::filesystem::exists(path.string() + ".ghost"))
+    path += ".ghost";
 
-  return boost::filesystem::file_size(realPath);
+  return path;
 }
 
 bool Plugin::operator<(const Plugin& rhs) const {
@@ -267,42 +253,131 @@ bool Plugin::operator<(const Plugin& rhs) const {
 
 bool Plugin::IsActive() const { return isActive_; }
 
-void Plugin::Load(const boost::filesystem::path& path,
-                  GameType gameType,
-                  bool headerOnly) {
+Plugin::EspluginPtr Plugin::Load(const boost::filesystem::path& path,
+                                 GameType gameType,
+                                 bool headerOnly) {
   ::Plugin* plugin;
+  IncrementStatistic(Statistic::espluginCalls);
   int ret = esp_plugin_new(
       &plugin, GetEspluginGameId(gameType), path.string().c_str());
-  if (ret != ESP_OK) {
-    throw FileAccessError(path.string() +
-                          " : Libespm error code: " + std::to_string(ret));
-  }
+  ThrowIfError(ret, path.string());
 
-  esPlugin = std::shared_ptr<std::remove_pointer<::Plugin>::type>(
-      plugin, esp_plugin_free);
+  EspluginPtr esPlugin(plugin, esp_plugin_free);
 
+  IncrementStatistic(Statistic::espluginCalls);
   ret = esp_plugin_parse(esPlugin.get(), headerOnly);
-  if (ret != ESP_OK) {
-    throw FileAccessError(path.string() +
-                          " : Libespm error code: " + std::to_string(ret));
-  }
+  ThrowIfError(ret, path.string());
+
+  IncrementStatistic(Statistic::pluginsParsed);
+  if (!headerOnly)
+    IncrementStatistic(Statistic::bytesRead,
+                       boost::filesystem::file_size(path));
+
+  return esPlugin;
 }
 
-std::string Plugin::GetDescription() const {
+SharedPluginRecord Plugin::Read(const std::string& name,
+                                const boost::filesystem::path& path,
+                                const EspluginPtr& esPlugin,
+                                bool headerOnly) {
+  auto logger = getLogger();
+  SharedPluginRecord record;
+  record.isHeaderOnly = headerOnly;
+
+  IncrementStatistic(Statistic::espluginCalls);
+  ThrowIfError(esp_plugin_is_empty(esPlugin.get(), &record.isEmpty), name);
+
+  IncrementStatistic(Statistic::espluginCalls);
+  ThrowIfError(esp_plugin_is_master(esPlugin.get(), &record.isMaster), name);
+
+  IncrementStatistic(Statistic::espluginCalls);
+  ThrowIfError(
+      esp_plugin_is_light_master(esPlugin.get(), &record.isLightMaster), name);
+
+  char** masters;
+  uint8_t numMasters;
+  IncrementStatistic(Statistic::espluginCalls);
+  ThrowIfError(esp_plugin_masters(esPlugin.get(), &masters, &numMasters),
+               name);
+  record.masters.assign(masters, masters + numMasters);
+  esp_string_array_free(masters, numMasters);
+
   char* description;
-  auto ret = esp_plugin_description(esPlugin.get(), &description);
-  if (ret != ESP_OK) {
-    throw FileAccessError(name_ +
-                          " : Libespm error code: " + std::to_string(ret));
+  IncrementStatistic(Statistic::espluginCalls);
+  ThrowIfError(esp_plugin_description(esPlugin.get(), &description), name);
+  if (description != nullptr) {
+    record.description = description;
+    esp_string_free(description);
   }
-  if (description == nullptr) {
-    return "";
+
+  if (!headerOnly) {
+    LOOT_LOG_TRACE(logger, "{}: Caching CRC value.", name);
+    record.crc = GetCrc32(path);
+
+    LOOT_LOG_TRACE(logger, "{}: Counting override FormIDs.", name);
+    IncrementStatistic(Statistic::espluginCalls);
+    ThrowIfError(esp_plugin_count_override_records(
+                     esPlugin.get(), &record.numOverrideRecords),
+                 name);
   }
 
-  string descriptionStr = description;
-  esp_string_free(description);
+  return record;
+}
+
+Plugin::EspluginPtr Plugin::GetEsplugin() const {
+  std::lock_guard<std::mutex> guard(*esPluginMutex_);
+
+  if (!esPlugin) {
+    auto logger = getLogger();
+    LOOT_LOG_TRACE(logger,
+                   "{}: Parsing plugin read from the shared plugin cache.",
+                   name_);
+    esPlugin = Load(path_, gameType_, isHeaderOnly_);
+  }
+
+  return esPlugin;
+}
+
+void Plugin::Init(const SharedPluginRecord& record,
+                  const LoadOrderHandler& loadOrderHandler) {
+  auto logger = getLogger();
+
+  isEmpty_ = record.isEmpty;
+  isMaster_ = record.isMaster;
+  isLightMaster_ = record.isLightMaster;
+  description_ = record.description;
+  masters_ = record.masters;
+  crc_ = record.crc;
+  numOverrideRecords_ = record.numOverrideRecords;
+
+  // Also read Bash Tags applied and version string in description.
+  LOOT_LOG_TRACE(logger,
+                 "{}: Attempting to extract Bash Tags from the description.",
+                 name_);
+
+  string text = description_;
+  size_t pos1 = text.find("{{BASH:");
+  if (pos1 != string::npos && pos1 + 7 != text.length()) {
+    pos1 += 7;
+
+    size_t pos2 = text.find("}}", pos1);
+    if (pos2 != string::npos && pos1 != pos2) {
+      text = text.substr(pos1, pos2 - pos1);
+
+      std::vector<string> bashTags;
+      boost::split(bashTags, text, [](char c) { return c == ','; });
+
+      for (auto& tag : bashTags) {
+        boost::trim(tag);
+        tags_.insert(Tag(tag));
+
+        LOOT_LOG_TRACE(logger, "{}: Extracted Bash Tag: {}", name_, tag);
+      }
+    }
+  }
 
-  return descriptionStr;
+  // Get whether the plugin is active or not.
+  isActive_ = loadOrderHandler.IsPluginActive(name_);
 }
 
 std::string Plugin::GetArchiveFileExtension(const GameType gameType) {
@@ -26,6 +26,8 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <type_traits>
@@ -35,6 +37,7 @@
 #include <esplugin.hpp>
 
 #include "api/game/load_order_handler.h"
+#include "api/plugin/shared_plugin_cache.h"
 #include "loot/enum/game_type.h"
 #include "loot/metadata/plugin_metadata.h"
 #include "loot/plugin_interface.h"
@@ -48,6 +51,15 @@ public:
          const std::string& name,
          const bool headerOnly);
 
+  // Creates a plugin from a record that was read from it earlier, without
+  // reading the plugin file.
+  Plugin(const GameType gameType,
+         std::shared_ptr<LoadOrderHandler> loadOrderHandler,
+         const std::string& name,
+         const PluginFileKey& fileKey,
+         const SharedPluginRecord& record,
+         const bool loadsArchive);
+
   std::string GetName() const;
   std::string GetLowercasedName() const;
   std::string GetVersion() const;
@@ -66,40 +78,69 @@ public:
   // Load ordering functions.
   size_t NumOverrideFormIDs() const;
 
+  // The file's identity when the plugin was loaded, and the data read from
+  // it.
+  const PluginFileKey& GetFileKey() const;
+  SharedPluginRecord GetRecord() const;
+
   // Validity checks.
   static bool IsValid(const std::string& filename,
                       const GameType gameType,
                       const boost::filesystem::path& dataPath);
   static uintmax_t GetFileSize(const std::string& filename,
                                const boost::filesystem::path& dataPath);
+  // Returns the path of the plugin's .ghost file if the plugin is ghosted.
+  static boost::filesystem::path GetPath(
+      const std::string& filename,
+      const boost::filesystem::path& dataPath);
+  static bool LoadsArchive(const std::string& pluginName,
+                           const GameType gameType,
+                           const boost::filesystem::path& dataPath);
 
   bool operator<(const Plugin& rhs) const;
 
 private:
-  void Load(const boost::filesystem::path& path,
-            GameType gameType,
-            bool headerOnly);
-  std::string GetDescription() const;
+  typedef std::shared_ptr<std::remove_pointer<::Plugin>::type> EspluginPtr;
+
+  static EspluginPtr Load(const boost::filesystem::path& path,
+                          GameType gameType,
+                          bool headerOnly);
+  static SharedPluginRecord Read(const std::string& name,
+                                 const boost::filesystem::path& path,
+                                 const EspluginPtr& esPlugin,
+                                 bool headerOnly);
+
+  // Plugins read from the shared plugin cache aren't parsed until their
+  // records are needed.
+  EspluginPtr GetEsplugin() const;
+
+  void Init(const SharedPluginRecord& record,
+            const LoadOrderHandler& loadOrderHandler);
 
   static std::string GetArchiveFileExtension(const GameType gameType);
-  static bool LoadsArchive(const std::string& pluginName,
-                           const GameType gameType,
-                           const boost::filesystem::path& dataPath);
   static unsigned int GetEspluginGameId(GameType gameType);
 
   bool isEmpty_;  // Does the plugin contain any records other than the TES4
                   // header?
+  bool isMaster_;
+  bool isLightMaster_;
   bool isActive_;
   bool loadsArchive_;
   const std::string name_;
-  std::string version_;  // Obtained from description field.
+  std::string description_;
+  std::vector<std::string> masters_;
   uint32_t crc_;
   std::set<Tag> tags_;
 
   // Useful caches.
   size_t numOverrideRecords_;
 
-  std::shared_ptr<std::remove_pointer<::Plugin>::type> esPlugin;
+  GameType gameType_;
+  boost::filesystem::path path_;
+  PluginFileKey fileKey_;
+  bool isHeaderOnly_;
+  std::shared_ptr<std::mutex> esPluginMutex_;
+  mutable EspluginPtr esPlugin;
 };
 
 bool hasPluginFileExtension(const std::string& filename, GameType gameType);
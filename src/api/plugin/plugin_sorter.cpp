@@ -34,6 +34,7 @@
 
 #include "api/game/game.h"
 #include "api/helpers/logging.h"
+#include "api/helpers/tracing.h"
 #include "api/metadata/condition_evaluator.h"
 #include "loot/exception/cyclic_interaction_error.h"
 
@@ -131,7 +132,6 @@ std::vector<std::string> PluginSorter::Sort(Game& game) {
   // Clear existing data.
   graph_.clear();
   indexMap_.clear();
-  oldLoadOrder_.clear();
 
   AddPluginVertices(game);
 
@@ -140,11 +140,17 @@ std::vector<std::string> PluginSorter::Sort(Game& game) {
   if (boost::num_vertices(graph_) == 0)
     return vector<std::string>();
 
-  // Get the existing load order.
-  oldLoadOrder_ = game.GetLoadOrder();
+  // Get the existing load order. Take one copy of it so that the tie-break
+  // edges are all decided by the same load order, and so that looking up a
+  // plugin's position doesn't go through the load order handler each time.
+  const auto loadOrder = game.GetLoadOrderHandler()->GetLoadOrder();
+  loadOrderIndices_.clear();
+  for (size_t i = 0; i < loadOrder.size(); ++i) {
+    loadOrderIndices_.emplace(boost::locale::to_lower(loadOrder[i]), i);
+  }
   if (logger_) {
     logger_->info("Fetched existing load order: ");
-    for (const auto& plugin : oldLoadOrder_) {
+    for (const auto& plugin : loadOrder) {
       logger_->info("\t\t{}", plugin);
     }
   }
@@ -152,40 +158,33 @@ std::vector<std::string> PluginSorter::Sort(Game& game) {
   // Now add the interactions between plugins to the graph as edges.
   if (logger_) {
     logger_->info("Adding edges to plugin graph.");
-    logger_->debug("Adding non-overlap edges.");
   }
+  LOOT_LOG_DEBUG(logger_, "Adding non-overlap edges.");
   AddSpecificEdges();
 
   PropagatePriorities();
 
-  if (logger_) {
-    logger_->debug("Adding priority edges.");
-  }
+  LOOT_LOG_DEBUG(logger_, "Adding priority edges.");
   AddPriorityEdges();
 
-  if (logger_) {
-    logger_->debug("Adding overlap edges.");
-  }
+  LOOT_LOG_DEBUG(logger_, "Adding overlap edges.");
   AddOverlapEdges();
 
-  if (logger_) {
-    logger_->debug("Adding tie-break edges.");
-  }
+  LOOT_LOG_DEBUG(logger_, "Adding tie-break edges.");
   AddTieBreakEdges();
 
-  if (logger_) {
-    logger_->debug("Checking to see if the graph is cyclic.");
-  }
+  LOOT_LOG_DEBUG(logger_, "Checking to see if the graph is cyclic.");
   CheckForCycles();
 
   // Now we can sort.
-  if (logger_) {
-    logger_->debug("Performing a topological sort.");
-  }
+  LOOT_LOG_DEBUG(logger_, "Performing a topological sort.");
   list<vertex_t> sortedVertices;
-  boost::topological_sort(graph_,
-                          std::front_inserter(sortedVertices),
-                          boost::vertex_index_map(vertexIndexMap_));
+  {
+    TraceScope scope("TopologicalSort", "sorting");
+    boost::topological_sort(graph_,
+                            std::front_inserter(sortedVertices),
+                            boost::vertex_index_map(vertexIndexMap_));
+  }
 
   // Check that the sorted path is Hamiltonian (ie. unique).
   for (auto it = sortedVertices.begin(); it != sortedVertices.end(); ++it) {
@@ -214,7 +213,30 @@ std::vector<std::string> PluginSorter::Sort(Game& game) {
   return plugins;
 }
 
+SortGraph PluginSorter::GetSortGraph() const {
+  TraceScope scope("GetSortGraph", "sorting");
+
+  std::vector<std::string> plugins;
+  std::map<vertex_t, uint32_t> indices;
+  BGL_FORALL_VERTICES(vertex, graph_, PluginGraph) {
+    indices.emplace(vertex, static_cast<uint32_t>(plugins.size()));
+    plugins.push_back(graph_[vertex].GetName());
+  }
+
+  std::vector<SortGraph::Edge> sortGraphEdges;
+  sortGraphEdges.reserve(boost::num_edges(graph_));
+  BGL_FORALL_EDGES(edge, graph_, PluginGraph) {
+    sortGraphEdges.push_back({indices.at(boost::source(edge, graph_)),
+                              indices.at(boost::target(edge, graph_)),
+                              graph_[edge]});
+  }
+
+  return SortGraph(plugins, sortGraphEdges);
+}
+
 void PluginSorter::AddPluginVertices(Game& game) {
+  TraceScope scope("AddPluginVertices", "sorting");
+
   if (logger_) {
     logger_->info(
         "Merging masterlist, userlist into plugin list, evaluating conditions "
@@ -243,18 +265,16 @@ void PluginSorter::AddPluginVertices(Game& game) {
   // in the unordered map, as it's probably faster than copying the
   // full plugin objects then sorting them.
   for (const auto& plugin : game.GetCache()->GetPlugins()) {
-    if (logger_) {
-      logger_->trace("Getting and evaluating metadata for plugin {}",
-                     plugin->GetName());
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Getting and evaluating metadata for plugin {}",
+                   plugin->GetName());
 
     auto metadata =
         game.GetDatabase()->GetPluginMetadata(plugin->GetName(), true, true);
 
-    if (logger_) {
-      logger_->trace("Getting and evaluating metadata for plugin \"{}\"",
-                     plugin->GetName());
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Getting and evaluating metadata for plugin \"{}\"",
+                   plugin->GetName());
 
     vertex_t v = boost::add_vertex(
         PluginSortingData(*plugin, std::move(metadata)), graph_);
@@ -281,6 +301,8 @@ bool PluginSorter::GetVertexByName(const std::string& name,
 }
 
 void PluginSorter::CheckForCycles() const {
+  TraceScope scope("CheckForCycles", "sorting");
+
   boost::depth_first_search(
       graph_, visitor(CycleDetector()).vertex_index_map(vertexIndexMap_));
 }
@@ -299,6 +321,8 @@ bool PluginSorter::EdgeCreatesCycle(const vertex_t& fromVertex,
 }
 
 void PluginSorter::PropagatePriorities() {
+  TraceScope scope("PropagatePriorities", "sorting");
+
   /* If a plugin has a priority value > 0, that value should be
      inherited by all plugins that have edges coming from that
      plugin, ie. those that load after it, unless the plugin being
@@ -336,13 +360,12 @@ void PluginSorter::PropagatePriorities() {
   // search, setting priorities until an equal or larger value is
   // encountered.
   for (const vertex_t& vertex : positivePriorityVertices) {
-    if (logger_) {
-      logger_->trace(
-          "Doing DFS for {} which has local priority {} and global priority {}",
-          graph_[vertex].GetName(),
-          graph_[vertex].GetLocalPriority().GetValue(),
-          graph_[vertex].GetGlobalPriority().GetValue());
-    }
+    LOOT_LOG_TRACE(
+        logger_,
+        "Doing DFS for {} which has local priority {} and global priority {}",
+        graph_[vertex].GetName(),
+        graph_[vertex].GetLocalPriority().GetValue(),
+        graph_[vertex].GetGlobalPriority().GetValue());
     boost::dfs_visitor<> visitor;
     boost::depth_first_visit(
         graph_,
@@ -354,12 +377,11 @@ void PluginSorter::PropagatePriorities() {
           // vertex.
           if (graph[currentVertex].GetLocalPriority() <
               graph[vertex].GetLocalPriority()) {
-            if (logger_) {
-              logger_->trace("Overriding local priority for {} from {} to {}",
-                             graph[currentVertex].GetName(),
-                             graph[currentVertex].GetLocalPriority().GetValue(),
-                             graph[vertex].GetLocalPriority().GetValue());
-            }
+            LOOT_LOG_TRACE(logger_,
+                           "Overriding local priority for {} from {} to {}",
+                           graph[currentVertex].GetName(),
+                           graph[currentVertex].GetLocalPriority().GetValue(),
+                           graph[vertex].GetLocalPriority().GetValue());
             const_cast<PluginGraph&>(graph)[currentVertex].SetLocalPriority(
                 graph[vertex].GetLocalPriority());
 
@@ -368,13 +390,11 @@ void PluginSorter::PropagatePriorities() {
 
           if (graph[currentVertex].GetGlobalPriority() <
               graph[vertex].GetGlobalPriority()) {
-            if (logger_) {
-              logger_->trace(
-                  "Overriding global priority for {} from {} to {}",
-                  graph[currentVertex].GetName(),
-                  graph[currentVertex].GetGlobalPriority().GetValue(),
-                  graph[vertex].GetGlobalPriority().GetValue());
-            }
+            LOOT_LOG_TRACE(logger_,
+                           "Overriding global priority for {} from {} to {}",
+                           graph[currentVertex].GetName(),
+                           graph[currentVertex].GetGlobalPriority().GetValue(),
+                           graph[vertex].GetGlobalPriority().GetValue());
             const_cast<PluginGraph&>(graph)[currentVertex].SetGlobalPriority(
                 graph[vertex].GetGlobalPriority());
 
@@ -391,28 +411,29 @@ void PluginSorter::PropagatePriorities() {
 }
 
 void PluginSorter::AddEdge(const vertex_t& fromVertex,
-                           const vertex_t& toVertex) {
+                           const vertex_t& toVertex,
+                           EdgeType type) {
   if (!boost::edge(fromVertex, toVertex, graph_).second) {
-    if (logger_) {
-      logger_->trace("Adding edge from \"{}\" to \"{}\".",
-                     graph_[fromVertex].GetName(),
-                     graph_[toVertex].GetName());
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Adding edge from \"{}\" to \"{}\".",
+                   graph_[fromVertex].GetName(),
+                   graph_[toVertex].GetName());
 
-    boost::add_edge(fromVertex, toVertex, graph_);
+    boost::add_edge(fromVertex, toVertex, type, graph_);
   }
 }
 
 void PluginSorter::AddSpecificEdges() {
+  TraceScope scope("AddSpecificEdges", "sorting");
+
   // Add edges for all relationships that aren't overlaps or priority
   // differences.
   vertex_it vit, vitend;
   for (tie(vit, vitend) = boost::vertices(graph_); vit != vitend; ++vit) {
-    if (logger_) {
-      logger_->trace("Adding specific edges to vertex for \"{}\".",
-                     graph_[*vit].GetName());
-      logger_->trace("Adding edges for master flag differences.");
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Adding specific edges to vertex for \"{}\".",
+                   graph_[*vit].GetName());
+    LOOT_LOG_TRACE(logger_, "Adding edges for master flag differences.");
 
     for (vertex_it vit2 = vit; vit2 != vitend; ++vit2) {
       if (graph_[*vit].IsMaster() == graph_[*vit2].IsMaster())
@@ -427,43 +448,38 @@ void PluginSorter::AddSpecificEdges() {
         vertex = *vit2;
       }
 
-      AddEdge(parentVertex, vertex);
+      AddEdge(parentVertex, vertex, EdgeType::masterFlag);
     }
 
     vertex_t parentVertex;
-    if (logger_) {
-      logger_->trace("Adding in-edges for masters.");
-    }
+    LOOT_LOG_TRACE(logger_, "Adding in-edges for masters.");
     for (const auto& master : graph_[*vit].GetMasters()) {
       if (GetVertexByName(master, parentVertex))
-        AddEdge(parentVertex, *vit);
+        AddEdge(parentVertex, *vit, EdgeType::master);
     }
 
-    if (logger_) {
-      logger_->trace("Adding in-edges for requirements.");
-    }
+    LOOT_LOG_TRACE(logger_, "Adding in-edges for requirements.");
     for (const auto& file : graph_[*vit].GetRequirements()) {
       if (GetVertexByName(file.GetName(), parentVertex))
-        AddEdge(parentVertex, *vit);
+        AddEdge(parentVertex, *vit, EdgeType::requirement);
     }
 
-    if (logger_) {
-      logger_->trace("Adding in-edges for 'load after's.");
-    }
+    LOOT_LOG_TRACE(logger_, "Adding in-edges for 'load after's.");
     for (const auto& file : graph_[*vit].GetLoadAfterFiles()) {
       if (GetVertexByName(file.GetName(), parentVertex))
-        AddEdge(parentVertex, *vit);
+        AddEdge(parentVertex, *vit, EdgeType::loadAfter);
     }
   }
 }
 
 void PluginSorter::AddPriorityEdges() {
+  TraceScope scope("AddPriorityEdges", "sorting");
+
   for (const auto& vertex :
        boost::make_iterator_range(boost::vertices(graph_))) {
-    if (logger_) {
-      logger_->trace("Adding priority difference edges to vertex for \"{}\".",
-                     graph_[vertex].GetName());
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Adding priority difference edges to vertex for \"{}\".",
+                   graph_[vertex].GetName());
     // If the plugin has a global priority of zero and doesn't load
     // an archive and has no override records, skip it. Plugins without
     // override records can only conflict with plugins that override
@@ -504,26 +520,26 @@ void PluginSorter::AddPriorityEdges() {
       }
 
       if (!EdgeCreatesCycle(fromVertex, toVertex))
-        AddEdge(fromVertex, toVertex);
+        AddEdge(fromVertex, toVertex, EdgeType::priority);
     }
   }
 }
 
 void PluginSorter::AddOverlapEdges() {
+  TraceScope scope("AddOverlapEdges", "sorting");
+
   for (const auto& vertex :
        boost::make_iterator_range(boost::vertices(graph_))) {
-    if (logger_) {
-      logger_->trace("Adding overlap edges to vertex for \"{}\".",
-                     graph_[vertex].GetName());
-    }
+    LOOT_LOG_TRACE(logger_,
+                   "Adding overlap edges to vertex for \"{}\".",
+                   graph_[vertex].GetName());
 
     if (graph_[vertex].NumOverrideFormIDs() == 0) {
-      if (logger_) {
-        logger_->trace(
-            "Skipping vertex for \"{}\": the plugin contains no override "
-            "records.",
-            graph_[vertex].GetName());
-      }
+      LOOT_LOG_TRACE(
+          logger_,
+          "Skipping vertex for \"{}\": the plugin contains no override "
+          "records.",
+          graph_[vertex].GetName());
       continue;
     }
 
@@ -549,23 +565,35 @@ void PluginSorter::AddOverlapEdges() {
       }
 
       if (!EdgeCreatesCycle(fromVertex, toVertex))
-        AddEdge(fromVertex, toVertex);
+        AddEdge(fromVertex, toVertex, EdgeType::overlap);
     }
   }
 }
 
-int PluginSorter::ComparePlugins(const std::string& plugin1,
-                                 const std::string& plugin2) const {
-  auto it1 = find(begin(oldLoadOrder_), end(oldLoadOrder_), plugin1);
-  auto it2 = find(begin(oldLoadOrder_), end(oldLoadOrder_), plugin2);
+PluginSorter::TieBreakKey PluginSorter::GetTieBreakKey(
+    const std::string& plugin) const {
+  const string lowercaseName = boost::locale::to_lower(plugin);
+
+  TieBreakKey key;
+  key.name = plugin;
+  key.lowercaseBasename =
+      lowercaseName.substr(0, lowercaseName.length() - 4);
+
+  auto it = loadOrderIndices_.find(lowercaseName);
+  key.isInLoadOrder = it != loadOrderIndices_.end();
+  key.loadOrderIndex = key.isInLoadOrder ? it->second : 0;
 
-  if (it1 != end(oldLoadOrder_) && it2 == end(oldLoadOrder_))
+  return key;
+}
+
+int PluginSorter::ComparePlugins(const TieBreakKey& plugin1,
+                                 const TieBreakKey& plugin2) {
+  if (plugin1.isInLoadOrder && !plugin2.isInLoadOrder)
     return -1;
-  else if (it1 == end(oldLoadOrder_) && it2 != end(oldLoadOrder_))
+  else if (!plugin1.isInLoadOrder && plugin2.isInLoadOrder)
     return 1;
-  else if (it1 != end(oldLoadOrder_) && it2 != end(oldLoadOrder_)) {
-    if (distance(begin(oldLoadOrder_), it1) <
-        distance(begin(oldLoadOrder_), it2))
+  else if (plugin1.isInLoadOrder && plugin2.isInLoadOrder) {
+    if (plugin1.loadOrderIndex < plugin2.loadOrderIndex)
       return -1;
     else
       return 1;
@@ -574,19 +602,14 @@ int PluginSorter::ComparePlugins(const std::string& plugin1,
     // comparison to get an ordering.
 
     // Compare plugin basenames.
-    string name1 = boost::locale::to_lower(plugin1);
-    name1 = name1.substr(0, name1.length() - 4);
-    string name2 = boost::locale::to_lower(plugin2);
-    name2 = name2.substr(0, name2.length() - 4);
-
-    if (name1 < name2)
+    if (plugin1.lowercaseBasename < plugin2.lowercaseBasename)
       return -1;
-    else if (name2 < name1)
+    else if (plugin2.lowercaseBasename < plugin1.lowercaseBasename)
       return 1;
     else {
       // Could be a .esp and .esm plugin with the same basename,
       // compare whole filenames.
-      if (plugin1 < plugin2)
+      if (plugin1.name < plugin2.name)
         return -1;
       else
         return 1;
@@ -596,16 +619,23 @@ int PluginSorter::ComparePlugins(const std::string& plugin1,
 }
 
 void PluginSorter::AddTieBreakEdges() {
+  TraceScope scope("AddTieBreakEdges", "sorting");
+
   // In order for the sort to be performed stably, there must be only one
   // possible result. This can be enforced by adding edges between all vertices
   // that aren't already linked. Use existing load order to decide the direction
   // of these edges.
+  std::map<vertex_t, TieBreakKey> keys;
   for (const auto& vertex :
        boost::make_iterator_range(boost::vertices(graph_))) {
-    if (logger_) {
-      logger_->trace("Adding tie-break edges to vertex for \"{}\"",
-                     graph_[vertex].GetName());
-    }
+    keys.emplace(vertex, GetTieBreakKey(graph_[vertex].GetName()));
+  }
+
+  for (const auto& vertex :
+       boost::make_iterator_range(boost::vertices(graph_))) {
+    LOOT_LOG_TRACE(logger_,
+                   "Adding tie-break edges to vertex for \"{}\"",
+                   graph_[vertex].GetName());
 
     for (const auto& otherVertex :
          boost::make_iterator_range(boost::vertices(graph_))) {
@@ -615,8 +645,7 @@ void PluginSorter::AddTieBreakEdges() {
         continue;
 
       vertex_t toVertex, fromVertex;
-      if (ComparePlugins(graph_[vertex].GetName(),
-                         graph_[otherVertex].GetName()) < 0) {
+      if (ComparePlugins(keys.at(vertex), keys.at(otherVertex)) < 0) {
         fromVertex = vertex;
         toVertex = otherVertex;
       } else {
@@ -625,7 +654,7 @@ void PluginSorter::AddTieBreakEdges() {
       }
 
       if (!EdgeCreatesCycle(fromVertex, toVertex))
-        AddEdge(fromVertex, toVertex);
+        AddEdge(fromVertex, toVertex, EdgeType::tieBreak);
     }
   }
 }
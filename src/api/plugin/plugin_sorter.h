@@ -26,6 +26,7 @@
 #define LOOT_API_PLUGIN_PLUGIN_SORTER
 
 #include <map>
+#include <unordered_map>
 
 #include <spdlog/spdlog.h>
 #include <boost/graph/adjacency_list.hpp>
@@ -33,6 +34,8 @@
 
 #include "api/game/game.h"
 #include "api/plugin/plugin.h"
+#include "api/plugin/sort_graph.h"
+#include "loot/enum/edge_type.h"
 
 namespace loot {
 class PluginSortingData : private PluginMetadata {
@@ -60,7 +63,8 @@ private:
 typedef boost::adjacency_list<boost::listS,
                               boost::listS,
                               boost::directedS,
-                              PluginSortingData>
+                              PluginSortingData,
+                              EdgeType>
     PluginGraph;
 typedef boost::graph_traits<PluginGraph>::vertex_descriptor vertex_t;
 typedef boost::associative_property_map<std::map<vertex_t, size_t>>
@@ -70,13 +74,27 @@ class PluginSorter {
 public:
   std::vector<std::string> Sort(Game& game);
 
+  // Returns a copy of the graph built by the last call to Sort(), which must
+  // be made before the sorted plugins are unloaded.
+  SortGraph GetSortGraph() const;
+
 private:
   bool GetVertexByName(const std::string& name, vertex_t& vertex) const;
   void CheckForCycles() const;
   bool EdgeCreatesCycle(const vertex_t& u, const vertex_t& v) const;
 
-  int ComparePlugins(const std::string& plugin1,
-                     const std::string& plugin2) const;
+  // The values that tie-break edges are ordered by, which are got once per
+  // plugin instead of for every pair of plugins.
+  struct TieBreakKey {
+    bool isInLoadOrder;
+    size_t loadOrderIndex;
+    std::string lowercaseBasename;
+    std::string name;
+  };
+
+  TieBreakKey GetTieBreakKey(const std::string& plugin) const;
+  static int ComparePlugins(const TieBreakKey& plugin1,
+                            const TieBreakKey& plugin2);
 
   void PropagatePriorities();
 
@@ -86,12 +104,16 @@ private:
   void AddOverlapEdges();
   void AddTieBreakEdges();
 
-  void AddEdge(const vertex_t& fromVertex, const vertex_t& toVertex);
+  void AddEdge(const vertex_t& fromVertex,
+               const vertex_t& toVertex,
+               EdgeType type);
 
   PluginGraph graph_;
   std::map<vertex_t, size_t> indexMap_;
   vertex_map_t vertexIndexMap_;
-  std::vector<std::string> oldLoadOrder_;
+  // The load order when sorting started, as lowercased plugin names mapped
+  // to their load order indices.
+  std::unordered_map<std::string, size_t> loadOrderIndices_;
   std::shared_ptr<spdlog::logger> logger_;
 };
 }
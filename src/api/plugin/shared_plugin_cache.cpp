@@ -0,0 +1,457 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/plugin/shared_plugin_cache.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "api/helpers/binary_stream.h"
+#include "api/helpers/logging.h"
+#include "loot/exception/file_access_error.h"
+
+namespace bip = boost::interprocess;
+namespace fs = boost::filesystem;
+
+namespace loot {
+// File locks synchronise processes, but not the threads of one process.
+struct SharedPluginCache::FileLock {
+  std::mutex mutex;
+  bip::file_lock lock;
+};
+
+struct SharedPluginCache::FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t slotCount;
+  uint64_t dataCapacity;
+  std::atomic<uint64_t> dataSize;
+};
+
+// A slot's record location is its offset in the data region and its size,
+// packed together so that readers can't see one without the other.
+struct SharedPluginCache::Slot {
+  std::atomic<uint64_t> keyHash;
+  std::atomic<uint64_t> location;
+};
+
+namespace {
+const char FILE_MAGIC[8] = {'L', 'O', 'O', 'T', 'P', 'L', 'U', 'G'};
+// Version 2 moved locking from the cache file to a separate lock file.
+const uint32_t FILE_VERSION = 2;
+
+const unsigned int RECORD_SIZE_BITS = 24;
+const uint64_t MAX_RECORD_SIZE = (uint64_t(1) << RECORD_SIZE_BITS) - 1;
+const uint64_t MAX_DATA_CAPACITY = uint64_t(1) << (64 - RECORD_SIZE_BITS);
+
+const uint8_t WHOLE_PLUGIN_FLAG = 0x1;
+const uint8_t EMPTY_FLAG = 0x2;
+const uint8_t MASTER_FLAG = 0x4;
+const uint8_t LIGHT_MASTER_FLAG = 0x8;
+
+std::shared_ptr<SharedPluginCache> sharedPluginCache;
+
+// FNV-1a, with zero reserved for empty slots.
+uint64_t HashKey(const PluginFileKey& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  auto add = [&hash](unsigned char byte) {
+    hash ^= byte;
+    hash *= 1099511628211ULL;
+  };
+
+  add(static_cast<unsigned char>(key.gameType));
+  for (const auto& character : key.path) {
+    add(static_cast<unsigned char>(character));
+  }
+
+  return hash == 0 ? 1 : hash;
+}
+
+uint32_t GetChecksum(const char* data, size_t size) {
+  boost::crc_32_type result;
+  result.process_bytes(data, size);
+  return result.checksum();
+}
+
+std::string SerialiseRecord(const PluginFileKey& key,
+                            const SharedPluginRecord& record) {
+  uint8_t flags = 0;
+  if (!record.isHeaderOnly)
+    flags |= WHOLE_PLUGIN_FLAG;
+  if (record.isEmpty)
+    flags |= EMPTY_FLAG;
+  if (record.isMaster)
+    flags |= MASTER_FLAG;
+  if (record.isLightMaster)
+    flags |= LIGHT_MASTER_FLAG;
+
+  BinaryWriter writer;
+  writer.Write(uint32_t(0));
+  writer.Write(static_cast<uint8_t>(key.gameType));
+  writer.Write(flags);
+  writer.Write(key.size);
+  writer.Write(key.modificationTime);
+  writer.Write(record.crc);
+  writer.Write(static_cast<uint64_t>(record.numOverrideRecords));
+  writer.Write(key.path);
+  writer.Write(record.description);
+  writer.Write(static_cast<uint32_t>(record.masters.size()));
+  for (const auto& master : record.masters) {
+    writer.Write(master);
+  }
+
+  // The checksum covers everything after itself.
+  std::string& buffer = writer.GetBuffer();
+  uint32_t checksum = GetChecksum(buffer.data() + sizeof(uint32_t),
+                                  buffer.size() - sizeof(uint32_t));
+  std::memcpy(&buffer[0], &checksum, sizeof(checksum));
+
+  return buffer;
+}
+}
+
+PluginFileKey::PluginFileKey() :
+    gameType(GameType::tes4),
+    size(0),
+    modificationTime(0) {}
+
+PluginFileKey PluginFileKey::Get(GameType gameType, const fs::path& path) {
+  PluginFileKey key;
+  key.gameType = gameType;
+  key.path = fs::absolute(path).generic_string();
+  key.size = fs::file_size(path);
+  key.modificationTime = fs::last_write_time(path);
+
+  return key;
+}
+
+bool PluginFileKey::operator==(const PluginFileKey& rhs) const {
+  return gameType == rhs.gameType && path == rhs.path && size == rhs.size &&
+         modificationTime == rhs.modificationTime;
+}
+
+bool PluginFileKey::operator!=(const PluginFileKey& rhs) const {
+  return !(*this == rhs);
+}
+
+SharedPluginRecord::SharedPluginRecord() :
+    isHeaderOnly(true),
+    isEmpty(true),
+    isMaster(false),
+    isLightMaster(false),
+    crc(0),
+    numOverrideRecords(0) {}
+
+SharedPluginCache::SharedPluginCache(const fs::path& path,
+                                     uint32_t slotCount,
+                                     uint64_t dataCapacity) :
+    slotCount_(slotCount),
+    dataCapacity_(dataCapacity),
+    hasLoggedFull_(false) {
+  static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                "Atomics must have the same layout in every process.");
+
+  if (!std::atomic<uint64_t>().is_lock_free())
+    throw std::runtime_error(
+        "The shared plugin cache requires lock-free 64-bit atomics.");
+
+  if (slotCount == 0 || dataCapacity > MAX_DATA_CAPACITY)
+    throw std::invalid_argument("Invalid shared plugin cache capacity.");
+
+  try {
+    // The cache file can be replaced, so the lock is taken on a separate file
+    // that never is.
+    fileLock_ = GetFileLock(path.string() + ".lock");
+
+    // The cache file is only replaced while locked, so it can't be replaced
+    // between being checked and mapped.
+    std::lock_guard<std::mutex> guard(fileLock_->mutex);
+    bip::scoped_lock<bip::file_lock> lock(fileLock_->lock);
+
+    if (!MapFile(path)) {
+      // Other processes may have the file mapped, so it's replaced instead of
+      // being overwritten, leaving them with the old file.
+      const fs::path tempPath = path.string() + ".tmp";
+      InitialiseFile(tempPath, slotCount_, dataCapacity_);
+      fs::rename(tempPath, path);
+
+      if (!MapFile(path))
+        throw FileAccessError("Cannot create the shared plugin cache file \"" +
+                              path.string() + "\"");
+    }
+  } catch (bip::interprocess_exception& e) {
+    throw FileAccessError("Cannot open the shared plugin cache file \"" +
+                          path.string() + "\": " + e.what());
+  } catch (fs::filesystem_error& e) {
+    throw FileAccessError("Cannot replace the shared plugin cache file \"" +
+                          path.string() + "\": " + e.what());
+  }
+}
+
+bool SharedPluginCache::Find(const PluginFileKey& key,
+                             bool headerOnly,
+                             SharedPluginRecord& record) const {
+  uint64_t keyHash = HashKey(key);
+  const Slot* slot = FindSlot(keyHash);
+  if (slot == nullptr ||
+      slot->keyHash.load(std::memory_order_acquire) != keyHash)
+    return false;
+
+  return ReadRecord(
+      slot->location.load(std::memory_order_acquire), key, headerOnly, record);
+}
+
+void SharedPluginCache::Store(const PluginFileKey& key,
+                              const SharedPluginRecord& record) {
+  std::string bytes = SerialiseRecord(key, record);
+  if (bytes.size() > MAX_RECORD_SIZE)
+    return;
+
+  uint64_t keyHash = HashKey(key);
+
+  std::lock_guard<std::mutex> guard(fileLock_->mutex);
+  bip::scoped_lock<bip::file_lock> lock(fileLock_->lock);
+
+  Slot* slot = FindSlot(keyHash);
+  if (slot == nullptr) {
+    LogFull();
+    return;
+  }
+
+  // Another process may have stored the record since it was looked up.
+  SharedPluginRecord existingRecord;
+  if (slot->keyHash.load(std::memory_order_relaxed) == keyHash &&
+      ReadRecord(slot->location.load(std::memory_order_relaxed),
+                 key,
+                 record.isHeaderOnly,
+                 existingRecord))
+    return;
+
+  FileHeader* header = GetHeader();
+  uint64_t offset = header->dataSize.load(std::memory_order_relaxed);
+  if (bytes.size() > dataCapacity_ - offset) {
+    LogFull();
+    return;
+  }
+
+  // The record is written before it's published, and never changes after.
+  std::memcpy(GetData() + offset, bytes.data(), bytes.size());
+  header->dataSize.store(offset + bytes.size(), std::memory_order_relaxed);
+
+  uint64_t location = (offset << RECORD_SIZE_BITS) | bytes.size();
+  slot->location.store(location, std::memory_order_release);
+  slot->keyHash.store(keyHash, std::memory_order_release);
+}
+
+SharedPluginCache::Slot* SharedPluginCache::FindSlot(uint64_t keyHash) const {
+  Slot* slots = GetSlots();
+  for (uint32_t i = 0; i < slotCount_; ++i) {
+    Slot* slot = slots + (keyHash + i) % slotCount_;
+    uint64_t slotKeyHash = slot->keyHash.load(std::memory_order_acquire);
+    if (slotKeyHash == keyHash || slotKeyHash == 0)
+      return slot;
+  }
+
+  return nullptr;
+}
+
+bool SharedPluginCache::ReadRecord(uint64_t location,
+                                   const PluginFileKey& key,
+                                   bool headerOnly,
+                                   SharedPluginRecord& record) const {
+  uint64_t offset = location >> RECORD_SIZE_BITS;
+  uint64_t size = location & MAX_RECORD_SIZE;
+  if (size < sizeof(uint32_t) || offset > dataCapacity_ ||
+      size > dataCapacity_ - offset)
+    return false;
+
+  // Records are checked as they're read, so that a corrupt record is treated
+  // as missing.
+  BinaryReader reader(GetData() + offset, size);
+  SharedPluginRecord result;
+  try {
+    uint32_t checksum = reader.Read<uint32_t>();
+    if (checksum != GetChecksum(reader.GetData(), reader.GetSize()))
+      return false;
+
+    uint8_t gameType = reader.Read<uint8_t>();
+    uint8_t flags = reader.Read<uint8_t>();
+    PluginFileKey recordKey;
+    reader.Read(recordKey.size);
+    reader.Read(recordKey.modificationTime);
+    reader.Read(result.crc);
+    uint64_t numOverrideRecords = reader.Read<uint64_t>();
+    reader.Read(recordKey.path);
+    reader.Read(result.description);
+
+    if (gameType != static_cast<uint8_t>(key.gameType) ||
+        recordKey.size != key.size ||
+        recordKey.modificationTime != key.modificationTime ||
+        recordKey.path != key.path)
+      return false;
+
+    if (!headerOnly && (flags & WHOLE_PLUGIN_FLAG) == 0)
+      return false;
+
+    uint32_t masterCount = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < masterCount; ++i) {
+      result.masters.push_back(reader.Read<std::string>());
+    }
+
+    result.isEmpty = (flags & EMPTY_FLAG) != 0;
+    result.isMaster = (flags & MASTER_FLAG) != 0;
+    result.isLightMaster = (flags & LIGHT_MASTER_FLAG) != 0;
+
+    if (headerOnly) {
+      result.crc = 0;
+    } else {
+      result.isHeaderOnly = false;
+      result.numOverrideRecords = static_cast<size_t>(numOverrideRecords);
+    }
+  } catch (std::runtime_error&) {
+    return false;
+  }
+
+  record = result;
+  return true;
+}
+
+std::shared_ptr<SharedPluginCache::FileLock> SharedPluginCache::GetFileLock(
+    const fs::path& lockPath) {
+  // Closing any of a process's handles to a file releases all of its locks on
+  // the file, so each lock file is only opened once per process and the
+  // handle is shared by all the caches that use it.
+  static std::mutex fileLocksMutex;
+  static std::map<std::string, std::weak_ptr<FileLock>> fileLocks;
+
+  std::lock_guard<std::mutex> guard(fileLocksMutex);
+
+  // The lock file must exist to be locked. It's not opened if it exists, as
+  // this process may hold a lock on it.
+  if (!fs::exists(lockPath))
+    boost::filesystem::ofstream(lockPath, std::ios::binary).close();
+  if (!fs::exists(lockPath))
+    throw FileAccessError("Cannot create the shared plugin cache lock file \"" +
+                          lockPath.string() + "\"");
+
+  const std::string key = fs::canonical(lockPath).string();
+  auto fileLock = fileLocks[key].lock();
+  if (!fileLock) {
+    fileLock = std::make_shared<FileLock>();
+    fileLock->lock = bip::file_lock(key.c_str());
+    fileLocks[key] = fileLock;
+  }
+
+  return fileLock;
+}
+
+bool SharedPluginCache::MapFile(const fs::path& path) {
+  if (!fs::exists(path) || fs::file_size(path) < sizeof(FileHeader))
+    return false;
+
+  mapping_ = bip::file_mapping(path.string().c_str(), bip::read_write);
+  region_ = bip::mapped_region(mapping_, bip::read_write);
+
+  const FileHeader* header = GetHeader();
+  if (std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+      header->version != FILE_VERSION || header->slotCount == 0 ||
+      header->dataCapacity > MAX_DATA_CAPACITY ||
+      region_.get_size() <
+          GetFileSize(header->slotCount, header->dataCapacity)) {
+    region_ = bip::mapped_region();
+    mapping_ = bip::file_mapping();
+    return false;
+  }
+
+  slotCount_ = header->slotCount;
+  dataCapacity_ = header->dataCapacity;
+  return true;
+}
+
+void SharedPluginCache::InitialiseFile(const fs::path& path,
+                                       uint32_t slotCount,
+                                       uint64_t dataCapacity) {
+  // The file is extended with zeroes, which is an empty table and data region.
+  boost::filesystem::ofstream(path, std::ios::binary | std::ios::trunc)
+      .close();
+  fs::resize_file(path, GetFileSize(slotCount, dataCapacity));
+
+  bip::file_mapping mapping(path.string().c_str(), bip::read_write);
+  bip::mapped_region region(mapping, bip::read_write, 0, sizeof(FileHeader));
+
+  FileHeader* header = static_cast<FileHeader*>(region.get_address());
+  header->version = FILE_VERSION;
+  header->slotCount = slotCount;
+  header->dataCapacity = dataCapacity;
+  header->dataSize.store(0);
+  std::memcpy(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+
+  region.flush();
+}
+
+void SharedPluginCache::LogFull() {
+  if (hasLoggedFull_)
+    return;
+
+  hasLoggedFull_ = true;
+  auto logger = getLogger();
+  if (logger) {
+    logger->warn(
+        "The shared plugin cache is full, so no more plugins will be stored "
+        "in it.");
+  }
+}
+
+uint64_t SharedPluginCache::GetFileSize(uint32_t slotCount,
+                                        uint64_t dataCapacity) {
+  return sizeof(FileHeader) + slotCount * sizeof(Slot) + dataCapacity;
+}
+
+SharedPluginCache::FileHeader* SharedPluginCache::GetHeader() const {
+  return static_cast<FileHeader*>(region_.get_address());
+}
+
+SharedPluginCache::Slot* SharedPluginCache::GetSlots() const {
+  return reinterpret_cast<Slot*>(GetHeader() + 1);
+}
+
+char* SharedPluginCache::GetData() const {
+  return reinterpret_cast<char*>(GetSlots() + slotCount_);
+}
+
+std::shared_ptr<SharedPluginCache> getSharedPluginCache() {
+  return std::atomic_load(&sharedPluginCache);
+}
+
+void setSharedPluginCache(std::shared_ptr<SharedPluginCache> cache) {
+  std::atomic_store(&sharedPluginCache, cache);
+}
+}
@@ -0,0 +1,144 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_PLUGIN_SHARED_PLUGIN_CACHE
+#define LOOT_API_PLUGIN_SHARED_PLUGIN_CACHE
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "loot/enum/game_type.h"
+
+namespace loot {
+// Identifies a plugin file's content by its path, size and modification time.
+struct PluginFileKey {
+  PluginFileKey();
+
+  // Throws if the file's size and modification time can't be read.
+  static PluginFileKey Get(GameType gameType,
+                           const boost::filesystem::path& path);
+
+  bool operator==(const PluginFileKey& rhs) const;
+  bool operator!=(const PluginFileKey& rhs) const;
+
+  GameType gameType;
+  std::string path;
+  uint64_t size;
+  int64_t modificationTime;
+};
+
+// The data read from a plugin that doesn't depend on any other files or on
+// the load order.
+struct SharedPluginRecord {
+  SharedPluginRecord();
+
+  bool isHeaderOnly;
+  bool isEmpty;
+  bool isMaster;
+  bool isLightMaster;
+  uint32_t crc;
+  size_t numOverrideRecords;
+  std::string description;
+  std::vector<std::string> masters;
+};
+
+// A cache of plugin records in a memory-mapped file that can be shared by
+// several processes. The file holds a hash table of fixed-size slots and an
+// append-only data region, both addressed by offsets, so it can be mapped at
+// any address. Finding a record doesn't take any locks, while storing one
+// takes a lock on a lock file next to the cache file that's shared by all
+// processes. Once the table or data region is full, no more records are
+// stored.
+class SharedPluginCache {
+public:
+  // Opens the cache file at the given path, creating it with the given
+  // capacity if it doesn't exist or isn't a valid cache file. An invalid file
+  // is replaced rather than overwritten, as other processes may be using it.
+  SharedPluginCache(const boost::filesystem::path& path,
+                    uint32_t slotCount = 65536,
+                    uint64_t dataCapacity = 64 * 1024 * 1024);
+
+  // Returns true and sets the record if one is stored for the key that has
+  // the requested data. A whole plugin's record is also used for header-only
+  // lookups, but without its CRC and override record count.
+  bool Find(const PluginFileKey& key,
+            bool headerOnly,
+            SharedPluginRecord& record) const;
+
+  // Stores the record unless the cache already has one that's as useful, or
+  // it is full.
+  void Store(const PluginFileKey& key, const SharedPluginRecord& record);
+
+private:
+  struct FileLock;
+  struct FileHeader;
+  struct Slot;
+
+  // Returns the slot for the key hash, or the empty slot where it would be
+  // added, or null if the table is full.
+  Slot* FindSlot(uint64_t keyHash) const;
+  bool ReadRecord(uint64_t location,
+                  const PluginFileKey& key,
+                  bool headerOnly,
+                  SharedPluginRecord& record) const;
+
+  static std::shared_ptr<FileLock> GetFileLock(
+      const boost::filesystem::path& lockPath);
+
+  // Maps the file if it's a valid cache file, and returns false otherwise.
+  bool MapFile(const boost::filesystem::path& path);
+  static void InitialiseFile(const boost::filesystem::path& path,
+                             uint32_t slotCount,
+                             uint64_t dataCapacity);
+  void LogFull();
+
+  static uint64_t GetFileSize(uint32_t slotCount, uint64_t dataCapacity);
+
+  FileHeader* GetHeader() const;
+  Slot* GetSlots() const;
+  char* GetData() const;
+
+  uint32_t slotCount_;
+  uint64_t dataCapacity_;
+  bool hasLoggedFull_;
+  std::shared_ptr<FileLock> fileLock_;
+  boost::interprocess::file_mapping mapping_;
+  boost::interprocess::mapped_region region_;
+};
+
+// Plugins are read from and stored in the shared plugin cache if one is
+// attached. Plugins that have already been loaded are unaffected by attaching
+// or detaching a cache.
+std::shared_ptr<SharedPluginCache> getSharedPluginCache();
+void setSharedPluginCache(std::shared_ptr<SharedPluginCache> cache);
+}
+
+#endif
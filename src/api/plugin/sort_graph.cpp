@@ -0,0 +1,152 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "api/plugin/sort_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/locale.hpp>
+
+using boost::locale::to_lower;
+
+namespace loot {
+SortGraph::SortGraph() : offsets_(1, 0) {}
+
+SortGraph::SortGraph(const std::vector<std::string>& plugins,
+                     const std::vector<Edge>& edges) :
+    plugins_(plugins),
+    offsets_(plugins.size() + 1, 0),
+    targets_(edges.size()),
+    types_(edges.size()) {
+  for (uint32_t i = 0; i < plugins_.size(); ++i) {
+    indices_.emplace(to_lower(plugins_[i]), i);
+  }
+
+  // Count each plugin's edges, turn the counts into offsets, then fill in
+  // each plugin's range.
+  for (const auto& edge : edges) {
+    if (edge.from >= plugins_.size() || edge.to >= plugins_.size())
+      throw std::invalid_argument("A sort graph edge has an invalid plugin");
+
+    ++offsets_[edge.from + 1];
+  }
+
+  for (size_t i = 1; i < offsets_.size(); ++i) {
+    offsets_[i] += offsets_[i - 1];
+  }
+
+  std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+  for (const auto& edge : edges) {
+    uint32_t position = next[edge.from]++;
+    targets_[position] = edge.to;
+    types_[position] = edge.type;
+  }
+}
+
+size_t SortGraph::GetPluginCount() const { return plugins_.size(); }
+
+size_t SortGraph::GetEdgeCount() const { return targets_.size(); }
+
+std::vector<SortGraphEdge> SortGraph::FindPath(
+    const std::string& fromPlugin,
+    const std::string& toPlugin) const {
+  const uint32_t source = GetIndex(fromPlugin);
+  const uint32_t target = GetIndex(toPlugin);
+
+  if (source == target)
+    return std::vector<SortGraphEdge>();
+
+  // A path can't have more edges than there are plugins, so weighting each
+  // tie-break edge by the plugin count makes the shortest path the one with
+  // the fewest tie-break edges, and then the fewest edges.
+  const uint64_t tieBreakWeight = plugins_.size();
+  const uint64_t unreached = std::numeric_limits<uint64_t>::max();
+  const uint32_t noEdge = std::numeric_limits<uint32_t>::max();
+
+  std::vector<uint64_t> distances(plugins_.size(), unreached);
+  std::vector<uint32_t> previousEdges(plugins_.size(), noEdge);
+  std::vector<uint32_t> previousPlugins(plugins_.size(), noEdge);
+
+  typedef std::pair<uint64_t, uint32_t> QueueEntry;
+  std::priority_queue<QueueEntry,
+                      std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue;
+
+  distances[source] = 0;
+  queue.emplace(0, source);
+
+  while (!queue.empty()) {
+    const QueueEntry entry = queue.top();
+    queue.pop();
+
+    const uint32_t plugin = entry.second;
+    if (entry.first != distances[plugin])
+      continue;
+    if (plugin == target)
+      break;
+
+    for (uint32_t i = offsets_[plugin]; i < offsets_[plugin + 1]; ++i) {
+      uint64_t weight = types_[i] == EdgeType::tieBreak ? tieBreakWeight : 1;
+      uint64_t distance = entry.first + weight;
+      uint32_t neighbour = targets_[i];
+
+      if (distance < distances[neighbour]) {
+        distances[neighbour] = distance;
+        previousEdges[neighbour] = i;
+        previousPlugins[neighbour] = plugin;
+        queue.emplace(distance, neighbour);
+      }
+    }
+  }
+
+  std::vector<SortGraphEdge> path;
+  if (distances[target] == unreached)
+    return path;
+
+  for (uint32_t plugin = target; plugin != source;
+       plugin = previousPlugins[plugin]) {
+    path.emplace_back(plugins_[previousPlugins[plugin]],
+                      plugins_[plugin],
+                      types_[previousEdges[plugin]]);
+  }
+  std::reverse(path.begin(), path.end());
+
+  return path;
+}
+
+uint32_t SortGraph::GetIndex(const std::string& plugin) const {
+  auto it = indices_.find(to_lower(plugin));
+  if (it == indices_.end())
+    throw std::invalid_argument("\"" + plugin +
+                                "\" is not in the sort graph");
+
+  return it->second;
+}
+}
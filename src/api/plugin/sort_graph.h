@@ -0,0 +1,78 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_API_PLUGIN_SORT_GRAPH
+#define LOOT_API_PLUGIN_SORT_GRAPH
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "loot/enum/edge_type.h"
+#include "loot/struct/sort_graph_edge.h"
+
+namespace loot {
+// A compact, read-only copy of the plugin graph that a sort built, which
+// doesn't refer to any loaded plugins so it can be kept after they're
+// unloaded. Edges are stored in compressed sparse row form, grouped by the
+// index of the plugin they start from.
+class SortGraph {
+public:
+  struct Edge {
+    uint32_t from;
+    uint32_t to;
+    EdgeType type;
+  };
+
+  SortGraph();
+
+  // Edges refer to plugins by their index in the given vector.
+  SortGraph(const std::vector<std::string>& plugins,
+            const std::vector<Edge>& edges);
+
+  size_t GetPluginCount() const;
+  size_t GetEdgeCount() const;
+
+  // Returns the edges of a path from one plugin to another that uses as few
+  // tie-break edges as possible, and then as few edges as possible, or an
+  // empty vector if there is no path. Plugin names are case-insensitive.
+  // Throws std::invalid_argument if either plugin isn't in the graph.
+  std::vector<SortGraphEdge> FindPath(const std::string& fromPlugin,
+                                      const std::string& toPlugin) const;
+
+private:
+  uint32_t GetIndex(const std::string& plugin) const;
+
+  std::vector<std::string> plugins_;
+  std::unordered_map<std::string, uint32_t> indices_;
+
+  // The edges starting from plugin i are at [offsets_[i], offsets_[i + 1]).
+  std::vector<uint32_t> offsets_;
+  std::vector<uint32_t> targets_;
+  std::vector<EdgeType> types_;
+};
+}
+
+#endif
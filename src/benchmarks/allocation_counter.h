@@ -0,0 +1,88 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_ALLOCATION_COUNTER
+#define LOOT_BENCHMARKS_ALLOCATION_COUNTER
+
+#include <algorithm>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include "api/helpers/memory_accounting.h"
+
+namespace loot {
+namespace benchmarks {
+// Measures the allocations made while a benchmark is timed. Pause and resume
+// it alongside the benchmark's timer so that setup isn't counted. Allocations
+// are counted by the API's operator new and delete replacements, which the
+// benchmarks executable links in.
+class AllocationTracker {
+public:
+  AllocationTracker() : peakBytes_(0), allocationCount_(0), isRunning_(false) {
+    Resume();
+  }
+
+  void Resume() {
+    if (isRunning_)
+      return;
+
+    ResetPeakAllocatedBytes();
+    baselineBytes_ = GetAllocatedBytes();
+    baselineCount_ = GetAllocationCount();
+    isRunning_ = true;
+  }
+
+  void Pause() {
+    if (!isRunning_)
+      return;
+
+    peakBytes_ = std::max(peakBytes_, GetPeakAllocatedBytes() - baselineBytes_);
+    allocationCount_ += GetAllocationCount() - baselineCount_;
+    isRunning_ = false;
+  }
+
+  // Adds the peak bytes allocated above the baseline at any point while
+  // running, and the mean number of allocations per iteration, to the
+  // benchmark's counters.
+  void Report(::benchmark::State& state) {
+    Pause();
+
+    state.counters["peak_bytes"] = static_cast<double>(peakBytes_);
+    if (state.iterations() > 0)
+      state.counters["allocs_per_iter"] =
+          static_cast<double>(allocationCount_) / state.iterations();
+  }
+
+private:
+  size_t baselineBytes_;
+  size_t baselineCount_;
+  size_t peakBytes_;
+  size_t allocationCount_;
+  bool isRunning_;
+};
+}
+}
+
+#endif
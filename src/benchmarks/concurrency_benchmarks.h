@@ -0,0 +1,168 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_CONCURRENCY_BENCHMARKS
+#define LOOT_BENCHMARKS_CONCURRENCY_BENCHMARKS
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "api/game/game.h"
+#include "api/helpers/logging.h"
+#include "api/helpers/statistics.h"
+#include "benchmarks/generated_game.h"
+#include "benchmarks/metadata_benchmarks.h"
+
+// These benchmarks run their workloads on 1 to 64 threads at once. In each
+// benchmark, thread 0 sets up the state that all threads share before the
+// benchmark loop and tears it down after. Google Benchmark starts and ends
+// every thread's loop together, so the other threads only use the state
+// inside the loop.
+
+namespace loot {
+namespace benchmarks {
+// Shared by the threads of a running benchmark.
+struct ConcurrencyState {
+  ConcurrencyState() : baseline(GetStatisticValues()) {
+    // Pass messages to a callback that discards them, so that logging
+    // threads contend for the sink's lock as they do in real use.
+    auto sink = std::make_shared<SpdLoggingSink>([](LogLevel, const char*) {});
+    setLogger(std::make_shared<spdlog::logger>(LOGGER_NAME, sink));
+  }
+
+  ~ConcurrencyState() { setLogger(nullptr); }
+
+  // Adds the time that all threads spent waiting for locks to the
+  // benchmark's counters.
+  void Report(::benchmark::State& state) const {
+    auto statistics = ToGameStatistics(GetStatisticValues(), baseline);
+    state.counters["cache_lock_wait_ms"] =
+        ToMilliseconds(statistics.game_cache_lock_wait_time);
+    state.counters["log_lock_wait_ms"] =
+        ToMilliseconds(statistics.logging_lock_wait_time);
+  }
+
+  std::shared_ptr<Game> game;
+  std::vector<std::string> plugins;
+  const StatisticValues baseline;
+
+private:
+  static double ToMilliseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  }
+};
+
+// Runs a benchmark with 1, 2, 4, ..., 64 threads. Throughput is measured
+// against wall clock time, as the CPU time of the main thread doesn't
+// include the other threads' work.
+inline void ThreadCounts(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->ThreadRange(1, 64)->UseRealTime();
+}
+
+// Each thread gets the metadata of a different plugin in each iteration, so
+// that all threads use the same game handle and metadata lists at once.
+static void RunConcurrentGetPluginMetadata(::benchmark::State& state,
+                                           bool evaluateConditions) {
+  static std::unique_ptr<ConcurrencyState> shared;
+
+  if (state.thread_index == 0) {
+    const auto& masterlist = GeneratedMasterlist::Get(5000);
+    const auto& generatedGame = GeneratedMasterlist::GetGame();
+
+    shared.reset(new ConcurrencyState());
+    shared->game = generatedGame.CreateGame();
+    shared->game->LoadPlugins(generatedGame.GetPlugins(), true);
+    shared->game->GetDatabase()->LoadLists(masterlist.GetPath().string());
+    shared->plugins = generatedGame.GetPlugins();
+
+    // Evaluate every condition once, so that the benchmark measures
+    // contention for the cached results and not evaluation.
+    if (evaluateConditions) {
+      for (const auto& plugin : shared->plugins) {
+        shared->game->GetDatabase()->GetPluginMetadata(plugin, true, true);
+      }
+    }
+  }
+
+  size_t index = state.thread_index;
+  while (state.KeepRunning()) {
+    const auto& plugin = shared->plugins[index % shared->plugins.size()];
+    ::benchmark::DoNotOptimize(shared->game->GetDatabase()->GetPluginMetadata(
+        plugin, true, evaluateConditions));
+    index += state.threads;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index == 0) {
+    shared->Report(state);
+    shared.reset();
+  }
+}
+
+static void BM_ConcurrentGetPluginMetadata(::benchmark::State& state) {
+  RunConcurrentGetPluginMetadata(state, false);
+}
+BENCHMARK(BM_ConcurrentGetPluginMetadata)->Apply(ThreadCounts);
+
+// Like BM_ConcurrentGetPluginMetadata, but also evaluates the metadata's
+// conditions against the game's shared condition cache.
+static void BM_ConcurrentConditionEvaluation(::benchmark::State& state) {
+  RunConcurrentGetPluginMetadata(state, true);
+}
+BENCHMARK(BM_ConcurrentConditionEvaluation)->Apply(ThreadCounts);
+
+// Each thread creates its own game handle and loads the same plugins'
+// headers into it, which also runs LoadPlugins()' own loading threads.
+static void BM_ParallelGameLoading(::benchmark::State& state) {
+  static std::unique_ptr<ConcurrencyState> shared;
+  static const GeneratedGame* generatedGame = nullptr;
+
+  if (state.thread_index == 0) {
+    generatedGame = &GeneratedGame::Get(100);
+    shared.reset(new ConcurrencyState());
+  }
+
+  while (state.KeepRunning()) {
+    auto game = generatedGame->CreateGame();
+    game->LoadPlugins(generatedGame->GetPlugins(), true);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          generatedGame->GetPlugins().size());
+  if (state.thread_index == 0) {
+    shared->Report(state);
+    shared.reset();
+  }
+}
+BENCHMARK(BM_ParallelGameLoading)
+    ->Apply(ThreadCounts)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_GAME_BENCHMARKS
+#define LOOT_BENCHMARKS_GAME_BENCHMARKS
+
+#include <benchmark/benchmark.h>
+
+#include "api/game/game.h"
+#include "api/plugin/plugin_sorter.h"
+#include "benchmarks/generated_game.h"
+
+namespace loot {
+namespace benchmarks {
+static void BM_LoadPluginHeaders(::benchmark::State& state) {
+  const auto& generatedGame = GeneratedGame::Get(state.range(0));
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto game = generatedGame.CreateGame();
+    state.ResumeTiming();
+
+    game->LoadPlugins(generatedGame.GetPlugins(), true);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadPluginHeaders)
+    ->Apply(PluginCounts)
+    ->Unit(::benchmark::kMillisecond);
+
+static void BM_LoadPlugins(::benchmark::State& state) {
+  const auto& generatedGame = GeneratedGame::Get(state.range(0));
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto game = generatedGame.CreateGame();
+    state.ResumeTiming();
+
+    game->LoadPlugins(generatedGame.GetPlugins(), false);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadPlugins)
+    ->Apply(PluginCounts)
+    ->Unit(::benchmark::kMillisecond);
+
+static void BM_SortPlugins(::benchmark::State& state) {
+  const auto& generatedGame = GeneratedGame::Get(state.range(0));
+  auto game = generatedGame.CreateGame();
+  game->LoadPlugins(generatedGame.GetPlugins(), false);
+
+  while (state.KeepRunning()) {
+    PluginSorter sorter;
+    ::benchmark::DoNotOptimize(sorter.Sort(*game));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortPlugins)
+    ->Apply(PluginCounts)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_GENERATED_GAME
+#define LOOT_BENCHMARKS_GENERATED_GAME
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "api/game/game.h"
+#include "benchmarks/plugin_generator.h"
+
+namespace loot {
+namespace benchmarks {
+// A game install in a temporary directory, populated with generated plugins.
+class GeneratedGame {
+public:
+  GeneratedGame(GameType gameType, const PluginGeneratorOptions& options) :
+      gameType_(gameType),
+      rootPath_(boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("loot-benchmark-%%%%-%%%%")),
+      gamePath_(rootPath_ / "game"),
+      localPath_(rootPath_ / "local") {
+    boost::filesystem::create_directories(localPath_);
+    plugins_ = PluginGenerator(gameType, options).Generate(GetDataPath());
+  }
+
+  ~GeneratedGame() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(rootPath_, ec);
+  }
+
+  // Creates a game handle with the load order state loaded but no plugins.
+  std::shared_ptr<Game> CreateGame() const {
+    auto game = std::make_shared<Game>(gameType_, gamePath_, localPath_);
+    game->IdentifyMainMasterFile(plugins_.front());
+    game->LoadCurrentLoadOrderState();
+
+    return game;
+  }
+
+  boost::filesystem::path GetDataPath() const { return gamePath_ / "Data"; }
+
+  const std::vector<std::string>& GetPlugins() const { return plugins_; }
+
+  // Generating thousands of plugins is slow, so each plugin count's game is
+  // generated once and shared by all benchmarks that use it.
+  static const GeneratedGame& Get(size_t pluginCount) {
+    static std::map<size_t, std::unique_ptr<GeneratedGame>> games;
+
+    auto it = games.find(pluginCount);
+    if (it == games.end()) {
+      PluginGeneratorOptions options;
+      options.pluginCount = pluginCount;
+      options.masterPluginCount = pluginCount / 10;
+
+      it = games
+               .emplace(pluginCount,
+                        std::unique_ptr<GeneratedGame>(
+                            new GeneratedGame(GameType::tes5, options)))
+               .first;
+    }
+
+    return *it->second;
+  }
+
+private:
+  const GameType gameType_;
+  const boost::filesystem::path rootPath_;
+  const boost::filesystem::path gamePath_;
+  const boost::filesystem::path localPath_;
+  std::vector<std::string> plugins_;
+};
+
+// Runs a benchmark at each of the plugin counts that all benchmarks use.
+inline void PluginCounts(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(100)->Arg(1000)->Arg(5000);
+}
+}
+}
+
+#endif
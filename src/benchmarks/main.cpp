@@ -0,0 +1,115 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/locale.hpp>
+
+#include "benchmarks/concurrency_benchmarks.h"
+#include "benchmarks/game_benchmarks.h"
+#include "benchmarks/metadata_benchmarks.h"
+#include "benchmarks/performance_baseline.h"
+#include "benchmarks/plugin_benchmarks.h"
+
+namespace {
+const char checkBaselineFlag[] = "--check_baseline=";
+const char updateBaselineFlag[] = "--update_baseline=";
+
+bool StartsWith(const char* argument, const char* prefix) {
+  return std::strncmp(argument, prefix, std::strlen(prefix)) == 0;
+}
+}
+
+int main(int argc, char **argv) {
+  // Set the locale to get encoding conversions working correctly.
+  std::locale::global(boost::locale::generator().generate(""));
+  boost::filesystem::path::imbue(std::locale());
+
+  // Take out the baseline flags, which Google Benchmark doesn't recognise.
+  std::string baselinePath;
+  bool updateBaseline = false;
+  std::vector<char *> arguments;
+  for (int i = 0; i < argc; ++i) {
+    if (StartsWith(argv[i], checkBaselineFlag)) {
+      baselinePath = argv[i] + std::strlen(checkBaselineFlag);
+    } else if (StartsWith(argv[i], updateBaselineFlag)) {
+      baselinePath = argv[i] + std::strlen(updateBaselineFlag);
+      updateBaseline = true;
+    } else {
+      arguments.push_back(argv[i]);
+    }
+  }
+
+  if (baselinePath.empty()) {
+    int argumentCount = static_cast<int>(arguments.size());
+    ::benchmark::Initialize(&argumentCount, arguments.data());
+    if (::benchmark::ReportUnrecognizedArguments(argumentCount,
+                                                 arguments.data()))
+      return 1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+  }
+
+  try {
+    loot::benchmarks::PerformanceBaseline baseline;
+    baseline.Load(baselinePath);
+
+    // Only run the baseline's benchmarks. Put the filter first so that it
+    // can be overridden.
+    std::string filter = "--benchmark_filter=" + baseline.GetFilter();
+    arguments.insert(arguments.begin() + 1, &filter[0]);
+
+    int argumentCount = static_cast<int>(arguments.size());
+    ::benchmark::Initialize(&argumentCount, arguments.data());
+    if (::benchmark::ReportUnrecognizedArguments(argumentCount,
+                                                 arguments.data()))
+      return 1;
+
+    double calibrationTime = loot::benchmarks::MeasureCalibrationTime();
+    std::cout << "Calibration time: " << calibrationTime << " s" << std::endl;
+
+    loot::benchmarks::RecordingReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+
+    if (updateBaseline) {
+      baseline.Update(reporter.GetTimes(), calibrationTime);
+      baseline.Save(baselinePath);
+      return 0;
+    }
+
+    std::cout << std::endl;
+    if (!baseline.Check(reporter.GetTimes(), calibrationTime, std::cout))
+      return 1;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,329 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_MASTERLIST_GENERATOR
+#define LOOT_BENCHMARKS_MASTERLIST_GENERATOR
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+namespace loot {
+namespace benchmarks {
+struct MasterlistGeneratorOptions {
+  MasterlistGeneratorOptions() :
+      entryCount(20000),
+      regexRatio(0.02),
+      messageRatio(0.3),
+      multilingualRatio(0.25),
+      anchoredMessageCount(50),
+      anchoredMessageRatio(0.3),
+      dirtyInfoRatio(0.1),
+      tagRatio(0.2),
+      fileRatio(0.3),
+      conditionRatio(0.4),
+      maxConditionDepth(3),
+      globalMessageCount(20),
+      seed(0) {}
+
+  size_t entryCount;
+  // The fraction of entries that have regex names.
+  double regexRatio;
+  double messageRatio;
+  // The fraction of messages that have content in several languages.
+  double multilingualRatio;
+  // Messages defined once under "common" and referenced by YAML aliases, like
+  // the real masterlists' shared messages.
+  size_t anchoredMessageCount;
+  // The fraction of messages that are aliases of anchored messages.
+  double anchoredMessageRatio;
+  double dirtyInfoRatio;
+  double tagRatio;
+  // The fraction of entries that have load after, requirement and
+  // incompatibility files.
+  double fileRatio;
+  // The fraction of messages, tags and files that have conditions.
+  double conditionRatio;
+  // How deeply conditions nest "and", "or" and "not" expressions.
+  size_t maxConditionDepth;
+  size_t globalMessageCount;
+  unsigned int seed;
+};
+
+// Generates masterlist YAML with the size and shape of the real masterlists.
+// Output only depends on the options and the given plugin names.
+class MasterlistGenerator {
+public:
+  // Entries are generated for the given plugins first, so that lookups and
+  // conditions can refer to plugins that exist, then for made-up plugins.
+  MasterlistGenerator(const MasterlistGeneratorOptions& options,
+                      const std::vector<std::string>& pluginNames =
+                          std::vector<std::string>()) :
+      options_(options),
+      pluginNames_(pluginNames) {}
+
+  std::string Generate() const {
+    std::mt19937 random(options_.seed);
+    std::ostringstream out;
+
+    out << "bash_tags:\n";
+    for (const auto& tag : GetTags()) {
+      out << "  - " << tag << "\n";
+    }
+
+    out << "common:\n";
+    for (size_t i = 0; i < options_.anchoredMessageCount; ++i) {
+      out << "  - &message" << i << "\n";
+      WriteMessageBody(out, "    ", random, false);
+    }
+
+    out << "globals:\n";
+    for (size_t i = 0; i < options_.globalMessageCount; ++i) {
+      out << "  - ";
+      WriteMessageBody(out, "    ", random, true, true);
+    }
+
+    out << "plugins:\n";
+    for (size_t i = 0; i < options_.entryCount; ++i) {
+      WriteEntry(out, i, random);
+    }
+
+    return out.str();
+  }
+
+  void Generate(const boost::filesystem::path& path) const {
+    boost::filesystem::ofstream out(path);
+    out << Generate();
+  }
+
+  // Returns the name of the entry at the given index, which is a regex for
+  // regex entries.
+  std::string GetEntryName(size_t index) const {
+    if (index < pluginNames_.size())
+      return pluginNames_[index];
+
+    char name[48];
+    std::snprintf(name, sizeof(name), "Synthetic Mod %06zu.esp", index);
+    return name;
+  }
+
+private:
+  void WriteEntry(std::ostringstream& out,
+                  size_t index,
+                  std::mt19937& random) const {
+    std::string name = GetEntryName(index);
+    bool isRegex = false;
+    if (index >= pluginNames_.size() && Chance(random, options_.regexRatio)) {
+      // Match a block of ten made-up plugins.
+      name = name.substr(0, name.length() - 5) + "\\d\\.esp";
+      isRegex = true;
+    }
+    out << "  - name: '" << name << "'\n";
+
+    if (Chance(random, options_.fileRatio)) {
+      WriteFiles(out, "after", random);
+      WriteFiles(out, "req", random);
+      if (Chance(random, 0.2))
+        WriteFiles(out, "inc", random);
+    }
+
+    if (Chance(random, options_.messageRatio)) {
+      out << "    msg:\n";
+      size_t count = Uniform(random, 1, 3);
+      for (size_t i = 0; i < count; ++i) {
+        if (options_.anchoredMessageCount > 0 &&
+            Chance(random, options_.anchoredMessageRatio)) {
+          out << "      - *message"
+              << Uniform(random, 0, options_.anchoredMessageCount - 1) << "\n";
+        } else {
+          out << "      - ";
+          WriteMessageBody(out, "        ", random, true, true);
+        }
+      }
+    }
+
+    if (Chance(random, options_.tagRatio)) {
+      // Tags are stored in a set, so each is only used once per entry.
+      auto tags = GetTags();
+      std::shuffle(tags.begin(), tags.end(), random);
+      out << "    tag:\n";
+      size_t count = Uniform(random, 1, 4);
+      for (size_t i = 0; i < count; ++i) {
+        std::string tag = tags[i];
+        if (Chance(random, 0.2))
+          tag = "-" + tag;
+
+        if (Chance(random, options_.conditionRatio)) {
+          out << "      - name: " << tag << "\n"
+              << "        condition: '" << GetCondition(random, 0) << "'\n";
+        } else {
+          out << "      - " << tag << "\n";
+        }
+      }
+    }
+
+    // Regex entries can't have dirty info.
+    if (!isRegex && Chance(random, options_.dirtyInfoRatio)) {
+      out << "    dirty:\n";
+      size_t count = Uniform(random, 1, 2);
+      for (size_t i = 0; i < count; ++i) {
+        char crc[16];
+        std::snprintf(crc,
+                      sizeof(crc),
+                      "0x%08X",
+                      static_cast<unsigned int>(random()));
+        out << "      - crc: " << crc << "\n"
+            << "        util: '[TES5Edit v3.2](http://www.nexusmods.com)'\n"
+            << "        itm: " << Uniform(random, 0, 200) << "\n"
+            << "        udr: " << Uniform(random, 0, 50) << "\n"
+            << "        nav: " << Uniform(random, 0, 2) << "\n";
+      }
+    }
+  }
+
+  void WriteFiles(std::ostringstream& out,
+                  const char* key,
+                  std::mt19937& random) const {
+    out << "    " << key << ":\n";
+    // Files are stored in a set, so each is only used once per key.
+    size_t count = Uniform(random, 1, 3);
+    std::set<size_t> indices;
+    while (indices.size() < count) {
+      indices.insert(Uniform(random, 0, options_.entryCount - 1));
+    }
+
+    for (size_t index : indices) {
+      std::string file = GetEntryName(index);
+      if (Chance(random, options_.conditionRatio)) {
+        out << "      - name: '" << file << "'\n"
+            << "        condition: '" << GetCondition(random, 0) << "'\n";
+      } else {
+        out << "      - '" << file << "'\n";
+      }
+    }
+  }
+
+  // Writes the keys of a message map. The first key is written without
+  // indentation so that it can follow a sequence item's dash or an anchor.
+  void WriteMessageBody(std::ostringstream& out,
+                        const std::string& indent,
+                        std::mt19937& random,
+                        bool allowCondition,
+                        bool firstKeyInline = false) const {
+    static const char* types[] = {"say", "warn", "error"};
+
+    out << (firstKeyInline ? "" : indent) << "type: "
+        << types[Uniform(random, 0, 2)] << "\n";
+
+    std::string text = "This is message number " +
+                       std::to_string(Uniform(random, 0, 100000)) +
+                       ", which has some **Markdown** and a [link]"
+                       "(http://example.com).";
+
+    if (Chance(random, options_.multilingualRatio)) {
+      static const char* languages[] = {"en", "de", "es", "fr", "ru", "zh_CN"};
+      out << indent << "content:\n";
+      for (const auto& language : languages) {
+        out << indent << "  - lang: " << language << "\n"
+            << indent << "    text: '" << language << ": " << text << "'\n";
+      }
+    } else {
+      out << indent << "content: '" << text << "'\n";
+    }
+
+    if (allowCondition && Chance(random, options_.conditionRatio)) {
+      out << indent << "condition: '" << GetCondition(random, 0) << "'\n";
+    }
+  }
+
+  // Builds a condition that nests up to the maximum depth, using every kind
+  // of condition function.
+  std::string GetCondition(std::mt19937& random, size_t depth) const {
+    if (depth < options_.maxConditionDepth && Chance(random, 0.5)) {
+      std::string left = GetCondition(random, depth + 1);
+      std::string right = GetCondition(random, depth + 1);
+      std::string op = Chance(random, 0.5) ? " and " : " or ";
+      std::string condition = "(" + left + op + right + ")";
+      if (Chance(random, 0.2))
+        condition = "not " + condition;
+
+      return condition;
+    }
+
+    std::string file =
+        GetEntryName(Uniform(random, 0, options_.entryCount - 1));
+    switch (Uniform(random, 0, 5)) {
+      case 0:
+        return "file(\"" + file + "\")";
+      case 1:
+        return "active(\"" + file + "\")";
+      case 2:
+        return "many(\"" + file.substr(0, file.length() - 6) +
+               ".*\\.esp\")";
+      case 3:
+        return "version(\"" + file + "\", \"1.0\", >=)";
+      case 4:
+        return "checksum(\"" + file + "\", DEADBEEF)";
+      default:
+        return "not file(\"" + file + "\")";
+    }
+  }
+
+  static std::vector<std::string> GetTags() {
+    return std::vector<std::string>({"Actors.ACBS",
+                                     "Actors.AIData",
+                                     "C.Climate",
+                                     "C.Water",
+                                     "Delev",
+                                     "Graphics",
+                                     "Invent",
+                                     "Names",
+                                     "Relev",
+                                     "Sound",
+                                     "Stats"});
+  }
+
+  static bool Chance(std::mt19937& random, double probability) {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(random) <
+           probability;
+  }
+
+  static size_t Uniform(std::mt19937& random, size_t min, size_t max) {
+    return std::uniform_int_distribution<size_t>(min, max)(random);
+  }
+
+  const MasterlistGeneratorOptions options_;
+  const std::vector<std::string> pluginNames_;
+};
+}
+}
+
+#endif
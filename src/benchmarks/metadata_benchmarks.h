@@ -0,0 +1,235 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_METADATA_BENCHMARKS
+#define LOOT_BENCHMARKS_METADATA_BENCHMARKS
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+
+#include "api/game/game.h"
+#include "api/metadata/condition_evaluator.h"
+#include "api/metadata_list.h"
+#include "benchmarks/allocation_counter.h"
+#include "benchmarks/generated_game.h"
+#include "benchmarks/masterlist_generator.h"
+
+namespace loot {
+namespace benchmarks {
+// A masterlist in a temporary directory with entries for a generated game's
+// plugins, followed by entries for plugins that aren't installed.
+class GeneratedMasterlist {
+public:
+  GeneratedMasterlist(const GeneratedGame& game,
+                      const MasterlistGeneratorOptions& options) :
+      rootPath_(boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("loot-benchmark-%%%%-%%%%")),
+      generator_(options, game.GetPlugins()) {
+    boost::filesystem::create_directories(rootPath_);
+    generator_.Generate(GetPath());
+  }
+
+  ~GeneratedMasterlist() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(rootPath_, ec);
+  }
+
+  boost::filesystem::path GetPath() const {
+    return rootPath_ / "masterlist.yaml";
+  }
+
+  // A path that benchmarks can save metadata to.
+  boost::filesystem::path GetOutputPath() const {
+    return rootPath_ / "output.yaml";
+  }
+
+  const MasterlistGenerator& GetGenerator() const { return generator_; }
+
+  // Masterlists are generated for the game with 1000 plugins, and are cached
+  // like generated games.
+  static const GeneratedMasterlist& Get(size_t entryCount) {
+    static std::map<size_t, std::unique_ptr<GeneratedMasterlist>> masterlists;
+
+    auto it = masterlists.find(entryCount);
+    if (it == masterlists.end()) {
+      MasterlistGeneratorOptions options;
+      options.entryCount = entryCount;
+
+      it = masterlists
+               .emplace(entryCount,
+                        std::unique_ptr<GeneratedMasterlist>(
+                            new GeneratedMasterlist(GetGame(), options)))
+               .first;
+    }
+
+    return *it->second;
+  }
+
+  static const GeneratedGame& GetGame() { return GeneratedGame::Get(1000); }
+
+private:
+  const boost::filesystem::path rootPath_;
+  const MasterlistGenerator generator_;
+};
+
+// Runs a benchmark at each of the masterlist sizes that metadata benchmarks
+// use. The real masterlists have between a few thousand and 20000 entries.
+inline void EntryCounts(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(5000)->Arg(20000)->Arg(50000);
+}
+
+static void BM_LoadMasterlist(::benchmark::State& state) {
+  const auto& masterlist = GeneratedMasterlist::Get(state.range(0));
+  AllocationTracker tracker;
+
+  while (state.KeepRunning()) {
+    MetadataList metadataList;
+    metadataList.Load(masterlist.GetPath());
+  }
+
+  tracker.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadMasterlist)
+    ->Apply(EntryCounts)
+    ->Unit(::benchmark::kMillisecond);
+
+// Looks up every installed plugin and the same number of plugins that only
+// regex entries or nothing match.
+static void BM_FindPlugin(::benchmark::State& state) {
+  const auto& masterlist = GeneratedMasterlist::Get(state.range(0));
+  const auto& plugins = GeneratedMasterlist::GetGame().GetPlugins();
+
+  MetadataList metadataList;
+  metadataList.Load(masterlist.GetPath());
+
+  std::vector<PluginMetadata> lookups;
+  for (size_t i = 0; i < 2 * plugins.size(); ++i) {
+    lookups.push_back(
+        PluginMetadata(masterlist.GetGenerator().GetEntryName(i)));
+  }
+
+  AllocationTracker tracker;
+  while (state.KeepRunning()) {
+    for (const auto& plugin : lookups) {
+      ::benchmark::DoNotOptimize(metadataList.FindPlugin(plugin));
+    }
+  }
+
+  tracker.Report(state);
+  state.SetItemsProcessed(state.iterations() * lookups.size());
+}
+BENCHMARK(BM_FindPlugin)->Apply(EntryCounts)->Unit(::benchmark::kMillisecond);
+
+static void BM_EvalAllConditions(::benchmark::State& state) {
+  const auto& masterlist = GeneratedMasterlist::Get(state.range(0));
+  const auto& generatedGame = GeneratedMasterlist::GetGame();
+  auto game = generatedGame.CreateGame();
+  game->LoadPlugins(generatedGame.GetPlugins(), true);
+
+  ConditionEvaluator evaluator(game->Type(),
+                               generatedGame.GetDataPath(),
+                               game->GetCache(),
+                               game->GetLoadOrderHandler());
+
+  MetadataList loadedList;
+  loadedList.Load(masterlist.GetPath());
+
+  AllocationTracker tracker;
+  while (state.KeepRunning()) {
+    // Evaluation replaces the list's metadata, so evaluate a fresh copy, and
+    // don't let conditions evaluated by earlier iterations be reused.
+    state.PauseTiming();
+    tracker.Pause();
+    MetadataList metadataList(loadedList);
+    game->GetCache()->ClearCachedConditions();
+    tracker.Resume();
+    state.ResumeTiming();
+
+    metadataList.EvalAllConditions(evaluator);
+  }
+
+  tracker.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EvalAllConditions)
+    ->Apply(EntryCounts)
+    ->Unit(::benchmark::kMillisecond);
+
+// Gets the evaluated metadata of every installed plugin, as a client does
+// after sorting.
+static void BM_GetPluginMetadata(::benchmark::State& state) {
+  const auto& masterlist = GeneratedMasterlist::Get(state.range(0));
+  const auto& generatedGame = GeneratedMasterlist::GetGame();
+  auto game = generatedGame.CreateGame();
+  game->LoadPlugins(generatedGame.GetPlugins(), true);
+  game->GetDatabase()->LoadLists(masterlist.GetPath().string());
+
+  AllocationTracker tracker;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    tracker.Pause();
+    game->GetCache()->ClearCachedConditions();
+    tracker.Resume();
+    state.ResumeTiming();
+
+    for (const auto& plugin : generatedGame.GetPlugins()) {
+      ::benchmark::DoNotOptimize(
+          game->GetDatabase()->GetPluginMetadata(plugin, true, true));
+    }
+  }
+
+  tracker.Report(state);
+  state.SetItemsProcessed(state.iterations() *
+                          generatedGame.GetPlugins().size());
+}
+BENCHMARK(BM_GetPluginMetadata)
+    ->Apply(EntryCounts)
+    ->Unit(::benchmark::kMillisecond);
+
+static void BM_SaveMasterlist(::benchmark::State& state) {
+  const auto& masterlist = GeneratedMasterlist::Get(state.range(0));
+
+  MetadataList metadataList;
+  metadataList.Load(masterlist.GetPath());
+
+  AllocationTracker tracker;
+  while (state.KeepRunning()) {
+    metadataList.Save(masterlist.GetOutputPath());
+  }
+
+  tracker.Report(state);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SaveMasterlist)
+    ->Apply(EntryCounts)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
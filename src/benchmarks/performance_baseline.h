@@ -0,0 +1,236 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_PERFORMANCE_BASELINE
+#define LOOT_BENCHMARKS_PERFORMANCE_BASELINE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <yaml-cpp/yaml.h>
+
+namespace loot {
+namespace benchmarks {
+// Times a fixed workload of string generation, hashing and sorting, which
+// is roughly the mix of work that LOOT does. Benchmark times are divided by
+// this time so that baselines recorded on one machine are comparable with
+// results from another. Returns the fastest of several runs in seconds.
+inline double MeasureCalibrationTime() {
+  double fastest = std::numeric_limits<double>::max();
+
+  for (int run = 0; run < 5; ++run) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::mt19937 random(0);
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 200000; ++i) {
+      strings.push_back("Calibration String " + std::to_string(random()));
+    }
+
+    size_t hash = 0;
+    for (const auto& string : strings) {
+      hash ^= std::hash<std::string>()(string);
+    }
+    std::sort(strings.begin(), strings.end());
+    ::benchmark::DoNotOptimize(hash);
+    ::benchmark::DoNotOptimize(strings.data());
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    fastest = std::min(fastest, elapsed.count());
+  }
+
+  return fastest;
+}
+
+// Records the fastest real time per iteration, in seconds, of each
+// benchmark that is run, while still writing the usual console output.
+class RecordingReporter : public ::benchmark::ConsoleReporter {
+public:
+  void ReportRuns(const std::vector<Run>& runs) override {
+    ConsoleReporter::ReportRuns(runs);
+
+    for (const auto& run : runs) {
+      if (run.error_occurred || run.iterations == 0)
+        continue;
+
+      double time = run.real_accumulated_time / run.iterations;
+      auto it = times_.find(run.benchmark_name);
+      if (it == times_.end())
+        times_.emplace(run.benchmark_name, time);
+      else
+        it->second = std::min(it->second, time);
+    }
+  }
+
+  const std::map<std::string, double>& GetTimes() const { return times_; }
+
+private:
+  std::map<std::string, double> times_;
+};
+
+// A checked-in list of benchmarks and their expected times, in multiples of
+// the calibration time. A benchmark regresses if it takes longer than its
+// expected time plus the tolerance, which is a fraction of that time.
+class PerformanceBaseline {
+public:
+  PerformanceBaseline() : tolerance_(0.25) {}
+
+  void Load(const boost::filesystem::path& path) {
+    if (!boost::filesystem::exists(path))
+      throw std::runtime_error("The baseline file \"" + path.string() +
+                               "\" does not exist.");
+
+    boost::filesystem::ifstream in(path);
+    YAML::Node node = YAML::Load(in);
+
+    if (node["tolerance"])
+      tolerance_ = node["tolerance"].as<double>();
+
+    if (!node["benchmarks"] || !node["benchmarks"].IsMap())
+      throw std::runtime_error("The baseline file \"" + path.string() +
+                               "\" has no benchmarks map.");
+
+    times_.clear();
+    for (const auto& benchmark : node["benchmarks"]) {
+      // Benchmarks that have no time recorded yet are run, but fail the check
+      // until a time is recorded for them.
+      double time = 0;
+      if (!benchmark.second.IsNull())
+        time = benchmark.second.as<double>();
+
+      times_.emplace(benchmark.first.as<std::string>(), time);
+    }
+  }
+
+  void Save(const boost::filesystem::path& path) const {
+    YAML::Emitter emitter;
+    emitter.SetIndent(2);
+    emitter.SetDoublePrecision(4);
+    emitter << YAML::Comment(
+                   "Benchmark times in multiples of the calibration time.")
+            << YAML::BeginMap << YAML::Key << "tolerance" << YAML::Value
+            << tolerance_ << YAML::Key << "benchmarks" << YAML::Value
+            << YAML::BeginMap;
+
+    for (const auto& time : times_) {
+      emitter << YAML::Key << time.first << YAML::Value;
+      if (time.second > 0)
+        emitter << time.second;
+      else
+        emitter << YAML::Null;
+    }
+
+    emitter << YAML::EndMap << YAML::EndMap;
+
+    boost::filesystem::ofstream out(path);
+    if (out.fail())
+      throw std::runtime_error("Couldn't open output file.");
+
+    out << emitter.c_str() << std::endl;
+  }
+
+  // Returns a --benchmark_filter value that matches only the baseline's
+  // benchmarks.
+  std::string GetFilter() const {
+    std::string filter;
+    for (const auto& time : times_) {
+      if (!filter.empty())
+        filter += "|";
+      filter += time.first;
+    }
+
+    return "^(" + filter + ")$";
+  }
+
+  // Replaces the baseline's times with the given results, which are in
+  // seconds.
+  void Update(const std::map<std::string, double>& results,
+              double calibrationTime) {
+    for (auto& time : times_) {
+      auto it = results.find(time.first);
+      if (it != results.end())
+        time.second = it->second / calibrationTime;
+    }
+  }
+
+  // Writes a line for each of the baseline's benchmarks comparing its result
+  // to the baseline, and returns false if any benchmark regressed, didn't run
+  // or has no recorded time.
+  bool Check(const std::map<std::string, double>& results,
+             double calibrationTime,
+             std::ostream& out) const {
+    bool passed = true;
+    for (const auto& time : times_) {
+      auto it = results.find(time.first);
+      if (it == results.end()) {
+        out << time.first << ": FAILED, the benchmark did not run\n";
+        passed = false;
+        continue;
+      }
+
+      double normalisedTime = it->second / calibrationTime;
+      if (time.second <= 0) {
+        out << time.first << ": " << normalisedTime
+            << ", FAILED, no baseline recorded\n";
+        passed = false;
+        continue;
+      }
+
+      double change = normalisedTime / time.second - 1;
+      char percentage[16];
+      std::snprintf(percentage, sizeof(percentage), "%+.1f%%", change * 100);
+
+      out << time.first << ": " << normalisedTime << " against "
+          << time.second << " (" << percentage << ")";
+      if (change > tolerance_) {
+        out << ", FAILED";
+        passed = false;
+      }
+      out << "\n";
+    }
+
+    return passed;
+  }
+
+private:
+  double tolerance_;
+  std::map<std::string, double> times_;
+};
+}
+}
+
+#endif
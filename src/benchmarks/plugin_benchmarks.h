@@ -0,0 +1,79 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_PLUGIN_BENCHMARKS
+#define LOOT_BENCHMARKS_PLUGIN_BENCHMARKS
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "api/helpers/crc.h"
+#include "api/plugin/plugin.h"
+#include "benchmarks/generated_game.h"
+
+namespace loot {
+namespace benchmarks {
+static void BM_GetCrc32(::benchmark::State& state) {
+  const auto& generatedGame = GeneratedGame::Get(state.range(0));
+  auto dataPath = generatedGame.GetDataPath();
+
+  while (state.KeepRunning()) {
+    for (const auto& plugin : generatedGame.GetPlugins()) {
+      ::benchmark::DoNotOptimize(GetCrc32(dataPath / plugin));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetCrc32)->Apply(PluginCounts)->Unit(::benchmark::kMillisecond);
+
+// Checks every pair of plugins for overlap, as sorting does.
+static void BM_DoFormIDsOverlap(::benchmark::State& state) {
+  const auto& generatedGame = GeneratedGame::Get(state.range(0));
+  auto game = generatedGame.CreateGame();
+  game->LoadPlugins(generatedGame.GetPlugins(), false);
+
+  auto pluginSet = game->GetCache()->GetPlugins();
+  std::vector<std::shared_ptr<const Plugin>> plugins(pluginSet.begin(),
+                                                     pluginSet.end());
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < plugins.size(); ++i) {
+      for (size_t j = i + 1; j < plugins.size(); ++j) {
+        ::benchmark::DoNotOptimize(plugins[i]->DoFormIDsOverlap(*plugins[j]));
+      }
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * plugins.size() *
+                          (plugins.size() - 1) / 2);
+}
+BENCHMARK(BM_DoFormIDsOverlap)
+    ->Apply(PluginCounts)
+    ->Unit(::benchmark::kMillisecond);
+}
+}
+
+#endif
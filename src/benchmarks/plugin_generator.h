@@ -0,0 +1,345 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_BENCHMARKS_PLUGIN_GENERATOR
+#define LOOT_BENCHMARKS_PLUGIN_GENERATOR
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "loot/enum/game_type.h"
+
+namespace loot {
+namespace benchmarks {
+// How the generated plugins depend on each other. Every plugin also has the
+// game's main master file as a master.
+enum struct MasterGraphShape {
+  // No other masters.
+  flat,
+  // Every plugin has the first generated plugin as a master.
+  star,
+  // Every plugin has the plugin generated before it as a master.
+  chain,
+  // Every plugin has up to maxMasters randomly chosen earlier plugins as
+  // masters. Master plugins only choose other master plugins.
+  random,
+};
+
+struct PluginGeneratorOptions {
+  PluginGeneratorOptions() :
+      pluginCount(100),
+      masterPluginCount(10),
+      recordsPerPlugin(100),
+      overrideRatio(0.5),
+      overlapRatio(0.2),
+      masterGraphShape(MasterGraphShape::random),
+      maxMasters(3),
+      archiveRatio(0.25),
+      seed(0) {}
+
+  // The number of plugins to generate, not counting the main master file.
+  size_t pluginCount;
+  // How many of the generated plugins are .esm files. These are generated
+  // first.
+  size_t masterPluginCount;
+  size_t recordsPerPlugin;
+  // The fraction of each plugin's records that override its masters' records.
+  double overrideRatio;
+  // The fraction of override records that are taken from a pool shared by
+  // all plugins with the same master, so that plugins' records overlap.
+  double overlapRatio;
+  MasterGraphShape masterGraphShape;
+  size_t maxMasters;
+  // The fraction of plugins that have an archive that they load.
+  double archiveRatio;
+  unsigned int seed;
+};
+
+// Writes valid plugins for a game into a data directory, with the given
+// numbers of records, overrides, overlaps, masters and archives. Only record
+// and group headers and the header record's subrecords are meaningful, as
+// they're all that esplugin reads.
+class PluginGenerator {
+public:
+  PluginGenerator(GameType gameType, const PluginGeneratorOptions& options) :
+      gameType_(gameType),
+      options_(options) {}
+
+  // Writes the plugins and returns their filenames in the order they were
+  // generated, starting with the main master file. Plugins' modification
+  // times increase in that order.
+  std::vector<std::string> Generate(
+      const boost::filesystem::path& dataPath) const {
+    boost::filesystem::create_directories(dataPath);
+
+    std::mt19937 random(options_.seed);
+    std::uniform_real_distribution<double> unitDistribution(0.0, 1.0);
+
+    std::vector<std::string> names({GetMasterFilename()});
+    for (size_t i = 1; i <= options_.pluginCount; ++i) {
+      char name[32];
+      std::snprintf(name,
+                    sizeof(name),
+                    "Generated %05zu.%s",
+                    i,
+                    i <= options_.masterPluginCount ? "esm" : "esp");
+      names.push_back(name);
+    }
+
+    // The number of new records that each plugin adds.
+    std::vector<size_t> newRecordCounts;
+    std::time_t timestamp = std::time(nullptr) - 24 * 60 * 60;
+
+    for (size_t i = 0; i < names.size(); ++i) {
+      auto masters = GetMasters(i, random);
+
+      size_t overrideCount = 0;
+      if (!masters.empty())
+        overrideCount = static_cast<size_t>(options_.recordsPerPlugin *
+                                            options_.overrideRatio);
+      size_t sharedCount =
+          static_cast<size_t>(overrideCount * options_.overlapRatio);
+
+      std::set<uint32_t> formIds;
+      for (size_t j = 0; j < overrideCount; ++j) {
+        uint32_t modIndex = static_cast<uint32_t>(j % masters.size());
+        size_t masterRecordCount = newRecordCounts[masters[modIndex]];
+        if (masterRecordCount == 0)
+          continue;
+
+        // Shared overrides pick the same records in every plugin, while the
+        // others are offset by the plugin's index to avoid overlapping.
+        size_t objectIndex = j < sharedCount ? j : i * overrideCount + j;
+        formIds.insert(GetFormId(modIndex, objectIndex % masterRecordCount));
+      }
+
+      size_t newCount = options_.recordsPerPlugin - overrideCount;
+      uint32_t ownModIndex = static_cast<uint32_t>(masters.size());
+      for (size_t j = 0; j < newCount; ++j) {
+        formIds.insert(GetFormId(ownModIndex, j));
+      }
+      newRecordCounts.push_back(newCount);
+
+      std::vector<std::string> masterNames;
+      for (const auto& master : masters) {
+        masterNames.push_back(names[master]);
+      }
+
+      boost::filesystem::path pluginPath = dataPath / names[i];
+      WritePlugin(pluginPath,
+                  pluginPath.extension() == ".esm",
+                  masterNames,
+                  formIds);
+      boost::filesystem::last_write_time(pluginPath, timestamp + i * 60);
+
+      if (i > 0 && unitDistribution(random) < options_.archiveRatio)
+        WriteArchive(dataPath, names[i]);
+    }
+
+    return names;
+  }
+
+  std::string GetMasterFilename() const {
+    if (gameType_ == GameType::tes4)
+      return "Oblivion.esm";
+    else if (gameType_ == GameType::tes5 || gameType_ == GameType::tes5se)
+      return "Skyrim.esm";
+    else if (gameType_ == GameType::fo3)
+      return "Fallout3.esm";
+    else if (gameType_ == GameType::fonv)
+      return "FalloutNV.esm";
+    else
+      return "Fallout4.esm";
+  }
+
+private:
+  // Returns the indices of the plugin's masters in generation order.
+  std::vector<size_t> GetMasters(size_t index, std::mt19937& random) const {
+    if (index == 0)
+      return std::vector<size_t>();
+
+    std::vector<size_t> masters({0});
+    if (options_.masterGraphShape == MasterGraphShape::star && index > 1) {
+      masters.push_back(1);
+    } else if (options_.masterGraphShape == MasterGraphShape::chain &&
+               index > 1) {
+      masters.push_back(index - 1);
+    } else if (options_.masterGraphShape == MasterGraphShape::random &&
+               index > 1) {
+      // Master plugins are generated first, so only have earlier master
+      // plugins to choose from.
+      std::uniform_int_distribution<size_t> distribution(1, index - 1);
+      size_t count = std::min(index - 1, options_.maxMasters);
+      std::set<size_t> chosen;
+      while (chosen.size() < count) {
+        chosen.insert(distribution(random));
+      }
+      masters.insert(masters.end(), chosen.begin(), chosen.end());
+    }
+
+    return masters;
+  }
+
+  static uint32_t GetFormId(uint32_t modIndex, size_t objectIndex) {
+    // Object indices below 0x800 are reserved.
+    return (modIndex << 24) | static_cast<uint32_t>(0x800 + objectIndex);
+  }
+
+  void WritePlugin(const boost::filesystem::path& path,
+                   bool isMaster,
+                   const std::vector<std::string>& masters,
+                   const std::set<uint32_t>& formIds) const {
+    std::string header;
+    AppendSubrecord(header, "HEDR", GetHeaderData(formIds.size()));
+    AppendSubrecord(header, "CNAM", std::string("LOOT", 5));
+    AppendSubrecord(header,
+                    "SNAM",
+                    "A plugin generated for benchmarking." + std::string(1, 0));
+    for (const auto& master : masters) {
+      AppendSubrecord(header, "MAST", master + std::string(1, 0));
+      AppendSubrecord(header, "DATA", std::string(8, 0));
+    }
+
+    std::string records;
+    for (const auto& formId : formIds) {
+      char editorId[16];
+      std::snprintf(editorId, sizeof(editorId), "Rec%08X", formId);
+
+      std::string data;
+      AppendSubrecord(data, "EDID", std::string(editorId, 12));
+      AppendRecord(records, "MISC", 0, formId, data);
+    }
+
+    std::string plugin;
+    AppendRecord(plugin, "TES4", isMaster ? 0x1 : 0, 0, header);
+    if (!records.empty())
+      AppendGroup(plugin, "MISC", records);
+
+    boost::filesystem::ofstream out(path, std::ios::binary);
+    out.write(plugin.data(), plugin.size());
+  }
+
+  void WriteArchive(const boost::filesystem::path& dataPath,
+                    const std::string& pluginName) const {
+    std::string basename = pluginName.substr(0, pluginName.length() - 4);
+    std::string filename;
+    if (gameType_ == GameType::fo4)
+      filename = basename + " - Main.ba2";
+    else
+      filename = basename + ".bsa";
+
+    // LOOT only checks that archives exist, so the content doesn't matter.
+    boost::filesystem::ofstream out(dataPath / filename, std::ios::binary);
+    out << "BSA";
+  }
+
+  std::string GetHeaderData(size_t recordCount) const {
+    float version = 0.94f;
+    if (gameType_ == GameType::tes4)
+      version = 1.0f;
+    else if (gameType_ == GameType::tes5se)
+      version = 1.7f;
+    else if (gameType_ == GameType::fonv)
+      version = 1.34f;
+    else if (gameType_ == GameType::fo4)
+      version = 0.95f;
+
+    uint32_t versionBits;
+    std::memcpy(&versionBits, &version, sizeof(versionBits));
+
+    std::string data;
+    AppendInteger(data, versionBits, 4);
+    AppendInteger(data, recordCount, 4);
+    AppendInteger(data, 0x800 + recordCount, 4);
+    return data;
+  }
+
+  // Oblivion's record and group headers are 4 bytes shorter than those of
+  // later games.
+  bool HasLongHeaders() const { return gameType_ != GameType::tes4; }
+
+  void AppendRecord(std::string& buffer,
+                    const char* type,
+                    uint32_t flags,
+                    uint32_t formId,
+                    const std::string& data) const {
+    buffer.append(type, 4);
+    AppendInteger(buffer, data.size(), 4);
+    AppendInteger(buffer, flags, 4);
+    AppendInteger(buffer, formId, 4);
+    AppendInteger(buffer, 0, 4);
+    if (HasLongHeaders())
+      AppendInteger(buffer, 0, 4);
+    buffer.append(data);
+  }
+
+  void AppendGroup(std::string& buffer,
+                   const char* label,
+                   const std::string& records) const {
+    size_t headerSize = HasLongHeaders() ? 24 : 20;
+
+    buffer.append("GRUP", 4);
+    AppendInteger(buffer, headerSize + records.size(), 4);
+    buffer.append(label, 4);
+    AppendInteger(buffer, 0, 4);
+    AppendInteger(buffer, 0, 4);
+    if (HasLongHeaders())
+      AppendInteger(buffer, 0, 4);
+    buffer.append(records);
+  }
+
+  static void AppendSubrecord(std::string& buffer,
+                              const char* type,
+                              const std::string& data) {
+    buffer.append(type, 4);
+    AppendInteger(buffer, data.size(), 2);
+    buffer.append(data);
+  }
+
+  // Plugins are little-endian.
+  static void AppendInteger(std::string& buffer,
+                            uint64_t value,
+                            size_t byteCount) {
+    for (size_t i = 0; i < byteCount; ++i) {
+      buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+  }
+
+  const GameType gameType_;
+  const PluginGeneratorOptions options_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "cli/batch_sorter.h"
+
+#include <stdexcept>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "api/api_database.h"
+#include "api/game/game.h"
+#include "api/helpers/executor.h"
+#include "api/helpers/game_type.h"
+#include "api/helpers/memory_accounting.h"
+#include "api/plugin/plugin_sorter.h"
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+
+namespace loot {
+namespace cli {
+namespace {
+std::string GetPath(const pt::ptree& install,
+                    const std::string& key,
+                    const fs::path& basePath) {
+  const std::string path = install.get<std::string>(key, "");
+  if (path.empty())
+    return path;
+
+  return fs::absolute(path, basePath).lexically_normal().string();
+}
+
+pt::ptree ToArray(const std::vector<std::string>& strings) {
+  pt::ptree array;
+  for (const auto& string : strings) {
+    pt::ptree element;
+    element.put_value(string);
+    array.push_back(std::make_pair("", element));
+  }
+
+  return array;
+}
+
+// Times are written in milliseconds.
+double ToMilliseconds(std::chrono::nanoseconds time) {
+  return std::chrono::duration<double, std::milli>(time).count();
+}
+
+std::chrono::nanoseconds GetElapsedTime(
+    std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+pt::ptree ToTree(const InstallResult& result) {
+  pt::ptree tree;
+  tree.put("name", result.name);
+  if (result.isSorted) {
+    tree.put("status", "ok");
+    tree.add_child("load_order", ToArray(result.loadOrder));
+  } else {
+    tree.put("status", "error");
+    tree.put("message", result.error);
+  }
+
+  tree.put("masterlist_cache_hit", result.isMasterlistCacheHit);
+  tree.put("timings.load_lists_ms", ToMilliseconds(result.loadListsTime));
+  tree.put("timings.load_plugins_ms", ToMilliseconds(result.loadPluginsTime));
+  tree.put("timings.sort_ms", ToMilliseconds(result.sortTime));
+  tree.put("timings.total_ms", ToMilliseconds(result.totalTime));
+
+  return tree;
+}
+
+pt::ptree ToTree(const GameStatistics& statistics) {
+  pt::ptree tree;
+  tree.put("plugins_parsed", statistics.plugins_parsed);
+  tree.put("bytes_read", statistics.bytes_read);
+  tree.put("crcs_computed", statistics.crcs_computed);
+  tree.put("esplugin_calls", statistics.esplugin_calls);
+  tree.put("libloadorder_calls", statistics.libloadorder_calls);
+  tree.put("condition_cache_hits", statistics.condition_cache_hits);
+  tree.put("condition_cache_misses", statistics.condition_cache_misses);
+  tree.put("regex_compilations", statistics.regex_compilations);
+  tree.put("metadata_lookups", statistics.metadata_lookups);
+  tree.put("load_plugins_ms", ToMilliseconds(statistics.load_plugins_time));
+  tree.put("sort_plugins_ms", ToMilliseconds(statistics.sort_plugins_time));
+  tree.put("load_lists_ms", ToMilliseconds(statistics.load_lists_time));
+  tree.put("game_cache_lock_wait_ms",
+           ToMilliseconds(statistics.game_cache_lock_wait_time));
+  tree.put("logging_lock_wait_ms",
+           ToMilliseconds(statistics.logging_lock_wait_time));
+
+  return tree;
+}
+}
+
+std::vector<InstallJob> ReadManifest(std::istream& in,
+                                     const fs::path& basePath) {
+  pt::ptree manifest;
+  pt::read_json(in, manifest);
+
+  std::vector<InstallJob> jobs;
+  for (const auto& child : manifest.get_child("installs")) {
+    const pt::ptree& install = child.second;
+
+    InstallJob job;
+    job.gameType = ParseGameType(install.get<std::string>("game"));
+    job.gamePath = GetPath(install, "game_path", basePath);
+    if (job.gamePath.empty())
+      throw std::invalid_argument("An install has no game path.");
+
+    job.name = install.get<std::string>("name", job.gamePath);
+    job.localPath = GetPath(install, "local_path", basePath);
+    job.masterlistPath = GetPath(install, "masterlist_path", basePath);
+    job.userlistPath = GetPath(install, "userlist_path", basePath);
+    job.mainMasterFile = install.get<std::string>("main_master_file", "");
+
+    for (const auto& plugin : install.get_child("plugins", pt::ptree())) {
+      job.plugins.push_back(plugin.second.get_value<std::string>());
+    }
+
+    jobs.push_back(job);
+  }
+
+  return jobs;
+}
+
+std::vector<InstallResult> BatchSorter::Sort(
+    const std::vector<InstallJob>& jobs,
+    size_t maxParallelInstalls) {
+  std::vector<InstallResult> results(jobs.size());
+  ParallelFor(jobs.size(),
+              [&](size_t index) { results[index] = SortInstall(jobs[index]); },
+              maxParallelInstalls);
+
+  return results;
+}
+
+const MasterlistCache& BatchSorter::GetMasterlistCache() const {
+  return masterlistCache_;
+}
+
+InstallResult BatchSorter::SortInstall(const InstallJob& job) {
+  InstallResult result;
+  result.name = job.name;
+
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    if (!fs::is_directory(job.gamePath))
+      throw std::invalid_argument("Given game path \"" + job.gamePath +
+                                  "\" does not resolve to a valid directory.");
+
+    Game game(job.gameType, job.gamePath, job.localPath);
+    if (!job.mainMasterFile.empty())
+      game.IdentifyMainMasterFile(job.mainMasterFile);
+
+    auto stageStart = std::chrono::steady_clock::now();
+    auto database = std::static_pointer_cast<ApiDatabase>(game.GetDatabase());
+    if (job.masterlistPath.empty()) {
+      database->LoadLists("", job.userlistPath);
+    } else {
+      auto parsed = masterlistCache_.Get(job.masterlistPath,
+                                         result.isMasterlistCacheHit);
+      database->LoadLists(job.masterlistPath,
+                          *parsed.masterlist,
+                          parsed.identity,
+                          job.userlistPath);
+    }
+    result.loadListsTime = GetElapsedTime(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
+    std::vector<std::string> plugins = job.plugins;
+    if (plugins.empty()) {
+      game.LoadCurrentLoadOrderState();
+      plugins = game.GetLoadOrder();
+    }
+    game.LoadPlugins(plugins, false);
+    result.loadPluginsTime = GetElapsedTime(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
+    {
+      MemoryScope memoryScope(MemorySubsystem::sorting);
+      PluginSorter sorter;
+      result.loadOrder = sorter.Sort(game);
+    }
+    result.sortTime = GetElapsedTime(stageStart);
+
+    result.isSorted = true;
+  } catch (std::exception& e) {
+    result.error = e.what();
+  }
+  result.totalTime = GetElapsedTime(start);
+
+  return result;
+}
+
+void WriteReport(std::ostream& out,
+                 const std::vector<InstallResult>& results,
+                 const MasterlistCache& masterlistCache,
+                 const GameStatistics& statistics,
+                 std::chrono::nanoseconds totalTime) {
+  pt::ptree installs;
+  size_t sortedCount = 0;
+  for (const auto& result : results) {
+    installs.push_back(std::make_pair("", ToTree(result)));
+    if (result.isSorted)
+      ++sortedCount;
+  }
+
+  pt::ptree report;
+  report.add_child("installs", installs);
+  report.put("installs_sorted", sortedCount);
+  report.put("installs_failed", results.size() - sortedCount);
+  report.put("total_ms", ToMilliseconds(totalTime));
+  report.put("masterlist_cache.hits", masterlistCache.GetHitCount());
+  report.put("masterlist_cache.misses", masterlistCache.GetMissCount());
+  report.put("masterlist_cache.parse_ms",
+             ToMilliseconds(masterlistCache.GetParseTime()));
+  report.add_child("statistics", ToTree(statistics));
+
+  pt::write_json(out, report);
+}
+}
+}
@@ -0,0 +1,118 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_CLI_BATCH_SORTER
+#define LOOT_CLI_BATCH_SORTER
+
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "cli/masterlist_cache.h"
+#include "loot/enum/game_type.h"
+#include "loot/struct/game_statistics.h"
+
+namespace loot {
+namespace cli {
+// A game install or profile to sort, as given in the manifest.
+struct InstallJob {
+  InstallJob() : gameType(GameType::tes4) {}
+
+  std::string name;
+  GameType gameType;
+  std::string gamePath;
+  std::string localPath;
+  std::string masterlistPath;
+  std::string userlistPath;
+  std::string mainMasterFile;
+  // If empty, the plugins in the install's current load order are sorted.
+  std::vector<std::string> plugins;
+};
+
+struct InstallResult {
+  InstallResult() :
+      isSorted(false),
+      isMasterlistCacheHit(false),
+      loadListsTime(0),
+      loadPluginsTime(0),
+      sortTime(0),
+      totalTime(0) {}
+
+  std::string name;
+  bool isSorted;
+  std::string error;
+  std::vector<std::string> loadOrder;
+  bool isMasterlistCacheHit;
+  std::chrono::nanoseconds loadListsTime;
+  std::chrono::nanoseconds loadPluginsTime;
+  std::chrono::nanoseconds sortTime;
+  std::chrono::nanoseconds totalTime;
+};
+
+// Reads the installs from a JSON manifest of the form:
+//
+//   {"installs": [{"name": "...", "game": "tes5", "game_path": "...",
+//                  "local_path": "...", "masterlist_path": "...",
+//                  "userlist_path": "...", "main_master_file": "...",
+//                  "plugins": ["...", ...]}, ...]}
+//
+// Only "game" and "game_path" are required, and each install is named by its
+// game path if it has no name. Relative paths are resolved against
+// basePath. Throws if the manifest is invalid.
+std::vector<InstallJob> ReadManifest(std::istream& in,
+                                     const boost::filesystem::path& basePath);
+
+// Sorts the load orders of several installs in parallel, using a new game
+// handle for each install and sharing parsed masterlists between them.
+class BatchSorter {
+public:
+  // Runs up to maxParallelInstalls installs at once, or as many as the API's
+  // concurrency budget allows if it's zero. An install that fails doesn't
+  // stop the others from being sorted.
+  std::vector<InstallResult> Sort(const std::vector<InstallJob>& jobs,
+                                  size_t maxParallelInstalls = 0);
+
+  const MasterlistCache& GetMasterlistCache() const;
+
+private:
+  InstallResult SortInstall(const InstallJob& job);
+
+  MasterlistCache masterlistCache_;
+};
+
+// Writes the results, the masterlist cache's counts, the API's statistics
+// for the whole run and the run's duration as JSON.
+void WriteReport(std::ostream& out,
+                 const std::vector<InstallResult>& results,
+                 const MasterlistCache& masterlistCache,
+                 const GameStatistics& statistics,
+                 std::chrono::nanoseconds totalTime);
+}
+}
+
+#endif
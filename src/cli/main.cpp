@@ -0,0 +1,148 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/locale.hpp>
+
+#include "api/helpers/statistics.h"
+#include "cli/batch_sorter.h"
+#include "loot/api.h"
+
+namespace {
+const char* const USAGE =
+    "Usage: loot_cli <manifest path> [--output <report path>]\n"
+    "                [--max-concurrency <threads>] [--parallel-installs <n>]\n"
+    "                [--trace <trace path>] [--verbose]";
+
+struct Options {
+  Options() : maxConcurrency(0), parallelInstalls(0), isVerbose(false) {}
+
+  std::string manifestPath;
+  std::string outputPath;
+  std::string tracePath;
+  unsigned int maxConcurrency;
+  size_t parallelInstalls;
+  bool isVerbose;
+};
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--verbose") == 0) {
+      options.isVerbose = true;
+    } else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+      options.outputPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+      options.tracePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--max-concurrency") == 0 && hasValue) {
+      options.maxConcurrency = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--parallel-installs") == 0 && hasValue) {
+      options.parallelInstalls = std::strtoul(argv[++i], nullptr, 10);
+    } else if (argv[i][0] != '-' && options.manifestPath.empty()) {
+      options.manifestPath = argv[i];
+    } else {
+      return false;
+    }
+  }
+
+  return !options.manifestPath.empty();
+}
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << USAGE << std::endl;
+    return 1;
+  }
+
+  // Set the locale to get encoding conversions working correctly.
+  std::locale::global(boost::locale::generator().generate(""));
+  boost::filesystem::path::imbue(std::locale());
+
+  if (options.isVerbose) {
+    loot::SetLoggingCallback([](loot::LogLevel, const char* message) {
+      std::cerr << message << std::endl;
+    });
+  }
+
+  loot::SetMaxConcurrency(options.maxConcurrency);
+
+  try {
+    boost::filesystem::path manifestPath(options.manifestPath);
+    boost::filesystem::ifstream manifest(manifestPath);
+    if (!manifest)
+      throw std::runtime_error("Couldn't open the manifest at " +
+                               manifestPath.string());
+
+    auto jobs = loot::cli::ReadManifest(
+        manifest, boost::filesystem::absolute(manifestPath).parent_path());
+
+    if (!options.tracePath.empty())
+      loot::StartTracing();
+
+    const auto baseline = loot::GetStatisticValues();
+    const auto start = std::chrono::steady_clock::now();
+
+    loot::cli::BatchSorter sorter;
+    auto results = sorter.Sort(jobs, options.parallelInstalls);
+
+    const auto totalTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+    const auto statistics =
+        loot::ToGameStatistics(loot::GetStatisticValues(), baseline);
+
+    if (!options.tracePath.empty())
+      loot::StopTracing(options.tracePath);
+
+    if (options.outputPath.empty()) {
+      loot::cli::WriteReport(std::cout,
+                             results,
+                             sorter.GetMasterlistCache(),
+                             statistics,
+                             totalTime);
+    } else {
+      boost::filesystem::ofstream out(options.outputPath);
+      loot::cli::WriteReport(
+          out, results, sorter.GetMasterlistCache(), statistics, totalTime);
+    }
+
+    for (const auto& result : results) {
+      if (!result.isSorted)
+        return 2;
+    }
+  } catch (std::exception& e) {
+    std::cerr << "The batch failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "cli/masterlist_cache.h"
+
+#include "loot/exception/file_access_error.h"
+
+namespace fs = boost::filesystem;
+
+namespace loot {
+namespace cli {
+MasterlistCache::MasterlistCache() :
+    hitCount_(0),
+    missCount_(0),
+    parseTime_(0) {}
+
+ParsedMasterlist MasterlistCache::Get(const fs::path& path, bool& isHit) {
+  const std::string key = fs::absolute(path).lexically_normal().string();
+
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& slot = entries_[key];
+    if (!slot)
+      slot = std::make_shared<Entry>();
+    entry = slot;
+  }
+
+  // Only installs using the same masterlist wait for each other.
+  std::lock_guard<std::mutex> entryGuard(entry->mutex);
+
+  // The identity is read before the file, so that a change while it's being
+  // read doesn't go unnoticed.
+  FileIdentity identity = FileIdentity::Get(path);
+  isHit = entry->parsed.masterlist && entry->parsed.identity == identity;
+  if (!isHit) {
+    if (!identity.exists)
+      throw FileAccessError("The given masterlist path does not exist: " +
+                            path.string());
+
+    auto start = std::chrono::steady_clock::now();
+    auto masterlist = std::make_shared<Masterlist>();
+    masterlist->Load(path);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    entry->parsed.identity = identity;
+    entry->parsed.masterlist = masterlist;
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++missCount_;
+    parseTime_ +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+  } else {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++hitCount_;
+  }
+
+  return entry->parsed;
+}
+
+size_t MasterlistCache::GetHitCount() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return hitCount_;
+}
+
+size_t MasterlistCache::GetMissCount() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return missCount_;
+}
+
+std::chrono::nanoseconds MasterlistCache::GetParseTime() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return parseTime_;
+}
+}
+}
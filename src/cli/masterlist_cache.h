@@ -0,0 +1,80 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_CLI_MASTERLIST_CACHE
+#define LOOT_CLI_MASTERLIST_CACHE
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "api/helpers/file_identity.h"
+#include "api/masterlist.h"
+
+namespace loot {
+namespace cli {
+// A masterlist that has been parsed, and the identity of the file that it
+// was parsed from.
+struct ParsedMasterlist {
+  FileIdentity identity;
+  std::shared_ptr<const Masterlist> masterlist;
+};
+
+// Parses each masterlist once for all the installs that use it, and parses it
+// again only if its file's size or modification time changes. Installs that
+// get a masterlist while another install is parsing it wait for it instead of
+// parsing it too.
+class MasterlistCache {
+public:
+  MasterlistCache();
+
+  // Throws if the masterlist doesn't exist or can't be parsed. isHit is set
+  // to whether an already-parsed masterlist was returned.
+  ParsedMasterlist Get(const boost::filesystem::path& path, bool& isHit);
+
+  size_t GetHitCount() const;
+  size_t GetMissCount() const;
+  std::chrono::nanoseconds GetParseTime() const;
+
+private:
+  struct Entry {
+    std::mutex mutex;
+    ParsedMasterlist parsed;
+  };
+
+  mutable std::mutex mutex_;
+  // Keyed by absolute, normalised path.
+  std::map<std::string, std::shared_ptr<Entry>> entries_;
+  size_t hitCount_;
+  size_t missCount_;
+  std::chrono::nanoseconds parseTime_;
+};
+}
+}
+
+#endif
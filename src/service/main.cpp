@@ -0,0 +1,64 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include <cstring>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+#include <boost/locale.hpp>
+
+#include "loot/api.h"
+#include "service/socket_server.h"
+#include "service/sort_service.h"
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3 ||
+      (argc == 3 && std::strcmp(argv[2], "--verbose") != 0)) {
+    std::cerr << "Usage: loot_service <socket path> [--verbose]" << std::endl;
+    return 1;
+  }
+
+  // Set the locale to get encoding conversions working correctly.
+  std::locale::global(boost::locale::generator().generate(""));
+  boost::filesystem::path::imbue(std::locale());
+
+  if (argc == 3) {
+    loot::SetLoggingCallback([](loot::LogLevel, const char* message) {
+      std::cerr << message << std::endl;
+    });
+  }
+
+  try {
+    loot::service::SortService service;
+    loot::service::SocketServer server(service, argv[1]);
+
+    std::cout << "Listening on " << argv[1] << std::endl;
+    server.Run();
+  } catch (std::exception& e) {
+    std::cerr << "The service stopped: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
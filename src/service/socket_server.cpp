@@ -0,0 +1,200 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "service/socket_server.h"
+
+#include <algorithm>
+#include <istream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include "api/helpers/logging.h"
+
+using boost::asio::local::stream_protocol;
+
+namespace loot {
+namespace service {
+namespace {
+// A socket file left by a previous run stops the socket being bound, so is
+// removed, but only if nothing is listening on it. Anything else at the path
+// is left alone.
+void RemoveStaleSocket(boost::asio::io_service& ioService,
+                       const std::string& socketPath) {
+  struct stat status;
+  if (lstat(socketPath.c_str(), &status) != 0)
+    return;
+
+  if (!S_ISSOCK(status.st_mode))
+    throw std::runtime_error("\"" + socketPath +
+                             "\" already exists and is not a socket.");
+
+  stream_protocol::socket socket(ioService);
+  boost::system::error_code ec;
+  socket.connect(stream_protocol::endpoint(socketPath), ec);
+  if (!ec)
+    throw std::runtime_error("Another server is already listening on \"" +
+                             socketPath + "\".");
+
+  boost::filesystem::remove(socketPath);
+}
+}
+
+// Reads a client's requests and writes their responses, one at a time. A
+// session is kept alive by its pending read or write, and is destroyed once
+// the client disconnects or an error stops it.
+class SocketServer::Session : public std::enable_shared_from_this<Session> {
+public:
+  Session(boost::asio::io_service& ioService, SortService& service) :
+      socket_(ioService),
+      service_(service),
+      buffer_(maxRequestSize) {}
+
+  stream_protocol::socket& GetSocket() { return socket_; }
+
+  void ReadRequest() {
+    auto self = shared_from_this();
+    boost::asio::async_read_until(
+        socket_,
+        buffer_,
+        '\n',
+        [self](const boost::system::error_code& ec, size_t) {
+          self->HandleRequest(ec);
+        });
+  }
+
+private:
+  void HandleRequest(const boost::system::error_code& ec) {
+    auto logger = getLogger();
+    if (ec == boost::asio::error::not_found) {
+      // The buffer is full but doesn't hold a whole request, so the rest of
+      // the client's input can't be split into requests.
+      LOOT_LOG_DEBUG(logger, "Received a request that is too large.");
+      WriteResponse(SortService::ErrorResponse(
+                        "Requests must be no larger than " +
+                        std::to_string(maxRequestSize) + " bytes."),
+                    false);
+      return;
+    } else if (ec) {
+      // The client has disconnected.
+      LOOT_LOG_DEBUG(logger, "Stopped reading requests: {}", ec.message());
+      return;
+    }
+
+    std::istream in(&buffer_);
+    std::string request;
+    std::getline(in, request);
+    if (request.empty()) {
+      ReadRequest();
+      return;
+    }
+
+    WriteResponse(service_.HandleRequest(request), true);
+  }
+
+  void WriteResponse(const std::string& response, bool readNextRequest) {
+    response_ = response;
+
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        socket_,
+        boost::asio::buffer(response_),
+        [self, readNextRequest](const boost::system::error_code& ec, size_t) {
+          if (ec) {
+            auto logger = getLogger();
+            LOOT_LOG_DEBUG(
+                logger, "Failed to write a response: {}", ec.message());
+          } else if (readNextRequest)
+            self->ReadRequest();
+        });
+  }
+
+  stream_protocol::socket socket_;
+  SortService& service_;
+  boost::asio::streambuf buffer_;
+  std::string response_;
+};
+
+SocketServer::SocketServer(SortService& service,
+                           const std::string& socketPath,
+                           size_t threadCount) :
+    service_(service),
+    socketPath_(socketPath),
+    threadCount_(threadCount == 0
+                     ? std::max(1u, std::thread::hardware_concurrency())
+                     : threadCount) {}
+
+void SocketServer::Run() {
+  RemoveStaleSocket(ioService_, socketPath_);
+
+  acceptor_.reset(new stream_protocol::acceptor(
+      ioService_, stream_protocol::endpoint(socketPath_)));
+  Accept();
+
+  // The calling thread is one of the pool's threads. If the others can't all
+  // be started, stop the ones that were before rethrowing.
+  std::vector<std::thread> threads;
+  try {
+    for (size_t i = 1; i < threadCount_; ++i) {
+      threads.emplace_back([this]() { ioService_.run(); });
+    }
+    ioService_.run();
+  } catch (...) {
+    ioService_.stop();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    throw;
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  throw boost::system::system_error(acceptError_);
+}
+
+// Only one accept is pending at a time, so its handler never runs
+// concurrently with itself.
+void SocketServer::Accept() {
+  auto session = std::make_shared<Session>(ioService_, service_);
+  acceptor_->async_accept(
+      session->GetSocket(),
+      [this, session](const boost::system::error_code& ec) {
+        if (ec) {
+          acceptError_ = ec;
+          ioService_.stop();
+          return;
+        }
+
+        session->ReadRequest();
+        Accept();
+      });
+}
+}
+}
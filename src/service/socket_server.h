@@ -0,0 +1,72 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_SERVICE_SOCKET_SERVER
+#define LOOT_SERVICE_SOCKET_SERVER
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <boost/asio.hpp>
+
+#include "service/sort_service.h"
+
+namespace loot {
+namespace service {
+// Listens on a Unix domain socket for clients that send requests as single
+// lines of JSON, and writes each response as a single line. Clients may send
+// any number of requests, which are read and handled asynchronously by a
+// fixed pool of threads. A client that sends a request longer than
+// maxRequestSize bytes is sent an error response and disconnected.
+class SocketServer {
+public:
+  static constexpr size_t maxRequestSize = 1024 * 1024;
+
+  // A thread count of zero uses one thread for each hardware thread.
+  SocketServer(SortService& service,
+               const std::string& socketPath,
+               size_t threadCount = 0);
+
+  // Accepts clients until an error occurs. A socket left at the socket path by
+  // a server that has stopped is replaced, but throws if anything else is
+  // there.
+  void Run();
+
+private:
+  class Session;
+
+  void Accept();
+
+  SortService& service_;
+  const std::string socketPath_;
+  const size_t threadCount_;
+  boost::asio::io_service ioService_;
+  std::unique_ptr<boost::asio::local::stream_protocol::acceptor> acceptor_;
+  boost::system::error_code acceptError_;
+};
+}
+}
+
+#endif
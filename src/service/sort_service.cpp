@@ -0,0 +1,262 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "service/sort_service.h"
+
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "api/helpers/game_type.h"
+#include "api/metadata/yaml/plugin_metadata.h"
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+
+namespace loot {
+namespace service {
+namespace {
+std::vector<std::string> GetStrings(const pt::ptree& request,
+                                    const std::string& key) {
+  std::vector<std::string> strings;
+  for (const auto& child : request.get_child(key, pt::ptree())) {
+    strings.push_back(child.second.get_value<std::string>());
+  }
+
+  return strings;
+}
+
+std::string ToJson(const std::string& string) {
+  std::string json = "\"";
+  for (const char character : string) {
+    switch (character) {
+      case '"':
+        json += "\\\"";
+        break;
+      case '\\':
+        json += "\\\\";
+        break;
+      case '\b':
+        json += "\\b";
+        break;
+      case '\f':
+        json += "\\f";
+        break;
+      case '\n':
+        json += "\\n";
+        break;
+      case '\r':
+        json += "\\r";
+        break;
+      case '\t':
+        json += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(character) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped,
+                        sizeof(escaped),
+                        "\\u%04X",
+                        static_cast<unsigned int>(character));
+          json += escaped;
+        } else {
+          json += character;
+        }
+    }
+  }
+  json += '"';
+
+  return json;
+}
+
+std::string ToJson(const char* string) { return ToJson(std::string(string)); }
+
+std::string ToJson(size_t number) { return std::to_string(number); }
+
+std::string ToJson(bool value) { return value ? "true" : "false"; }
+
+std::string ToJson(const std::vector<std::string>& strings) {
+  std::string json = "[";
+  for (const auto& string : strings) {
+    if (json.size() > 1)
+      json += ',';
+    json += ToJson(string);
+  }
+  json += ']';
+
+  return json;
+}
+
+// Metadata is given the same structure as in masterlists. Its scalars are all
+// strings in YAML nodes, so the keys of numbers and booleans are listed.
+std::string ToJson(const YAML::Node& node, const std::string& key = "") {
+  static const std::set<std::string> numberKeys = {
+      "priority", "global_priority", "crc", "itm", "udr", "nav"};
+
+  std::string json;
+  if (node.IsMap()) {
+    json = "{";
+    for (const auto& pair : node) {
+      if (json.size() > 1)
+        json += ',';
+
+      const std::string childKey = pair.first.as<std::string>();
+      json += ToJson(childKey) + ':' + ToJson(pair.second, childKey);
+    }
+    json += '}';
+  } else if (node.IsSequence()) {
+    json = "[";
+    for (const auto& element : node) {
+      if (json.size() > 1)
+        json += ',';
+      json += ToJson(element);
+    }
+    json += ']';
+  } else if (node.IsScalar()) {
+    if (key == "enabled")
+      json = ToJson(node.as<bool>());
+    else if (numberKeys.count(key) != 0)
+      json = node.as<std::string>();
+    else
+      json = ToJson(node.as<std::string>());
+  } else {
+    json = "null";
+  }
+
+  return json;
+}
+
+std::string ToJson(const SortService::JsonMembers& members) {
+  std::string json = "{";
+  for (const auto& member : members) {
+    if (json.size() > 1)
+      json += ',';
+    json += ToJson(member.first) + ':' + member.second;
+  }
+  json += '}';
+
+  return json;
+}
+}
+
+std::string SortService::HandleRequest(const std::string& request) {
+  JsonMembers response;
+  try {
+    pt::ptree tree;
+    std::istringstream in(request);
+    pt::read_json(in, tree);
+
+    response = HandleCommand(tree);
+    response.emplace(response.begin(), "status", ToJson("ok"));
+  } catch (std::exception& e) {
+    return ErrorResponse(e.what());
+  }
+
+  return ToJson(response) + '\n';
+}
+
+std::string SortService::ErrorResponse(const std::string& message) {
+  return ToJson(JsonMembers{{"status", ToJson("error")},
+                            {"message", ToJson(message)}}) +
+         '\n';
+}
+
+SortService::JsonMembers SortService::HandleCommand(
+    const pt::ptree& request) {
+  const std::string command = request.get<std::string>("command");
+  auto install = GetInstall(request);
+
+  auto masterFile = request.get_optional<std::string>("main_master_file");
+  if (masterFile)
+    install->IdentifyMainMasterFile(*masterFile);
+
+  const std::string masterlistPath =
+      request.get<std::string>("masterlist_path", "");
+  const std::string userlistPath =
+      request.get<std::string>("userlist_path", "");
+
+  JsonMembers response;
+  if (command == "load") {
+    size_t pluginsParsed =
+        install->LoadPlugins(GetStrings(request, "plugins"),
+                             request.get<bool>("headers_only", false));
+    response.emplace_back("plugins_parsed", ToJson(pluginsParsed));
+  } else if (command == "sort") {
+    size_t pluginsParsed = 0;
+    auto loadOrder = install->SortPlugins(GetStrings(request, "plugins"),
+                                          masterlistPath,
+                                          userlistPath,
+                                          pluginsParsed);
+    response.emplace_back("load_order", ToJson(loadOrder));
+    response.emplace_back("plugins_parsed", ToJson(pluginsParsed));
+  } else if (command == "get_metadata") {
+    auto metadata = install->GetPluginMetadata(
+        request.get<std::string>("plugin"),
+        masterlistPath,
+        userlistPath,
+        request.get<bool>("include_user_metadata", true),
+        request.get<bool>("evaluate_conditions", false));
+    response.emplace_back("metadata", ToJson(YAML::Node(metadata)));
+  } else if (command == "update_masterlist") {
+    bool wasUpdated =
+        install->UpdateMasterlist(request.get<std::string>("masterlist_path"),
+                                  request.get<std::string>("remote_url"),
+                                  request.get<std::string>("remote_branch"));
+    response.emplace_back("updated", ToJson(wasUpdated));
+  } else {
+    throw std::invalid_argument("Unknown command: " + command);
+  }
+
+  return response;
+}
+
+std::shared_ptr<WarmInstall> SortService::GetInstall(
+    const pt::ptree& request) {
+  const std::string game = request.get<std::string>("game");
+  const fs::path gamePath =
+      fs::absolute(request.get<std::string>("game_path"));
+  // The local path is optional on Windows, where it can be looked up.
+  fs::path localPath = request.get<std::string>("local_path", "");
+  if (!localPath.empty())
+    localPath = fs::absolute(localPath);
+
+  const std::string key = game + "\n" + gamePath.generic_string() + "\n" +
+                          localPath.generic_string();
+
+  std::lock_guard<std::mutex> guard(installsMutex_);
+
+  auto it = installs_.find(key);
+  if (it == installs_.end()) {
+    auto install = std::make_shared<WarmInstall>(
+        ParseGameType(game), gamePath, localPath);
+    it = installs_.emplace(key, install).first;
+  }
+
+  return it->second;
+}
+}
+}
@@ -0,0 +1,71 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_SERVICE_SORT_SERVICE
+#define LOOT_SERVICE_SORT_SERVICE
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "service/warm_install.h"
+
+namespace loot {
+namespace service {
+// Handles JSON requests to load plugins, sort plugins, get plugin metadata and
+// update masterlists. Each game install that requests name is given a game
+// handle, which is kept so that later requests for the install can reuse its
+// parsed plugins and metadata lists. Requests for different installs can be
+// handled at the same time.
+class SortService {
+public:
+  // Returns a JSON response on a single line. Errors are returned as
+  // responses with an "error" status instead of being thrown.
+  std::string HandleRequest(const std::string& request);
+
+  // Returns a response with an "error" status and the given message.
+  static std::string ErrorResponse(const std::string& message);
+
+  // The members of a JSON object, with their values already written as JSON.
+  typedef std::vector<std::pair<std::string, std::string>> JsonMembers;
+
+private:
+  JsonMembers HandleCommand(
+      const boost::property_tree::ptree& request);
+
+  std::shared_ptr<WarmInstall> GetInstall(
+      const boost::property_tree::ptree& request);
+
+  std::mutex installsMutex_;
+  std::map<std::string, std::shared_ptr<WarmInstall>> installs_;
+};
+}
+}
+
+#endif
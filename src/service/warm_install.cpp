@@ -0,0 +1,220 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "service/warm_install.h"
+
+#include <algorithm>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/locale.hpp>
+
+#include "api/plugin/plugin.h"
+#include "api/plugin/plugin_sorter.h"
+
+namespace fs = boost::filesystem;
+
+namespace loot {
+namespace service {
+namespace {
+std::string TrimGhostExtension(const std::string& plugin) {
+  if (boost::iends_with(plugin, ".ghost"))
+    return plugin.substr(0, plugin.length() - 6);
+
+  return plugin;
+}
+}
+
+WarmInstall::WarmInstall(GameType gameType,
+                         const fs::path& gamePath,
+                         const fs::path& localPath) :
+    game_(gameType, gamePath, localPath) {}
+
+void WarmInstall::IdentifyMainMasterFile(const std::string& masterFile) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (!boost::iequals(masterFile, masterFile_)) {
+    // The main master file is always fully loaded, so plugins loaded before
+    // it was identified may need to be loaded again.
+    masterFile_ = masterFile;
+    game_.IdentifyMainMasterFile(masterFile);
+    plugins_.clear();
+    game_.GetCache()->ClearCachedPlugins();
+  }
+}
+
+size_t WarmInstall::LoadPlugins(const std::vector<std::string>& plugins,
+                                bool loadHeadersOnly) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return RefreshPlugins(plugins, loadHeadersOnly, false);
+}
+
+std::vector<std::string> WarmInstall::SortPlugins(
+    const std::vector<std::string>& plugins,
+    const std::string& masterlistPath,
+    const std::string& userlistPath,
+    size_t& pluginsParsed) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  RefreshLists(masterlistPath, userlistPath);
+  pluginsParsed = RefreshPlugins(plugins, false, true);
+
+  // Conditions can depend on any file, not just those whose identities are
+  // kept, so they are evaluated again for each request.
+  game_.GetCache()->ClearCachedConditions();
+
+  PluginSorter sorter;
+  return sorter.Sort(game_);
+}
+
+PluginMetadata WarmInstall::GetPluginMetadata(const std::string& plugin,
+                                              const std::string& masterlistPath,
+                                              const std::string& userlistPath,
+                                              bool includeUserMetadata,
+                                              bool evaluateConditions) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  RefreshLists(masterlistPath, userlistPath);
+
+  if (evaluateConditions) {
+    game_.LoadCurrentLoadOrderState();
+    game_.GetCache()->ClearCachedConditions();
+  }
+
+  return game_.GetDatabase()->GetPluginMetadata(
+      plugin, includeUserMetadata, evaluateConditions);
+}
+
+bool WarmInstall::UpdateMasterlist(const std::string& masterlistPath,
+                                   const std::string& remoteUrl,
+                                   const std::string& remoteBranch) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  bool wasUpdated = game_.GetDatabase()->UpdateMasterlist(
+      masterlistPath, remoteUrl, remoteBranch);
+
+  // The update replaces the loaded masterlist, so if it's the one that
+  // requests use, it's current. Otherwise, it will be reloaded when next
+  // used, as its identity won't match.
+  boost::system::error_code ec;
+  if (wasUpdated && fs::equivalent(masterlistPath, masterlistPath_, ec))
+    masterlistIdentity_ = FileIdentity::Get(masterlistPath);
+
+  return wasUpdated;
+}
+
+size_t WarmInstall::RefreshPlugins(const std::vector<std::string>& plugins,
+                                   bool loadHeadersOnly,
+                                   bool unloadOthers) {
+  std::map<std::string, FileIdentity> identities;
+  std::vector<std::string> stalePlugins;
+  for (const auto& plugin : plugins) {
+    const std::string name = TrimGhostExtension(plugin);
+    const std::string key = boost::locale::to_lower(name);
+    const FileIdentity identity =
+        FileIdentity::Get(Plugin::GetPath(name, game_.DataPath()));
+
+    auto it = plugins_.find(key);
+    if (it == plugins_.end() || it->second.identity != identity ||
+        (it->second.isHeaderOnly && !loadHeadersOnly))
+      stalePlugins.push_back(plugin);
+
+    identities[key] = identity;
+  }
+
+  // Sorting uses every loaded plugin, so any that weren't given need to be
+  // unloaded first.
+  bool hasOtherPlugins =
+      std::any_of(plugins_.begin(),
+                  plugins_.end(),
+                  [&](const std::pair<const std::string, LoadedPlugin>& entry) {
+                    return identities.count(entry.first) == 0;
+                  });
+  if (unloadOthers && hasOtherPlugins) {
+    plugins_.clear();
+    game_.GetCache()->ClearCachedPlugins();
+    stalePlugins = plugins;
+  }
+
+  if (stalePlugins.empty()) {
+    game_.LoadCurrentLoadOrderState();
+  } else if (stalePlugins.size() == plugins.size()) {
+    // Loading every plugin at once uses several threads, but also unloads any
+    // plugins that aren't given.
+    plugins_.clear();
+    game_.LoadPlugins(plugins, loadHeadersOnly);
+  } else {
+    game_.LoadCurrentLoadOrderState();
+
+    for (const auto& plugin : stalePlugins) {
+      const std::string name = TrimGhostExtension(plugin);
+      if (!game_.IsValidPlugin(name))
+        throw std::invalid_argument("\"" + plugin + "\" is not a valid plugin");
+
+      const bool loadHeader =
+          boost::iequals(name, masterFile_) || loadHeadersOnly;
+      game_.GetCache()->AddPlugin(Plugin(game_.Type(),
+                                         game_.DataPath(),
+                                         game_.GetLoadOrderHandler(),
+                                         name,
+                                         loadHeader));
+    }
+  }
+
+  // The main master file is always fully loaded, so it never needs loading
+  // again for a request that wants more than headers.
+  for (const auto& plugin : stalePlugins) {
+    const std::string name = TrimGhostExtension(plugin);
+    const std::string key = boost::locale::to_lower(name);
+    plugins_[key] = LoadedPlugin{
+        identities[key], loadHeadersOnly && !boost::iequals(name, masterFile_)};
+  }
+
+  return stalePlugins.size();
+}
+
+void WarmInstall::RefreshLists(const std::string& masterlistPath,
+                               const std::string& userlistPath) {
+  FileIdentity masterlistIdentity;
+  if (!masterlistPath.empty())
+    masterlistIdentity = FileIdentity::Get(masterlistPath);
+
+  FileIdentity userlistIdentity;
+  if (!userlistPath.empty())
+    userlistIdentity = FileIdentity::Get(userlistPath);
+
+  if (masterlistPath == masterlistPath_ && userlistPath == userlistPath_ &&
+      masterlistIdentity == masterlistIdentity_ &&
+      userlistIdentity == userlistIdentity_)
+    return;
+
+  game_.GetDatabase()->LoadLists(masterlistPath, userlistPath);
+
+  masterlistPath_ = masterlistPath;
+  userlistPath_ = userlistPath;
+  masterlistIdentity_ = masterlistIdentity;
+  userlistIdentity_ = userlistIdentity;
+}
+}
+}
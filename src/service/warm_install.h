@@ -0,0 +1,102 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2012-2016    WrinklyNinja
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_SERVICE_WARM_INSTALL
+#define LOOT_SERVICE_WARM_INSTALL
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "api/game/game.h"
+#include "api/helpers/file_identity.h"
+
+namespace loot {
+namespace service {
+// A game handle that is kept between requests, along with the identities of
+// the plugins and metadata lists loaded into it, so that files are only parsed
+// again if they change. Requests for an install are handled one at a time.
+class WarmInstall {
+public:
+  WarmInstall(GameType gameType,
+              const boost::filesystem::path& gamePath,
+              const boost::filesystem::path& localPath);
+
+  void IdentifyMainMasterFile(const std::string& masterFile);
+
+  // Loads the given plugins, reusing any that are already loaded and haven't
+  // changed. Returns the number of plugins that were parsed.
+  size_t LoadPlugins(const std::vector<std::string>& plugins,
+                     bool loadHeadersOnly);
+
+  // Sorts the given plugins, which are loaded first. The number of plugins
+  // that were parsed is stored in pluginsParsed.
+  std::vector<std::string> SortPlugins(
+      const std::vector<std::string>& plugins,
+      const std::string& masterlistPath,
+      const std::string& userlistPath,
+      size_t& pluginsParsed);
+
+  PluginMetadata GetPluginMetadata(const std::string& plugin,
+                                   const std::string& masterlistPath,
+                                   const std::string& userlistPath,
+                                   bool includeUserMetadata,
+                                   bool evaluateConditions);
+
+  bool UpdateMasterlist(const std::string& masterlistPath,
+                        const std::string& remoteUrl,
+                        const std::string& remoteBranch);
+
+private:
+  struct LoadedPlugin {
+    FileIdentity identity;
+    bool isHeaderOnly;
+  };
+
+  size_t RefreshPlugins(const std::vector<std::string>& plugins,
+                        bool loadHeadersOnly,
+                        bool unloadOthers);
+  void RefreshLists(const std::string& masterlistPath,
+                    const std::string& userlistPath);
+
+  std::mutex mutex_;
+  Game game_;
+
+  std::string masterFile_;
+
+  // Keyed by lowercased filename, without any .ghost extension.
+  std::map<std::string, LoadedPlugin> plugins_;
+
+  std::string masterlistPath_;
+  std::string userlistPath_;
+  FileIdentity masterlistIdentity_;
+  FileIdentity userlistIdentity_;
+};
+}
+}
+
+#endif
@@ -25,6 +25,8 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_API_INTERFACE_DATABASE_INTERFACE_TEST
 #define LOOT_TESTS_API_INTERFACE_DATABASE_INTERFACE_TEST
 
+#include <system_error>
+
 #include "loot/api.h"
 
 #include "tests/api/interface/api_game_operations_test.h"
@@ -309,6 +311,54 @@ TEST_P(
   EXPECT_TRUE(boost::filesystem::exists(masterlistPath));
 }
 
+TEST_P(DatabaseInterfaceTest,
+       updateMasterlistAsyncShouldThrowIfTheMasterlistPathGivenIsInvalid) {
+  EXPECT_THROW(db_->UpdateMasterlistAsync(";//\?", url_, branch_),
+               std::invalid_argument);
+}
+
+TEST_P(
+    DatabaseInterfaceTest,
+    updateMasterlistAsyncShouldReportTransferProgressAndOutputTrueIfTheMasterlistWasUpdated) {
+  size_t callbackCount = 0;
+  size_t receivedObjects = 0;
+  auto future = db_->UpdateMasterlistAsync(
+      masterlistPath.string(),
+      url_,
+      branch_,
+      [&](const TransferProgress& progress) {
+        ++callbackCount;
+        receivedObjects = progress.received_objects;
+        return true;
+      });
+
+  bool updated = false;
+  EXPECT_NO_THROW(updated = future.get());
+  EXPECT_TRUE(updated);
+  EXPECT_TRUE(boost::filesystem::exists(masterlistPath));
+  EXPECT_LT(0, callbackCount);
+  EXPECT_LT(0, receivedObjects);
+}
+
+TEST_P(DatabaseInterfaceTest,
+       updateMasterlistAsyncShouldBeCancelledIfTheProgressCallbackReturnsFalse) {
+  auto future = db_->UpdateMasterlistAsync(
+      masterlistPath.string(), url_, branch_, [](const TransferProgress&) {
+        return false;
+      });
+
+  try {
+    future.get();
+    FAIL() << "Expected the update to be cancelled.";
+  } catch (std::system_error& e) {
+    // -7 is libgit2's GIT_EUSER.
+    EXPECT_EQ(-7, e.code().value());
+    EXPECT_EQ(libgit2_category(), e.code().category());
+  }
+
+  EXPECT_FALSE(boost::filesystem::exists(masterlistPath));
+}
+
 TEST_P(DatabaseInterfaceTest,
        getMasterlistRevisionShouldThrowIfNoMasterlistIsPresent) {
   MasterlistInfo info;
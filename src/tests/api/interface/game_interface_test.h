@@ -171,6 +171,40 @@ TEST_P(GameInterfaceTest, sortPluginsShouldSucceedIfPassedValidArguments) {
   EXPECT_EQ(expectedOrder, actualOrder);
 }
 
+TEST_P(GameInterfaceTest, getSortGraphPathShouldThrowIfNoGraphHasBeenKept) {
+  handle_->SortPlugins({masterFile, blankEsm, blankMasterDependentEsm});
+
+  EXPECT_THROW(handle_->GetSortGraphPath(blankEsm, blankMasterDependentEsm),
+               std::logic_error);
+}
+
+TEST_P(GameInterfaceTest,
+       getSortGraphPathShouldExplainTheSortedOrderIfTheGraphIsKept) {
+  handle_->SetRetainSortGraph(true);
+  handle_->SortPlugins(
+      {masterFile, blankEsm, blankMasterDependentEsm, blankEsp});
+
+  auto path = handle_->GetSortGraphPath(boost::to_upper_copy(blankEsm),
+                                        blankMasterDependentEsm);
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ(blankEsm, path[0].from_plugin);
+  EXPECT_EQ(blankMasterDependentEsm, path[0].to_plugin);
+  EXPECT_EQ(EdgeType::master, path[0].type);
+
+  EXPECT_TRUE(handle_->GetSortGraphPath(blankEsp, blankEsm).empty());
+  EXPECT_THROW(handle_->GetSortGraphPath(blankEsm, blankDifferentEsm),
+               std::invalid_argument);
+}
+
+TEST_P(GameInterfaceTest, setRetainSortGraphFalseShouldDiscardTheKeptGraph) {
+  handle_->SetRetainSortGraph(true);
+  handle_->SortPlugins({masterFile, blankEsm, blankMasterDependentEsm});
+  handle_->SetRetainSortGraph(false);
+
+  EXPECT_THROW(handle_->GetSortGraphPath(blankEsm, blankMasterDependentEsm),
+               std::logic_error);
+}
+
 TEST_P(GameInterfaceTest,
        isPluginActiveShouldReturnFalseIfTheGivenPluginIsNotActive) {
   handle_->LoadCurrentLoadOrderState();
@@ -183,6 +217,27 @@ TEST_P(GameInterfaceTest,
   EXPECT_FALSE(handle_->IsPluginActive(blankEsp));
 }
 
+TEST_P(GameInterfaceTest,
+       isLoadOrderStateStaleShouldReturnTrueIfTheStateHasNotBeenLoaded) {
+  EXPECT_TRUE(handle_->IsLoadOrderStateStale());
+}
+
+TEST_P(GameInterfaceTest,
+       loadCurrentLoadOrderStateShouldReloadTheStateIfForcedTo) {
+  handle_->LoadCurrentLoadOrderState();
+  ASSERT_FALSE(handle_->IsPluginActive(blankEsp));
+
+  auto loadOrder = getInitialLoadOrder();
+  for (auto& plugin : loadOrder) {
+    if (plugin.first == blankEsp)
+      plugin.second = true;
+  }
+  setLoadOrder(loadOrder);
+
+  handle_->LoadCurrentLoadOrderState(true);
+  EXPECT_TRUE(handle_->IsPluginActive(blankEsp));
+}
+
 TEST_P(GameInterfaceTest, getLoadOrderShouldReturnTheCurrentLoadOrder) {
   handle_->LoadCurrentLoadOrderState();
   ASSERT_EQ(getLoadOrder(), handle_->GetLoadOrder());
@@ -217,6 +272,101 @@ TEST_P(GameInterfaceTest, setLoadOrderShouldSetTheLoadOrder) {
 
   EXPECT_EQ(loadOrder, getLoadOrder());
 }
+
+TEST_P(GameInterfaceTest,
+       flushLoadOrderShouldWriteALoadOrderSetWithAWriteDelay) {
+  handle_->LoadCurrentLoadOrderState();
+  auto initialLoadOrder = getLoadOrder();
+  std::vector<std::string> loadOrder({
+      masterFile,
+      blankEsm,
+      blankMasterDependentEsm,
+      blankDifferentEsm,
+      blankDifferentMasterDependentEsm,
+      blankDifferentEsp,
+      blankDifferentPluginDependentEsp,
+      blankEsp,
+      blankMasterDependentEsp,
+      blankDifferentMasterDependentEsp,
+      blankPluginDependentEsp,
+  });
+
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se) {
+    loadOrder.insert(loadOrder.begin() + 5, blankEsl);
+  }
+
+  handle_->SetLoadOrderWriteDelay(60 * 60 * 1000);
+  EXPECT_NO_THROW(handle_->SetLoadOrder(loadOrder));
+
+  EXPECT_EQ(loadOrder, handle_->GetLoadOrder());
+  EXPECT_EQ(initialLoadOrder, getLoadOrder());
+
+  EXPECT_NO_THROW(handle_->FlushLoadOrder());
+
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
+    loadOrder.erase(std::begin(loadOrder));
+
+  EXPECT_EQ(loadOrder, getLoadOrder());
+}
+
+TEST_P(GameInterfaceTest, getStatisticsShouldCountWorkDoneLoadingPlugins) {
+  handle_->ResetStatistics();
+  handle_->LoadPlugins(pluginsToLoad, false);
+
+  auto statistics = handle_->GetStatistics();
+  EXPECT_EQ(pluginsToLoad.size(), statistics.plugins_parsed);
+  EXPECT_EQ(pluginsToLoad.size(), statistics.crcs_computed);
+  EXPECT_LT(0, statistics.bytes_read);
+  EXPECT_LT(0, statistics.esplugin_calls);
+  EXPECT_LT(std::chrono::nanoseconds(0), statistics.load_plugins_time);
+  EXPECT_EQ(std::chrono::nanoseconds(0), statistics.sort_plugins_time);
+}
+
+TEST_P(GameInterfaceTest,
+       getStatisticsShouldNotCountWorkDoneByOtherGameHandles) {
+  handle_->ResetStatistics();
+
+  auto otherHandle = CreateGameHandle(
+      GetParam(), dataPath.parent_path().string(), localPath.string());
+  otherHandle->LoadPlugins(pluginsToLoad, false);
+
+  auto statistics = handle_->GetStatistics();
+  EXPECT_EQ(0, statistics.plugins_parsed);
+  EXPECT_EQ(0, statistics.crcs_computed);
+  EXPECT_EQ(std::chrono::nanoseconds(0), statistics.load_plugins_time);
+  EXPECT_EQ(pluginsToLoad.size(),
+            otherHandle->GetStatistics().plugins_parsed);
+}
+
+TEST_P(GameInterfaceTest, resetStatisticsShouldSetAllStatisticsToZero) {
+  handle_->LoadPlugins(pluginsToLoad, true);
+  handle_->ResetStatistics();
+
+  auto statistics = handle_->GetStatistics();
+  EXPECT_EQ(0, statistics.plugins_parsed);
+  EXPECT_EQ(0, statistics.esplugin_calls);
+  EXPECT_EQ(std::chrono::nanoseconds(0), statistics.load_plugins_time);
+}
+
+TEST_P(GameInterfaceTest, stopTracingShouldWriteEventsRecordedSinceStart) {
+  boost::filesystem::path tracePath = localPath / "trace.json";
+
+  handle_->LoadPlugins(pluginsToLoad, true);
+  StartTracing();
+  handle_->LoadPlugins({blankEsm}, true);
+  StopTracing(tracePath.string());
+
+  boost::filesystem::ifstream in(tracePath);
+  std::string trace((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+
+  EXPECT_EQ(0, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"LoadPlugins\""));
+  EXPECT_NE(std::string::npos,
+            trace.find("\"args\":{\"name\":\"" + blankEsm + "\"}"));
+  EXPECT_EQ(std::string::npos,
+            trace.find("\"args\":{\"name\":\"" + blankEsp + "\"}"));
+}
 }
 }
 
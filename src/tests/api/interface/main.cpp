@@ -29,6 +29,9 @@
 #include "tests/api/interface/database_interface_test.h"
 #include "tests/api/interface/game_interface_test.h"
 #include "tests/api/interface/is_compatible_test.h"
+#include "tests/api/interface/update_masterlists_test.h"
+
+#include <mutex>
 
 #include <boost/locale.hpp>
 
@@ -62,5 +65,67 @@ TEST(SetLoggingCallback, shouldWriteMessagesToGivenCallback) {
 
   FAIL();
 }
+
+TEST(SetAsyncLoggingCallback, shouldThrowIfTheQueueSizeIsNotAPowerOfTwo) {
+  EXPECT_THROW(SetAsyncLoggingCallback([](LogLevel, const char *) {}, 1000),
+               std::invalid_argument);
+  EXPECT_THROW(SetAsyncLoggingCallback([](LogLevel, const char *) {}, 0),
+               std::invalid_argument);
+}
+
+TEST(SetAsyncLoggingCallback,
+     shouldWriteQueuedMessagesToGivenCallbackBeforeItIsReplaced) {
+  std::mutex mutex;
+  std::string loggedMessages;
+  SetAsyncLoggingCallback(
+      [&](LogLevel level, const char *string) {
+        std::lock_guard<std::mutex> lock(mutex);
+        loggedMessages += std::string(string);
+      },
+      2,
+      LogOverflowPolicy::block);
+
+  EXPECT_ANY_THROW(CreateGameHandle(GameType::tes4, "", ""));
+
+  SetLoggingCallback([](LogLevel, const char *) {});
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ("Initialising load order data for game of type 0 at: ",
+            loggedMessages);
+}
+
+TEST(SetLogLevel, shouldNotPassMessagesBelowTheGivenLevelToTheCallback) {
+  std::string loggedMessages;
+  SetLoggingCallback([&](LogLevel level, const char *string) {
+    loggedMessages += std::string(string);
+  });
+  SetLogLevel(LogLevel::warning);
+
+  EXPECT_ANY_THROW(CreateGameHandle(GameType::tes4, "", ""));
+  EXPECT_TRUE(loggedMessages.empty());
+
+  SetLogLevel(LogLevel::trace);
+  SetLoggingCallback([](LogLevel, const char *) {});
+}
+
+TEST(SetLogLevel, shouldApplyToLoggingCallbacksSetAfterIt) {
+  SetLogLevel(LogLevel::warning);
+
+  std::string loggedMessages;
+  SetLoggingCallback([&](LogLevel level, const char *string) {
+    loggedMessages += std::string(string);
+  });
+
+  EXPECT_ANY_THROW(CreateGameHandle(GameType::tes4, "", ""));
+  EXPECT_TRUE(loggedMessages.empty());
+
+  SetLogLevel(LogLevel::trace);
+  SetLoggingCallback([](LogLevel, const char *) {});
+}
+
+TEST(StopTracing, shouldThrowIfTheOutputFileCannotBeWritten) {
+  StartTracing();
+  EXPECT_THROW(StopTracing("./missing/trace.json"), FileAccessError);
+}
 }
 }
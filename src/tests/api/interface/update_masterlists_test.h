@@ -0,0 +1,139 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERFACE_UPDATE_MASTERLISTS_TEST
+#define LOOT_TESTS_API_INTERFACE_UPDATE_MASTERLISTS_TEST
+
+#include "loot/api.h"
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+#include <gtest/gtest.h>
+
+#include "tests/masterlist_repository.h"
+
+namespace loot {
+namespace test {
+class UpdateMasterlistsTest : public ::testing::Test {
+protected:
+  UpdateMasterlistsTest() : masterlistsPath_("./update-masterlists") {
+    for (size_t i = 0; i < 3; ++i) {
+      repos_.emplace_back("./update-masterlists-remote-" + std::to_string(i));
+    }
+  }
+
+  void SetUp() {
+    for (size_t i = 0; i < repos_.size(); ++i) {
+      ASSERT_NO_THROW(repos_[i].Init());
+      ASSERT_NO_THROW(repos_[i].Commit(
+          "bash_tags:\n  - Tag" + std::to_string(i) + "\n", "First"));
+
+      boost::filesystem::path masterlistPath = GetMasterlistPath(i);
+      ASSERT_NO_THROW(
+          boost::filesystem::create_directories(masterlistPath.parent_path()));
+
+      jobs_.emplace_back(masterlistPath.string(), repos_[i].GetUrl(), "master");
+    }
+  }
+
+  void TearDown() {
+    for (const auto& repo : repos_) {
+      ASSERT_NO_THROW(repo.Remove());
+    }
+
+    ASSERT_NO_THROW(boost::filesystem::remove_all(masterlistsPath_));
+  }
+
+  boost::filesystem::path GetMasterlistPath(size_t index) const {
+    return masterlistsPath_ / std::to_string(index) / "masterlist.yaml";
+  }
+
+  std::string ReadMasterlist(size_t index) const {
+    boost::filesystem::ifstream in(GetMasterlistPath(index));
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+  }
+
+  const boost::filesystem::path masterlistsPath_;
+  std::vector<MasterlistRepository> repos_;
+  std::vector<MasterlistUpdateJob> jobs_;
+};
+
+TEST_F(UpdateMasterlistsTest, shouldReturnNoResultsIfGivenNoJobs) {
+  EXPECT_TRUE(UpdateMasterlists({}, 2).empty());
+}
+
+TEST_F(UpdateMasterlistsTest, shouldThrowIfTwoJobsUseTheSameRepository) {
+  jobs_.push_back(jobs_[0]);
+
+  EXPECT_THROW(UpdateMasterlists(jobs_, 2), std::invalid_argument);
+}
+
+TEST_F(UpdateMasterlistsTest,
+       shouldUpdateEveryMasterlistAndReturnResultsInTheOrderOfTheJobs) {
+  auto results = UpdateMasterlists(jobs_, 2);
+
+  ASSERT_EQ(jobs_.size(), results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    EXPECT_TRUE(results[i].updated);
+    EXPECT_FALSE(results[i].error);
+    EXPECT_EQ("bash_tags:\n  - Tag" + std::to_string(i) + "\n",
+              ReadMasterlist(i));
+  }
+}
+
+TEST_F(UpdateMasterlistsTest,
+       shouldReturnFalseForMasterlistsThatAreAlreadyUpToDate) {
+  ASSERT_NO_THROW(UpdateMasterlists(jobs_, 2));
+  ASSERT_NO_THROW(repos_[1].Commit("bash_tags:\n  - Tag3\n", "Second"));
+
+  auto results = UpdateMasterlists(jobs_, 2);
+
+  ASSERT_EQ(jobs_.size(), results.size());
+  EXPECT_FALSE(results[0].updated);
+  EXPECT_TRUE(results[1].updated);
+  EXPECT_FALSE(results[2].updated);
+  EXPECT_EQ("bash_tags:\n  - Tag3\n", ReadMasterlist(1));
+}
+
+TEST_F(UpdateMasterlistsTest,
+       shouldReturnTheErrorOfAFailedJobWithoutStoppingTheOtherJobs) {
+  jobs_[1].remote_branch = "missing-branch";
+
+  auto results = UpdateMasterlists(jobs_, 1);
+
+  ASSERT_EQ(jobs_.size(), results.size());
+  EXPECT_TRUE(results[0].updated);
+  EXPECT_FALSE(results[0].error);
+  EXPECT_FALSE(results[1].updated);
+  EXPECT_TRUE(results[1].error);
+  EXPECT_TRUE(results[2].updated);
+  EXPECT_FALSE(results[2].error);
+}
+}
+}
+
+#endif
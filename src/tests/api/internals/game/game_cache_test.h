@@ -27,6 +27,9 @@ along with LOOT.  If not, see
 
 #include "api/game/game_cache.h"
 
+#include <atomic>
+#include <thread>
+
 #include "api/game/game.h"
 #include "tests/common_game_test_fixture.h"
 
@@ -158,6 +161,43 @@ TEST_P(GameCacheTest, clearingCachedPluginsShouldClearAnyCachedPlugins) {
 
   EXPECT_TRUE(cache_.GetPlugins().empty());
 }
+
+// Run this in a ThreadSanitizer build to check for data races.
+TEST_P(GameCacheTest, usingTheCacheFromManyThreadsAtOnceShouldBeSafe) {
+  const std::vector<std::string> plugins({blankEsm, blankEsp});
+  std::atomic<size_t> failures(0);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 8; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      for (size_t j = 0; j < 20; ++j) {
+        const auto& pluginName = plugins[(i + j) % plugins.size()];
+        cache_.AddPlugin(Plugin(game_.Type(),
+                                game_.DataPath(),
+                                game_.GetLoadOrderHandler(),
+                                pluginName,
+                                true));
+        if (cache_.GetPlugin(pluginName)->GetName() != pluginName)
+          ++failures;
+        if (cache_.GetPlugins().empty())
+          ++failures;
+
+        const std::string condition = "file(\"" + std::to_string(j) + "\")";
+        cache_.CacheCondition(condition, j % 2 == 0);
+        if (cache_.GetCachedCondition(condition) !=
+            std::make_pair(j % 2 == 0, true))
+          ++failures;
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(0, failures.load());
+  EXPECT_EQ(plugins.size(), cache_.GetPlugins().size());
+}
 }
 }
 
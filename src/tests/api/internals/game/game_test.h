@@ -27,6 +27,10 @@ along with LOOT.  If not, see
 
 #include "api/game/game.h"
 
+#include <boost/filesystem/fstream.hpp>
+
+#include "api/helpers/memory_accounting.h"
+#include "loot/exception/file_access_error.h"
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -49,6 +53,25 @@ protected:
     });
     game.LoadPlugins(plugins, headersOnly);
   }
+
+  // Writes a masterlist with conditional metadata for Blank.esm and returns
+  // its path.
+  boost::filesystem::path writeMasterlist() {
+    auto masterlistPath = localPath / "masterlist.yaml";
+    boost::filesystem::ofstream out(masterlistPath);
+    out << "plugins:" << std::endl
+        << "  - name: " << blankEsm << std::endl
+        << "    after:" << std::endl
+        << "      - name: " << blankEsp << std::endl
+        << "        condition: 'file(\"" << blankEsp << "\")'" << std::endl
+        << "    msg:" << std::endl
+        << "      - type: say" << std::endl
+        << "        content: 'A message'" << std::endl
+        << "        condition: 'file(\"" << blankDifferentEsp << "\")'"
+        << std::endl;
+
+    return masterlistPath;
+  }
 };
 
 // Pass an empty first argument, as it's a prefix for the test instantation,
@@ -196,6 +219,233 @@ TEST_P(GameTest, shouldShowBlankEspAsInactiveIfItHasBeenFullyLoaded) {
 
   EXPECT_FALSE(game.IsPluginActive(blankEsp));
 }
+
+TEST_P(GameTest, loadingPluginsShouldAttributeTheirMemoryToPlugins) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+  auto before = GetMemoryUsageBySubsystem();
+
+  ASSERT_NO_THROW(loadInstalledPlugins(game, true));
+  auto loaded = GetMemoryUsageBySubsystem();
+
+  game.GetCache()->ClearCachedPlugins();
+  auto cleared = GetMemoryUsageBySubsystem();
+
+  EXPECT_LT(before.plugins_bytes, loaded.plugins_bytes);
+  EXPECT_GT(loaded.plugins_bytes, cleared.plugins_bytes);
+}
+
+TEST_P(GameTest, aGetPluginMetadataCacheHitShouldOnlyAllocateItsReturnValue) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.GetDatabase()->LoadLists(writeMasterlist().string());
+
+  // The first call evaluates the conditions and caches the result.
+  auto metadata = game.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+  ASSERT_EQ(1, metadata.GetMessages().size());
+
+  // Measure the allocations made by copying the returned value.
+  size_t allocatedBytes = GetAllocatedBytes();
+  size_t allocationCount = GetAllocationCount();
+  ResetPeakAllocatedBytes();
+  { PluginMetadata copy(metadata); }
+  size_t copyAllocationCount = GetAllocationCount() - allocationCount;
+  size_t copyPeakBytes = GetPeakAllocatedBytes() - allocatedBytes;
+
+  auto before = GetMemoryUsageBySubsystem();
+  allocatedBytes = GetAllocatedBytes();
+  allocationCount = GetAllocationCount();
+  ResetPeakAllocatedBytes();
+  { game.GetDatabase()->GetPluginMetadata(blankEsm, false, true); }
+  size_t hitAllocationCount = GetAllocationCount() - allocationCount;
+  size_t hitPeakBytes = GetPeakAllocatedBytes() - allocatedBytes;
+  auto after = GetMemoryUsageBySubsystem();
+
+  EXPECT_LT(0, copyAllocationCount);
+  EXPECT_LE(hitAllocationCount, copyAllocationCount);
+  EXPECT_LE(hitPeakBytes, copyPeakBytes);
+  EXPECT_EQ(allocatedBytes, GetAllocatedBytes());
+  EXPECT_EQ(before.condition_cache_bytes, after.condition_cache_bytes);
+  EXPECT_EQ(before.metadata_lists_bytes, after.metadata_lists_bytes);
+}
+
+TEST_P(GameTest,
+       getPluginMetadataShouldReevaluateConditionsAfterTheCacheIsCleared) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.GetDatabase()->LoadLists(writeMasterlist().string());
+
+  auto metadata = game.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+  ASSERT_EQ(1, metadata.GetMessages().size());
+
+  boost::filesystem::rename(dataPath / blankDifferentEsp,
+                            dataPath / (blankDifferentEsp + ".bak"));
+  game.GetCache()->ClearCachedConditions();
+  metadata = game.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+  boost::filesystem::rename(dataPath / (blankDifferentEsp + ".bak"),
+                            dataPath / blankDifferentEsp);
+
+  EXPECT_TRUE(metadata.GetMessages().empty());
+}
+
+TEST_P(GameTest, loadingListsShouldAttributeTheirMemoryToMetadataLists) {
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  auto masterlistPath = writeMasterlist();
+  auto before = GetMemoryUsageBySubsystem();
+
+  game.GetDatabase()->LoadLists(masterlistPath.string());
+
+  EXPECT_LT(before.metadata_lists_bytes,
+            GetMemoryUsageBySubsystem().metadata_lists_bytes);
+}
+
+TEST_P(GameTest, restoreSnapshotShouldRestoreLoadedPluginsWithoutParsingThem) {
+  ageStateFiles();
+  auto snapshotPath = localPath / "snapshot.bin";
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+  ASSERT_NO_THROW(loadInstalledPlugins(game, false));
+  game.SaveSnapshot(snapshotPath.string());
+
+  Game restoredGame = Game(GetParam(), dataPath.parent_path(), localPath);
+  restoredGame.ResetStatistics();
+  restoredGame.RestoreSnapshot(snapshotPath.string());
+
+  EXPECT_EQ(0, restoredGame.GetStatistics().plugins_parsed);
+  EXPECT_EQ(11, restoredGame.GetLoadedPlugins().size());
+  EXPECT_EQ(game.GetPlugin(blankEsm)->GetCRC(),
+            restoredGame.GetPlugin(blankEsm)->GetCRC());
+  EXPECT_TRUE(restoredGame.IsPluginActive(blankEsm));
+  EXPECT_FALSE(restoredGame.IsPluginActive(blankEsp));
+  EXPECT_EQ(game.GetLoadOrder(), restoredGame.GetLoadOrder());
+  EXPECT_FALSE(restoredGame.IsLoadOrderStateStale());
+}
+
+TEST_P(GameTest, restoreSnapshotShouldOnlyParsePluginsThatHaveChanged) {
+  ageStateFiles();
+  auto snapshotPath = localPath / "snapshot.bin";
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  ASSERT_NO_THROW(loadInstalledPlugins(game, false));
+  game.SaveSnapshot(snapshotPath.string());
+
+  auto pluginPath = dataPath / blankDifferentEsp;
+  boost::filesystem::last_write_time(
+      pluginPath, boost::filesystem::last_write_time(pluginPath) + 10);
+
+  Game restoredGame = Game(GetParam(), dataPath.parent_path(), localPath);
+  restoredGame.ResetStatistics();
+  restoredGame.RestoreSnapshot(snapshotPath.string());
+
+  EXPECT_EQ(1, restoredGame.GetStatistics().plugins_parsed);
+  EXPECT_EQ(11, restoredGame.GetLoadedPlugins().size());
+}
+
+TEST_P(GameTest, restoreSnapshotShouldRestoreListsAndConditionResults) {
+  ageStateFiles();
+  auto snapshotPath = localPath / "snapshot.bin";
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+  game.GetDatabase()->LoadLists(writeMasterlist().string());
+  game.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+  game.SaveSnapshot(snapshotPath.string());
+
+  Game restoredGame = Game(GetParam(), dataPath.parent_path(), localPath);
+  restoredGame.RestoreSnapshot(snapshotPath.string());
+  restoredGame.ResetStatistics();
+  auto metadata =
+      restoredGame.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+
+  EXPECT_EQ(1, metadata.GetMessages().size());
+  EXPECT_EQ(1, metadata.GetLoadAfterFiles().size());
+  EXPECT_EQ(0, restoredGame.GetStatistics().condition_cache_misses);
+}
+
+TEST_P(GameTest,
+       restoreSnapshotShouldNotRestoreResultsOfConditionsThatReadFileContents) {
+  auto filePath = dataPath / "loot-test.txt";
+  boost::filesystem::ofstream out(filePath);
+  out << "a";
+  out.close();
+
+  auto masterlistPath = localPath / "masterlist.yaml";
+  out.open(masterlistPath);
+  out << "plugins:" << std::endl
+      << "  - name: " << blankEsm << std::endl
+      << "    msg:" << std::endl
+      << "      - type: say" << std::endl
+      << "        content: 'A message'" << std::endl
+      << "        condition: 'checksum(\"loot-test.txt\", E8B7BE43)'"
+      << std::endl;
+  out.close();
+
+  ageStateFiles();
+  auto snapshotPath = localPath / "snapshot.bin";
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.LoadCurrentLoadOrderState();
+  game.GetDatabase()->LoadLists(masterlistPath.string());
+  ASSERT_EQ(
+      1,
+      game.GetDatabase()->GetPluginMetadata(blankEsm, false, true)
+          .GetMessages()
+          .size());
+  game.SaveSnapshot(snapshotPath.string());
+
+  // Editing the file in place leaves the data directory unchanged.
+  out.open(filePath);
+  out << "b";
+  out.close();
+
+  Game restoredGame = Game(GetParam(), dataPath.parent_path(), localPath);
+  restoredGame.RestoreSnapshot(snapshotPath.string());
+  auto metadata =
+      restoredGame.GetDatabase()->GetPluginMetadata(blankEsm, false, true);
+  boost::filesystem::remove(filePath);
+
+  EXPECT_TRUE(metadata.GetMessages().empty());
+}
+
+TEST_P(GameTest, restoreSnapshotShouldReloadAMasterlistThatHasChanged) {
+  auto snapshotPath = localPath / "snapshot.bin";
+  auto masterlistPath = writeMasterlist();
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+  game.GetDatabase()->LoadLists(masterlistPath.string());
+  game.SaveSnapshot(snapshotPath.string());
+
+  boost::filesystem::ofstream out(masterlistPath);
+  out << "bash_tags:" << std::endl << "  - Relev" << std::endl;
+  out.close();
+
+  Game restoredGame = Game(GetParam(), dataPath.parent_path(), localPath);
+  restoredGame.RestoreSnapshot(snapshotPath.string());
+
+  EXPECT_EQ(std::set<std::string>({"Relev"}),
+            restoredGame.GetDatabase()->GetKnownBashTags());
+  EXPECT_TRUE(restoredGame.GetDatabase()
+                  ->GetPluginMetadata(blankEsm)
+                  .HasNameOnly());
+}
+
+TEST_P(GameTest, restoreSnapshotShouldThrowIfTheFileIsNotASnapshot) {
+  auto snapshotPath = localPath / "snapshot.bin";
+  boost::filesystem::ofstream out(snapshotPath);
+  out << "This isn't a snapshot.";
+  out.close();
+
+  Game game = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  EXPECT_THROW(game.RestoreSnapshot(snapshotPath.string()), FileAccessError);
+}
+
+TEST_P(GameTest, restoreSnapshotShouldThrowIfItWasSavedForADifferentGame) {
+  auto snapshotPath = localPath / "snapshot.bin";
+  GameType otherType =
+      GetParam() == GameType::tes4 ? GameType::tes5 : GameType::tes4;
+  Game game = Game(otherType, dataPath.parent_path(), localPath);
+  game.SaveSnapshot(snapshotPath.string());
+
+  Game otherGame = Game(GetParam(), dataPath.parent_path(), localPath);
+
+  EXPECT_THROW(otherGame.RestoreSnapshot(snapshotPath.string()),
+               std::invalid_argument);
+}
 }
 }
 
@@ -27,6 +27,12 @@ along with LOOT.  If not, see
 
 #include "api/game/load_order_handler.h"
 
+#include <chrono>
+#include <thread>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/fstream.hpp>
+
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -120,6 +126,93 @@ TEST_P(LoadOrderHandlerTest,
   EXPECT_FALSE(loadOrderHandler_.IsPluginActive(blankEsp));
 }
 
+TEST_P(LoadOrderHandlerTest, isPluginActiveShouldBeCaseInsensitive) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  EXPECT_TRUE(loadOrderHandler_.IsPluginActive(boost::to_upper_copy(blankEsm)));
+  EXPECT_FALSE(
+      loadOrderHandler_.IsPluginActive(boost::to_upper_copy(blankEsp)));
+}
+
+TEST_P(LoadOrderHandlerTest,
+       isStateStaleShouldReturnTrueIfTheStateHasNotBeenLoaded) {
+  initialiseHandler();
+
+  EXPECT_TRUE(loadOrderHandler_.IsStateStale());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       isStateStaleShouldReturnFalseIfNoStateFilesHaveChangedSinceLoading) {
+  ageStateFiles();
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  EXPECT_FALSE(loadOrderHandler_.IsStateStale());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       isStateStaleShouldReturnTrueIfTheActivePluginsFileHasChanged) {
+  ageStateFiles();
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  boost::filesystem::ofstream out(localPath / "plugins.txt", std::ios::app);
+  out << blankEsp << std::endl;
+  out.close();
+
+  EXPECT_TRUE(loadOrderHandler_.IsStateStale());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       isStateStaleShouldReturnTrueIfAPluginHasBeenInstalled) {
+  ageStateFiles();
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  ASSERT_NO_THROW(boost::filesystem::copy(dataPath / blankEsp,
+                                          dataPath / "Blank - Copy.esp"));
+
+  EXPECT_TRUE(loadOrderHandler_.IsStateStale());
+
+  ASSERT_NO_THROW(boost::filesystem::remove(dataPath / "Blank - Copy.esp"));
+}
+
+TEST_P(LoadOrderHandlerTest,
+       loadCurrentStateShouldOnlyReloadTheStateIfItIsStaleUnlessForced) {
+  ageStateFiles();
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+  ASSERT_FALSE(loadOrderHandler_.IsPluginActive(blankEsp));
+
+  // Activate Blank.esp in place of Blank.esm, which keeps the file the same
+  // size, then restore its timestamp.
+  auto activePluginsFile = localPath / "plugins.txt";
+  auto modificationTime = boost::filesystem::last_write_time(activePluginsFile);
+  auto lines = readFileLines(activePluginsFile);
+  for (auto& line : lines) {
+    if (line == blankEsm)
+      line = blankEsp;
+    else if (line == "*" + blankEsm)
+      line = blankEsm;
+    else if (line == blankEsp)
+      line = "*" + blankEsp;
+  }
+  boost::filesystem::ofstream out(activePluginsFile);
+  for (const auto& line : lines) {
+    out << line << std::endl;
+  }
+  out.close();
+  boost::filesystem::last_write_time(activePluginsFile, modificationTime);
+
+  ASSERT_FALSE(loadOrderHandler_.IsStateStale());
+  loadOrderHandler_.LoadCurrentState();
+  EXPECT_FALSE(loadOrderHandler_.IsPluginActive(blankEsp));
+
+  loadOrderHandler_.LoadCurrentState(true);
+  EXPECT_TRUE(loadOrderHandler_.IsPluginActive(blankEsp));
+}
+
 TEST_P(LoadOrderHandlerTest,
        getLoadOrderShouldThrowIfTheHandlerHasNotBeenInitialised) {
   EXPECT_THROW(loadOrderHandler_.GetLoadOrder(), std::system_error);
@@ -139,6 +232,37 @@ TEST_P(LoadOrderHandlerTest, getLoadOrderShouldReturnTheCurrentLoadOrder) {
   ASSERT_EQ(getLoadOrder(), loadOrderHandler_.GetLoadOrder());
 }
 
+TEST_P(LoadOrderHandlerTest,
+       getLoadOrderIndexShouldThrowIfTheHandlerHasNotBeenInitialised) {
+  size_t index = 0;
+  EXPECT_THROW(loadOrderHandler_.GetLoadOrderIndex(masterFile, index),
+               std::system_error);
+}
+
+TEST_P(LoadOrderHandlerTest,
+       getLoadOrderIndexShouldReturnFalseIfThePluginIsNotInTheLoadOrder) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  size_t index = 0;
+  EXPECT_FALSE(loadOrderHandler_.GetLoadOrderIndex("missing.esp", index));
+}
+
+TEST_P(LoadOrderHandlerTest,
+       getLoadOrderIndexShouldCaseInsensitivelyFindThePluginsPosition) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  auto loadOrder = loadOrderHandler_.GetLoadOrder();
+  ASSERT_FALSE(loadOrder.empty());
+  for (size_t i = 0; i < loadOrder.size(); ++i) {
+    size_t index = loadOrder.size();
+    EXPECT_TRUE(loadOrderHandler_.GetLoadOrderIndex(
+        boost::to_upper_copy(loadOrder[i]), index));
+    EXPECT_EQ(i, index);
+  }
+}
+
 TEST_P(LoadOrderHandlerTest,
        setLoadOrderShouldThrowIfTheHandlerHasNotBeenInitialised) {
   EXPECT_THROW(loadOrderHandler_.SetLoadOrder(loadOrderToSet_),
@@ -150,6 +274,114 @@ TEST_P(LoadOrderHandlerTest, setLoadOrderShouldSetTheLoadOrder) {
   loadOrderHandler_.LoadCurrentState();
 
   EXPECT_NO_THROW(loadOrderHandler_.SetLoadOrder(loadOrderToSet_));
+  EXPECT_EQ(loadOrderToSet_, loadOrderHandler_.GetLoadOrder());
+
+  size_t index = 0;
+  EXPECT_TRUE(
+      loadOrderHandler_.GetLoadOrderIndex(loadOrderToSet_.back(), index));
+  EXPECT_EQ(loadOrderToSet_.size() - 1, index);
+
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
+    loadOrderToSet_.erase(begin(loadOrderToSet_));
+
+  EXPECT_EQ(loadOrderToSet_, getLoadOrder());
+}
+
+TEST_P(
+    LoadOrderHandlerTest,
+    setLoadOrderWithAWriteDelayShouldUpdateTheCachedLoadOrderButNotTheFiles) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+  auto initialLoadOrder = getLoadOrder();
+
+  loadOrderHandler_.SetWriteDelay(std::chrono::hours(1));
+  EXPECT_NO_THROW(loadOrderHandler_.SetLoadOrder(loadOrderToSet_));
+
+  EXPECT_EQ(loadOrderToSet_, loadOrderHandler_.GetLoadOrder());
+  size_t index = 0;
+  EXPECT_TRUE(
+      loadOrderHandler_.GetLoadOrderIndex(loadOrderToSet_.back(), index));
+  EXPECT_EQ(loadOrderToSet_.size() - 1, index);
+  EXPECT_TRUE(loadOrderHandler_.IsPluginActive(blankEsp));
+
+  EXPECT_EQ(initialLoadOrder, getLoadOrder());
+}
+
+TEST_P(LoadOrderHandlerTest, flushShouldWriteTheLastPendingLoadOrder) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+  auto initialLoadOrder = loadOrderHandler_.GetLoadOrder();
+
+  loadOrderHandler_.SetWriteDelay(std::chrono::hours(1));
+  loadOrderHandler_.SetLoadOrder(initialLoadOrder);
+  loadOrderHandler_.SetLoadOrder(loadOrderToSet_);
+  EXPECT_NO_THROW(loadOrderHandler_.Flush());
+
+  EXPECT_EQ(loadOrderToSet_, loadOrderHandler_.GetLoadOrder());
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
+    loadOrderToSet_.erase(begin(loadOrderToSet_));
+
+  EXPECT_EQ(loadOrderToSet_, getLoadOrder());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       flushShouldThrowAndRestoreTheCachedLoadOrderIfTheWriteFailed) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+  auto initialLoadOrder = loadOrderHandler_.GetLoadOrder();
+
+  loadOrderHandler_.SetWriteDelay(std::chrono::hours(1));
+  std::vector<std::string> invalidLoadOrder({masterFile, blankEsp, blankEsm});
+  EXPECT_NO_THROW(loadOrderHandler_.SetLoadOrder(invalidLoadOrder));
+  EXPECT_EQ(invalidLoadOrder, loadOrderHandler_.GetLoadOrder());
+
+  EXPECT_THROW(loadOrderHandler_.Flush(), std::system_error);
+  EXPECT_EQ(initialLoadOrder, loadOrderHandler_.GetLoadOrder());
+  EXPECT_NO_THROW(loadOrderHandler_.Flush());
+}
+
+TEST_P(LoadOrderHandlerTest, pendingLoadOrderShouldBeWrittenAfterTheDelay) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  loadOrderHandler_.SetWriteDelay(std::chrono::milliseconds(10));
+  loadOrderHandler_.SetLoadOrder(loadOrderToSet_);
+
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
+    loadOrderToSet_.erase(begin(loadOrderToSet_));
+
+  for (int i = 0; i < 500 && getLoadOrder() != loadOrderToSet_; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  EXPECT_EQ(loadOrderToSet_, getLoadOrder());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       settingAZeroWriteDelayShouldWriteAnyPendingLoadOrder) {
+  initialiseHandler();
+  loadOrderHandler_.LoadCurrentState();
+
+  loadOrderHandler_.SetWriteDelay(std::chrono::hours(1));
+  loadOrderHandler_.SetLoadOrder(loadOrderToSet_);
+  EXPECT_NO_THROW(loadOrderHandler_.SetWriteDelay(std::chrono::hours(0)));
+
+  if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
+    loadOrderToSet_.erase(begin(loadOrderToSet_));
+
+  EXPECT_EQ(loadOrderToSet_, getLoadOrder());
+}
+
+TEST_P(LoadOrderHandlerTest,
+       destroyingTheHandlerShouldWriteAnyPendingLoadOrder) {
+  {
+    LoadOrderHandler handler;
+    handler.Init(GetParam(), dataPath.parent_path(), localPath);
+    handler.LoadCurrentState();
+
+    handler.SetWriteDelay(std::chrono::hours(1));
+    handler.SetLoadOrder(loadOrderToSet_);
+  }
 
   if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se)
     loadOrderToSet_.erase(begin(loadOrderToSet_));
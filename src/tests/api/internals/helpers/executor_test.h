@@ -0,0 +1,217 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_EXECUTOR_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_EXECUTOR_TEST
+
+#include "api/helpers/executor.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+// Holds executed tasks until they are run by the test.
+class DeferredExecutor : public ExecutorInterface {
+public:
+  void Execute(std::function<void()> task) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    tasks_.push_back(task);
+  }
+
+  size_t RunTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      tasks.swap(tasks_);
+    }
+
+    for (auto& task : tasks) {
+      task();
+    }
+
+    return tasks.size();
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::function<void()>> tasks_;
+};
+
+class ParallelForTest : public ::testing::Test {
+protected:
+  void TearDown() {
+    setExecutor(nullptr);
+    setMaxConcurrency(0);
+  }
+
+  std::set<std::thread::id> GetThreadIds(size_t count, size_t maxThreads) {
+    std::mutex mutex;
+    std::set<std::thread::id> threadIds;
+    ParallelFor(count,
+                [&](size_t) {
+                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                  std::lock_guard<std::mutex> guard(mutex);
+                  threadIds.insert(std::this_thread::get_id());
+                },
+                maxThreads);
+
+    return threadIds;
+  }
+};
+
+TEST(WorkStealingPool, shouldHaveAtLeastOneThread) {
+  WorkStealingPool pool(0);
+
+  EXPECT_EQ(1, pool.GetThreadCount());
+}
+
+TEST(WorkStealingPool, shouldRunQueuedTasksBeforeBeingDestroyed) {
+  std::atomic<size_t> runCount(0);
+  {
+    WorkStealingPool pool(2);
+    for (size_t i = 0; i < 100; ++i) {
+      pool.Execute([&]() { ++runCount; });
+    }
+  }
+
+  EXPECT_EQ(100, runCount);
+}
+
+TEST(WorkStealingPool, shouldRunTasksExecutedByItsOwnThreads) {
+  std::atomic<size_t> runCount(0);
+  {
+    WorkStealingPool pool(2);
+    for (size_t i = 0; i < 10; ++i) {
+      pool.Execute([&]() {
+        for (size_t j = 0; j < 10; ++j) {
+          pool.Execute([&]() { ++runCount; });
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(100, runCount);
+}
+
+TEST_F(ParallelForTest, shouldCallTheFunctionOnceForEachIndex) {
+  std::vector<std::atomic<size_t>> callCounts(1000);
+  for (auto& count : callCounts) {
+    count = 0;
+  }
+
+  ParallelFor(callCounts.size(), [&](size_t index) { ++callCounts[index]; });
+
+  for (const auto& count : callCounts) {
+    EXPECT_EQ(1, count);
+  }
+}
+
+TEST_F(ParallelForTest, shouldNotCallTheFunctionIfTheCountIsZero) {
+  bool isCalled = false;
+  ParallelFor(0, [&](size_t) { isCalled = true; });
+
+  EXPECT_FALSE(isCalled);
+}
+
+TEST_F(ParallelForTest, shouldRethrowAnExceptionThrownByTheFunction) {
+  EXPECT_THROW(ParallelFor(100,
+                           [](size_t index) {
+                             if (index == 50)
+                               throw std::runtime_error("error");
+                           }),
+               std::runtime_error);
+}
+
+TEST_F(ParallelForTest, shouldOnlyUseTheCallingThreadIfMaxConcurrencyIsOne) {
+  setMaxConcurrency(1);
+
+  auto threadIds = GetThreadIds(20, 0);
+
+  ASSERT_EQ(1, threadIds.size());
+  EXPECT_EQ(std::this_thread::get_id(), *threadIds.begin());
+}
+
+TEST_F(ParallelForTest, shouldOnlyUseTheCallingThreadIfMaxThreadsIsOne) {
+  setMaxConcurrency(4);
+
+  auto threadIds = GetThreadIds(20, 1);
+
+  ASSERT_EQ(1, threadIds.size());
+  EXPECT_EQ(std::this_thread::get_id(), *threadIds.begin());
+}
+
+TEST_F(ParallelForTest, shouldNotUseMoreThreadsThanTheMaxConcurrency) {
+  setMaxConcurrency(2);
+
+  EXPECT_GE(2, GetThreadIds(20, 0).size());
+}
+
+TEST_F(ParallelForTest, shouldFinishIfTheExecutorHasNotRunItsTasks) {
+  auto executor = std::make_shared<DeferredExecutor>();
+  setExecutor(executor);
+  setMaxConcurrency(4);
+
+  size_t callCount = 0;
+  ParallelFor(10, [&](size_t) { ++callCount; });
+  EXPECT_EQ(10, callCount);
+
+  // The tasks return without calling the function once they're run.
+  EXPECT_EQ(3, executor->RunTasks());
+  EXPECT_EQ(10, callCount);
+}
+
+TEST_F(ParallelForTest, shouldShareTheConcurrencyBudgetBetweenCalls) {
+  auto executor = std::make_shared<DeferredExecutor>();
+  setExecutor(executor);
+  setMaxConcurrency(4);
+
+  ParallelFor(2, [](size_t) {});
+  ParallelFor(10, [](size_t) {});
+
+  // The first call took one task, leaving two for the second.
+  EXPECT_EQ(3, executor->RunTasks());
+
+  ParallelFor(10, [](size_t) {});
+  EXPECT_EQ(3, executor->RunTasks());
+}
+
+TEST_F(ParallelForTest, shouldFinishWhenCalledFromInsideAnotherCall) {
+  std::atomic<size_t> callCount(0);
+  ParallelFor(10, [&](size_t) {
+    ParallelFor(10, [&](size_t) { ++callCount; });
+  });
+
+  EXPECT_EQ(100, callCount);
+}
+}
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_GAME_TYPE_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_GAME_TYPE_TEST
+
+#include "api/helpers/game_type.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(ParseGameType, shouldReturnTheGameTypeWithTheGivenName) {
+  EXPECT_EQ(GameType::tes4, ParseGameType("tes4"));
+  EXPECT_EQ(GameType::tes5, ParseGameType("tes5"));
+  EXPECT_EQ(GameType::fo3, ParseGameType("fo3"));
+  EXPECT_EQ(GameType::fonv, ParseGameType("fonv"));
+  EXPECT_EQ(GameType::fo4, ParseGameType("fo4"));
+  EXPECT_EQ(GameType::tes5se, ParseGameType("tes5se"));
+}
+
+TEST(ParseGameType, shouldThrowIfTheNameIsUnknown) {
+  EXPECT_THROW(ParseGameType("tes3"), std::invalid_argument);
+  EXPECT_THROW(ParseGameType("TES5"), std::invalid_argument);
+}
+}
+}
+
+#endif
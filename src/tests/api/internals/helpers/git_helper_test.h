@@ -30,12 +30,15 @@ along with LOOT.  If not, see
 #include <gtest/gtest.h>
 
 #include "loot/exception/git_state_error.h"
+#include "tests/masterlist_repository.h"
 
 namespace loot {
 namespace test {
 class GitHelperTest : public ::testing::Test {
 protected:
-  GitHelperTest() : parentRepoRoot(GetRepoRoot()) {}
+  GitHelperTest() :
+      parentRepoRoot(GetRepoRoot()),
+      localRepo("./git-helper-repo") {}
 
   inline void SetUp() {
     ASSERT_TRUE(boost::filesystem::exists(parentRepoRoot / "README.md"));
@@ -65,12 +68,16 @@ protected:
     ASSERT_TRUE(boost::filesystem::exists(parentRepoRoot / "CONTRIBUTING.md"));
     ASSERT_FALSE(
         boost::filesystem::exists(parentRepoRoot / "CONTRIBUTING.md.copy"));
+
+    ASSERT_NO_THROW(localRepo.Remove());
   }
 
   GitHelper git_;
 
   const boost::filesystem::path parentRepoRoot;
 
+  const MasterlistRepository localRepo;
+
 private:
   inline static boost::filesystem::path GetRepoRoot() {
     boost::filesystem::path dir = boost::filesystem::current_path();
@@ -132,8 +139,22 @@ TEST_F(GitHelperTest,
 }
 
 TEST_F(GitHelperTest,
-       DISABLED_isFileDifferentShouldReturnTrueForAChangedTrackedFile) {
-  EXPECT_TRUE(GitHelper::IsFileDifferent(parentRepoRoot, "CONTRIBUTING.md"));
+       isFileDifferentShouldReturnFalseForAnUnchangedTrackedFileInASubdirectory) {
+  EXPECT_FALSE(GitHelper::IsFileDifferent(parentRepoRoot, "docs/index.rst"));
+}
+
+TEST_F(GitHelperTest, isFileDifferentShouldReturnTrueForAChangedTrackedFile) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("plugins: []\n", "Add masterlist"));
+  ASSERT_FALSE(
+      GitHelper::IsFileDifferent(localRepo.GetPath(), "masterlist.yaml"));
+
+  boost::filesystem::ofstream out(localRepo.GetPath() / "masterlist.yaml");
+  out << "plugins:\n  - name: Blank.esp\n";
+  out.close();
+
+  EXPECT_TRUE(
+      GitHelper::IsFileDifferent(localRepo.GetPath(), "masterlist.yaml"));
 }
 }
 }
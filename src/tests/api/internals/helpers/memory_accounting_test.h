@@ -0,0 +1,72 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_MEMORY_ACCOUNTING_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_MEMORY_ACCOUNTING_TEST
+
+#include "api/helpers/memory_accounting.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(MemoryScope, shouldAttributeAllocationsToItsSubsystemUntilDestroyed) {
+  auto before = GetMemoryUsageBySubsystem();
+
+  std::vector<char> buffer;
+  {
+    MemoryScope scope(MemorySubsystem::sorting);
+    buffer.reserve(1000);
+  }
+  auto allocated = GetMemoryUsageBySubsystem();
+
+  std::vector<char>().swap(buffer);
+  auto freed = GetMemoryUsageBySubsystem();
+
+  EXPECT_TRUE(allocated.is_counted);
+  EXPECT_LE(before.sorting_bytes + 1000, allocated.sorting_bytes);
+  EXPECT_LE(before.sorting_bytes + 1000, allocated.sorting_peak_bytes);
+  EXPECT_EQ(before.sorting_bytes, freed.sorting_bytes);
+}
+
+TEST(MemoryScope, shouldRestoreTheOuterSubsystemWhenDestroyed) {
+  ASSERT_EQ(MemorySubsystem::other, GetMemorySubsystem());
+
+  {
+    MemoryScope outerScope(MemorySubsystem::metadataLists);
+    {
+      MemoryScope innerScope(MemorySubsystem::conditionCache);
+      EXPECT_EQ(MemorySubsystem::conditionCache, GetMemorySubsystem());
+    }
+    EXPECT_EQ(MemorySubsystem::metadataLists, GetMemorySubsystem());
+  }
+
+  EXPECT_EQ(MemorySubsystem::other, GetMemorySubsystem());
+}
+}
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_HELPERS_STATISTICS_TEST
+#define LOOT_TESTS_API_INTERNALS_HELPERS_STATISTICS_TEST
+
+#include "api/helpers/statistics.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(IncrementStatistic, shouldAddToTheSumOfAllThreadsCounters) {
+  auto baseline = GetStatisticValues();
+
+  IncrementStatistic(Statistic::metadataLookups, 2);
+  std::thread thread([]() { IncrementStatistic(Statistic::metadataLookups); });
+  thread.join();
+
+  auto statistics = ToGameStatistics(GetStatisticValues(), baseline);
+  EXPECT_EQ(3, statistics.metadata_lookups);
+  EXPECT_EQ(0, statistics.regex_compilations);
+}
+
+TEST(StatisticsScope, shouldAlsoCountStatisticsInItsCountersUntilDestroyed) {
+  auto baseline = GetStatisticValues();
+  auto counters = std::make_shared<StatisticCounters>();
+
+  {
+    StatisticsScope scope(counters.get());
+    IncrementStatistic(Statistic::metadataLookups, 2);
+    EXPECT_EQ(counters, GetStatisticCounters());
+  }
+  IncrementStatistic(Statistic::metadataLookups);
+  std::thread thread([]() { IncrementStatistic(Statistic::metadataLookups); });
+  thread.join();
+
+  EXPECT_EQ(nullptr, GetStatisticCounters());
+  EXPECT_EQ(2, ToGameStatistics(counters->GetValues(), StatisticValues())
+                   .metadata_lookups);
+  EXPECT_EQ(
+      4, ToGameStatistics(GetStatisticValues(), baseline).metadata_lookups);
+}
+
+TEST(StatisticsScope, shouldRestoreThePreviousCountersWhenDestroyed) {
+  auto outerCounters = std::make_shared<StatisticCounters>();
+  auto innerCounters = std::make_shared<StatisticCounters>();
+
+  StatisticsScope outerScope(outerCounters.get());
+  {
+    StatisticsScope innerScope(innerCounters.get());
+    IncrementStatistic(Statistic::regexCompilations);
+  }
+  IncrementStatistic(Statistic::regexCompilations);
+
+  EXPECT_EQ(1, ToGameStatistics(innerCounters->GetValues(), StatisticValues())
+                   .regex_compilations);
+  EXPECT_EQ(1, ToGameStatistics(outerCounters->GetValues(), StatisticValues())
+                   .regex_compilations);
+}
+
+TEST(StatisticCounters, resetShouldSetAllValuesToZero) {
+  StatisticCounters counters;
+  counters.Add(Statistic::bytesRead, 10);
+  counters.Reset();
+
+  EXPECT_EQ(StatisticValues(), counters.GetValues());
+}
+
+TEST(StatisticTimer, shouldAddTheTimeBetweenItsConstructionAndDestruction) {
+  auto baseline = GetStatisticValues();
+
+  {
+    StatisticTimer timer(Statistic::loadListsTime);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  auto statistics = ToGameStatistics(GetStatisticValues(), baseline);
+  EXPECT_LE(std::chrono::milliseconds(10), statistics.load_lists_time);
+}
+}
+}
+
+#endif
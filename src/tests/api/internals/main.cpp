@@ -28,10 +28,15 @@
 #include "tests/api/internals/game/game_test.h"
 #include "tests/api/internals/game/load_order_handler_test.h"
 #include "tests/api/internals/helpers/crc_test.h"
+#include "tests/api/internals/helpers/executor_test.h"
+#include "tests/api/internals/helpers/game_type_test.h"
 #include "tests/api/internals/helpers/git_helper_test.h"
+#include "tests/api/internals/helpers/memory_accounting_test.h"
+#include "tests/api/internals/helpers/statistics_test.h"
 #include "tests/api/internals/helpers/version_test.h"
 #include "tests/api/internals/helpers/yaml_set_helpers_test.h"
 #include "tests/api/internals/masterlist_test.h"
+#include "tests/api/internals/metadata/binary_metadata_test.h"
 #include "tests/api/internals/metadata/condition_evaluator_test.h"
 #include "tests/api/internals/metadata/condition_grammar_test.h"
 #include "tests/api/internals/metadata/conditional_metadata_test.h"
@@ -46,6 +51,8 @@
 #include "tests/api/internals/metadata_list_test.h"
 #include "tests/api/internals/plugin/plugin_sorter_test.h"
 #include "tests/api/internals/plugin/plugin_test.h"
+#include "tests/api/internals/plugin/shared_plugin_cache_test.h"
+#include "tests/api/internals/plugin/sort_graph_test.h"
 
 TEST(ModuloOperator, shouldConformToTheCpp11Standard) {
   // C++11 defines the modulo operator more strongly
@@ -25,9 +25,11 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_API_INTERNALS_MASTERLIST_TEST
 #define LOOT_TESTS_API_INTERNALS_MASTERLIST_TEST
 
+#include "api/helpers/git_helper.h"
 #include "api/masterlist.h"
 
 #include "tests/common_game_test_fixture.h"
+#include "tests/masterlist_repository.h"
 
 namespace loot {
 namespace test {
@@ -37,7 +39,8 @@ protected:
       repoBranch("master"),
       oldBranch("old-branch"),
       repoUrl("https://github.com/loot/testing-metadata.git"),
-      masterlistPath(localPath / "masterlist.yaml") {}
+      masterlistPath(localPath / "masterlist.yaml"),
+      localRepo("./masterlist-remote") {}
 
   void SetUp() {
     CommonGameTestFixture::SetUp();
@@ -50,6 +53,7 @@ protected:
     CommonGameTestFixture::TearDown();
 
     ASSERT_NO_THROW(boost::filesystem::remove(masterlistPath));
+    ASSERT_NO_THROW(localRepo.Remove());
   }
 
   const std::string repoUrl;
@@ -57,6 +61,8 @@ protected:
   const std::string oldBranch;
 
   const boost::filesystem::path masterlistPath;
+
+  const MasterlistRepository localRepo;
 };
 
 // Pass an empty first argument, as it's a prefix for the test instantation,
@@ -139,6 +145,193 @@ TEST_P(MasterlistTest,
   EXPECT_TRUE(masterlist.Update(masterlistPath, repoUrl, repoBranch));
 }
 
+TEST_P(MasterlistTest,
+       updateShouldRollBackToTheNewestRevisionWithAMasterlistThatCanBeParsed) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Lighting\n", "Second"));
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_NO_THROW(
+        localRepo.Commit("bash_tags: [C.Water\n" + std::to_string(i),
+                         "Invalid " + std::to_string(i)));
+  }
+
+  Masterlist masterlist;
+  EXPECT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+  EXPECT_EQ(std::set<std::string>({"C.Lighting"}), masterlist.BashTags());
+}
+
+TEST_P(MasterlistTest, updateShouldOnlyCloneTheLatestCommitsOfTheBranch) {
+  ASSERT_NO_THROW(localRepo.Init());
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_NO_THROW(
+        localRepo.Commit("bash_tags:\n  - C.Climate" + std::to_string(i),
+                         "Commit " + std::to_string(i)));
+  }
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+
+  GitHelper local;
+  ASSERT_NO_THROW(local.Call(git_repository_open(
+      &local.GetData().repo, localPath.string().c_str())));
+  EXPECT_EQ(1, git_repository_is_shallow(local.GetData().repo));
+}
+
+TEST_P(MasterlistTest,
+       updateShouldFetchOlderCommitsIfNoneInAShallowCloneCanBeParsed) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+  // Make more unparseable revisions than are cloned.
+  for (int i = 0; i < 40; ++i) {
+    ASSERT_NO_THROW(
+        localRepo.Commit("bash_tags: [C.Water\n" + std::to_string(i),
+                         "Invalid " + std::to_string(i)));
+  }
+
+  Masterlist masterlist;
+  EXPECT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+  EXPECT_EQ(std::set<std::string>({"C.Climate"}), masterlist.BashTags());
+}
+
+TEST_P(MasterlistTest,
+       updateShouldThrowIfNoRevisionHasAMasterlistThatCanBeParsed) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags: [C.Water\n", "Invalid"));
+
+  Masterlist masterlist;
+  EXPECT_THROW(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch),
+      GitStateError);
+}
+
+TEST_P(MasterlistTest,
+       updateShouldNotTransferBranchesOtherThanTheGivenBranch) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+  ASSERT_NO_THROW(localRepo.CreateBranch(oldBranch));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Water\n", "Other"));
+  ASSERT_NO_THROW(localRepo.Checkout(repoBranch));
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+
+  // Fetching into the existing clone should also skip the other branch.
+  ASSERT_NO_THROW(localRepo.Checkout(oldBranch));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Acoustics\n", "Other"));
+  ASSERT_NO_THROW(localRepo.Checkout(repoBranch));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Lighting\n", "Second"));
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+
+  GitHelper remote;
+  ASSERT_NO_THROW(remote.Call(git_repository_open(
+      &remote.GetData().repo, localRepo.GetPath().string().c_str())));
+  git_oid otherBranchId;
+  ASSERT_NO_THROW(remote.Call(
+      git_reference_name_to_id(&otherBranchId,
+                               remote.GetData().repo,
+                               ("refs/heads/" + oldBranch).c_str())));
+
+  GitHelper local;
+  ASSERT_NO_THROW(local.Call(git_repository_open(
+      &local.GetData().repo, localPath.string().c_str())));
+  ASSERT_NO_THROW(local.Call(
+      git_repository_odb(&local.GetData().odb, local.GetData().repo)));
+
+  git_oid id;
+  EXPECT_FALSE(git_odb_exists(local.GetData().odb, &otherBranchId));
+  EXPECT_EQ(GIT_ENOTFOUND,
+            git_reference_name_to_id(
+                &id,
+                local.GetData().repo,
+                ("refs/remotes/origin/" + oldBranch).c_str()));
+}
+
+TEST_P(MasterlistTest,
+       updateShouldBeAbleToSwitchARepositoryThatTracksOneBranchToAnother) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+  ASSERT_NO_THROW(localRepo.CreateBranch(oldBranch));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Water\n", "Other"));
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+  EXPECT_TRUE(masterlist.Update(masterlistPath, localRepo.GetUrl(), oldBranch));
+  EXPECT_EQ(std::set<std::string>({"C.Water"}), masterlist.BashTags());
+}
+
+TEST_P(MasterlistTest, updateFromBundleShouldThrowIfTheBundleDoesNotExist) {
+  Masterlist masterlist;
+  EXPECT_THROW(masterlist.UpdateFromBundle(
+                   masterlistPath, localPath / "missing.bundle", repoBranch),
+               FileAccessError);
+}
+
+TEST_P(
+    MasterlistTest,
+    updateFromBundleShouldCreateARepositoryIfNoneExistsAndLoadTheMasterlist) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+
+  Masterlist masterlist;
+  EXPECT_TRUE(masterlist.UpdateFromBundle(
+      masterlistPath, localRepo.CreateBundle("master"), repoBranch));
+  EXPECT_EQ(std::set<std::string>({"C.Climate"}), masterlist.BashTags());
+  EXPECT_TRUE(boost::filesystem::exists(localPath / ".git"));
+}
+
+TEST_P(MasterlistTest,
+       updateFromBundleShouldApplyAnIncrementalBundleToAnExistingRepository) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Lighting\n", "Second"));
+  auto bundlePath = localRepo.CreateBundle("HEAD~1..master");
+
+  EXPECT_TRUE(
+      masterlist.UpdateFromBundle(masterlistPath, bundlePath, repoBranch));
+  EXPECT_EQ(std::set<std::string>({"C.Lighting"}), masterlist.BashTags());
+
+  EXPECT_FALSE(
+      masterlist.UpdateFromBundle(masterlistPath, bundlePath, repoBranch));
+}
+
+TEST_P(
+    MasterlistTest,
+    updateFromBundleShouldThrowIfTheRepositoryDoesNotHaveTheBundlesPrerequisites) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Lighting\n", "Second"));
+
+  Masterlist masterlist;
+  EXPECT_THROW(
+      masterlist.UpdateFromBundle(
+          masterlistPath, localRepo.CreateBundle("HEAD~1..master"), repoBranch),
+      GitStateError);
+}
+
+TEST_P(MasterlistTest,
+       updateFromBundleShouldThrowIfTheBundleDoesNotHaveTheGivenBranch) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+
+  Masterlist masterlist;
+  EXPECT_THROW(masterlist.UpdateFromBundle(masterlistPath,
+                                           localRepo.CreateBundle("master"),
+                                           "missing-branch"),
+               GitStateError);
+}
+
 TEST_P(MasterlistTest, getInfoShouldThrowIfNoMasterlistExistsAtTheGivenPath) {
   Masterlist masterlist;
   EXPECT_THROW(masterlist.GetInfo(masterlistPath, false), FileAccessError);
@@ -224,6 +417,43 @@ TEST_P(
 
   EXPECT_TRUE(Masterlist::IsLatest(masterlistPath, repoBranch));
 }
+
+TEST_P(MasterlistTest,
+       isLatestShouldReturnFalseIfTheRemoteBranchHasMovedAndNotFetchIt) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+  ASSERT_TRUE(Masterlist::IsLatest(masterlistPath, repoBranch));
+
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Lighting\n", "Second"));
+  std::string oldRevision =
+      Masterlist::GetInfo(masterlistPath, false).revision_id;
+
+  EXPECT_FALSE(Masterlist::IsLatest(masterlistPath, repoBranch));
+
+  // Checking should not have fetched the new commit, so updating must still
+  // report a change.
+  EXPECT_EQ(oldRevision,
+            Masterlist::GetInfo(masterlistPath, false).revision_id);
+  EXPECT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+}
+
+TEST_P(MasterlistTest,
+       isLatestShouldThrowIfTheRemoteDoesNotHaveTheGivenBranch) {
+  ASSERT_NO_THROW(localRepo.Init());
+  ASSERT_NO_THROW(localRepo.Commit("bash_tags:\n  - C.Climate\n", "First"));
+
+  Masterlist masterlist;
+  ASSERT_TRUE(
+      masterlist.Update(masterlistPath, localRepo.GetUrl(), repoBranch));
+
+  EXPECT_THROW(Masterlist::IsLatest(masterlistPath, "missing-branch"),
+               GitStateError);
+}
 }
 }
 
@@ -0,0 +1,107 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_API_INTERNALS_METADATA_BINARY_METADATA_TEST
+#define LOOT_TESTS_API_INTERNALS_METADATA_BINARY_METADATA_TEST
+
+#include "api/metadata/binary_metadata.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(BinaryMetadata, writingAndReadingPluginMetadataShouldPreserveAllFields) {
+  const std::vector<MessageContent> info({
+      MessageContent("info"),
+      MessageContent("Informationen", "de"),
+  });
+
+  PluginMetadata plugin("Blank.esm");
+  plugin.SetEnabled(false);
+  plugin.SetLocalPriority(Priority(0));
+  plugin.SetGlobalPriority(Priority(-5));
+  plugin.SetLoadAfterFiles({File("Blank.esp", "Blank", "file(\"Foo.esp\")")});
+  plugin.SetRequirements({File("Blank - Different.esm")});
+  plugin.SetIncompatibilities({File("Blank - Different.esp")});
+  plugin.SetMessages({Message(MessageType::warn, info, "active(\"A.esp\")")});
+  plugin.SetTags({Tag("Relev"), Tag("Delev", false, "file(\"Bar.esp\")")});
+  plugin.SetDirtyInfo(
+      {PluginCleaningData(0x12345678, "TES5Edit", info, 2, 3, 4)});
+  plugin.SetCleanInfo({PluginCleaningData(0x87654321, "TES5Edit")});
+  plugin.SetLocations({Location("https://www.example.com", "Example")});
+
+  BinaryWriter writer;
+  WriteMetadata(writer, plugin);
+  BinaryReader reader(writer.GetBuffer().data(), writer.GetBuffer().size());
+  PluginMetadata result = ReadPluginMetadata(reader);
+
+  EXPECT_EQ(0, reader.GetSize());
+  EXPECT_EQ(plugin.GetName(), result.GetName());
+  EXPECT_FALSE(result.IsEnabled());
+  EXPECT_TRUE(result.GetLocalPriority().IsExplicit());
+  EXPECT_EQ(0, result.GetLocalPriority().GetValue());
+  EXPECT_EQ(-5, result.GetGlobalPriority().GetValue());
+  EXPECT_EQ(plugin.GetLoadAfterFiles(), result.GetLoadAfterFiles());
+  EXPECT_EQ("Blank", result.GetLoadAfterFiles().begin()->GetDisplayName());
+  EXPECT_EQ("file(\"Foo.esp\")",
+            result.GetLoadAfterFiles().begin()->GetCondition());
+  EXPECT_EQ(plugin.GetRequirements(), result.GetRequirements());
+  EXPECT_EQ(plugin.GetIncompatibilities(), result.GetIncompatibilities());
+  EXPECT_EQ(plugin.GetMessages(), result.GetMessages());
+  EXPECT_EQ(plugin.GetTags(), result.GetTags());
+  EXPECT_EQ(plugin.GetDirtyInfo(), result.GetDirtyInfo());
+  EXPECT_EQ(4, result.GetDirtyInfo().begin()->GetDeletedNavmeshCount());
+  EXPECT_EQ(plugin.GetCleanInfo(), result.GetCleanInfo());
+  EXPECT_EQ(plugin.GetLocations(), result.GetLocations());
+}
+
+TEST(BinaryMetadata, writingAndReadingAMessageShouldPreserveAllFields) {
+  Message message(MessageType::error, "content", "file(\"Foo.esp\")");
+
+  BinaryWriter writer;
+  WriteMetadata(writer, message);
+  BinaryReader reader(writer.GetBuffer().data(), writer.GetBuffer().size());
+  Message result = ReadMessage(reader);
+
+  EXPECT_EQ(message, result);
+  EXPECT_EQ(MessageType::error, result.GetType());
+  EXPECT_EQ(message.GetCondition(), result.GetCondition());
+}
+
+TEST(BinaryMetadata, readingTruncatedPluginMetadataShouldThrow) {
+  PluginMetadata plugin("Blank.esm");
+  plugin.SetTags({Tag("Relev")});
+
+  BinaryWriter writer;
+  WriteMetadata(writer, plugin);
+  BinaryReader reader(writer.GetBuffer().data(),
+                      writer.GetBuffer().size() - 1);
+
+  EXPECT_THROW(ReadPluginMetadata(reader), std::runtime_error);
+}
+}
+}
+
+#endif
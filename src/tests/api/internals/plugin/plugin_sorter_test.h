@@ -287,6 +287,41 @@ TEST_P(PluginSorterTest, sortingShouldThrowIfACyclicInteractionIsEncountered) {
   PluginSorter ps;
   EXPECT_THROW(ps.Sort(game_), CyclicInteractionError);
 }
+
+TEST_P(PluginSorterTest, getSortGraphShouldReturnAnEmptyGraphBeforeSorting) {
+  PluginSorter ps;
+  SortGraph graph = ps.GetSortGraph();
+
+  EXPECT_EQ(0, graph.GetPluginCount());
+  EXPECT_EQ(0, graph.GetEdgeCount());
+}
+
+TEST_P(PluginSorterTest, getSortGraphShouldTagEdgesWithWhyTheyWereAdded) {
+  ASSERT_NO_THROW(loadInstalledPlugins(game_, false));
+  PluginMetadata plugin(blankEsp);
+  plugin.SetLoadAfterFiles({File(blankDifferentEsp)});
+  game_.GetDatabase()->SetPluginUserMetadata(plugin);
+
+  PluginSorter ps;
+  std::vector<std::string> sorted = ps.Sort(game_);
+  SortGraph graph = ps.GetSortGraph();
+
+  EXPECT_EQ(sorted.size(), graph.GetPluginCount());
+
+  auto path = graph.FindPath(blankEsm, blankMasterDependentEsm);
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ(EdgeType::master, path[0].type);
+
+  path = graph.FindPath(blankEsm, blankEsp);
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ(EdgeType::masterFlag, path[0].type);
+
+  path = graph.FindPath(blankDifferentEsp, blankEsp);
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ(EdgeType::loadAfter, path[0].type);
+
+  EXPECT_TRUE(graph.FindPath(blankEsp, blankEsm).empty());
+}
 }
 }
 
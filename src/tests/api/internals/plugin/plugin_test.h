@@ -28,6 +28,7 @@ along with LOOT.  If not, see
 #include "api/plugin/plugin.h"
 
 #include "api/game/game.h"
+#include "api/helpers/statistics.h"
 #include "tests/common_game_test_fixture.h"
 
 namespace loot {
@@ -70,6 +71,7 @@ protected:
   }
 
   void TearDown() {
+    setSharedPluginCache(nullptr);
     CommonGameTestFixture::TearDown();
 
     boost::filesystem::remove(dataPath / emptyFile);
@@ -435,6 +437,73 @@ TEST_P(PluginTest,
   EXPECT_TRUE(plugin2.DoFormIDsOverlap(plugin1));
 }
 
+TEST_P(PluginTest,
+       loadingAPluginFromTheSharedPluginCacheShouldNotParseTheFileAgain) {
+  setSharedPluginCache(
+      std::make_shared<SharedPluginCache>(localPath / "plugins.cache"));
+
+  Plugin parsedPlugin(game_.Type(),
+                      game_.DataPath(),
+                      game_.GetLoadOrderHandler(),
+                      blankMasterDependentEsm,
+                      false);
+
+  auto baseline = GetStatisticValues();
+  Plugin cachedPlugin(game_.Type(),
+                      game_.DataPath(),
+                      game_.GetLoadOrderHandler(),
+                      blankMasterDependentEsm,
+                      false);
+  auto statistics = ToGameStatistics(GetStatisticValues(), baseline);
+
+  EXPECT_EQ(0, statistics.plugins_parsed);
+  EXPECT_EQ(0, statistics.crcs_computed);
+  EXPECT_EQ(parsedPlugin.GetMasters(), cachedPlugin.GetMasters());
+  EXPECT_EQ(parsedPlugin.IsMaster(), cachedPlugin.IsMaster());
+  EXPECT_EQ(parsedPlugin.IsLightMaster(), cachedPlugin.IsLightMaster());
+  EXPECT_EQ(parsedPlugin.IsEmpty(), cachedPlugin.IsEmpty());
+  EXPECT_EQ(parsedPlugin.GetVersion(), cachedPlugin.GetVersion());
+  EXPECT_EQ(parsedPlugin.GetBashTags(), cachedPlugin.GetBashTags());
+  EXPECT_EQ(parsedPlugin.GetCRC(), cachedPlugin.GetCRC());
+  EXPECT_EQ(parsedPlugin.NumOverrideFormIDs(),
+            cachedPlugin.NumOverrideFormIDs());
+}
+
+TEST_P(PluginTest,
+       doFormIDsOverlapShouldParsePluginsFromTheSharedPluginCacheWhenCalled) {
+  setSharedPluginCache(
+      std::make_shared<SharedPluginCache>(localPath / "plugins.cache"));
+
+  Plugin(game_.Type(),
+         game_.DataPath(),
+         game_.GetLoadOrderHandler(),
+         blankEsm,
+         false);
+  Plugin(game_.Type(),
+         game_.DataPath(),
+         game_.GetLoadOrderHandler(),
+         blankMasterDependentEsm,
+         false);
+
+  Plugin plugin1(game_.Type(),
+                 game_.DataPath(),
+                 game_.GetLoadOrderHandler(),
+                 blankEsm,
+                 false);
+  Plugin plugin2(game_.Type(),
+                 game_.DataPath(),
+                 game_.GetLoadOrderHandler(),
+                 blankMasterDependentEsm,
+                 false);
+
+  auto baseline = GetStatisticValues();
+  EXPECT_TRUE(plugin1.DoFormIDsOverlap(plugin2));
+  EXPECT_TRUE(plugin2.DoFormIDsOverlap(plugin1));
+  auto statistics = ToGameStatistics(GetStatisticValues(), baseline);
+
+  EXPECT_EQ(2, statistics.plugins_parsed);
+}
+
 TEST_P(PluginTest,
        hasPluginFileExtensionShouldBeTrueIfFileEndsInDotEspOrDotEsm) {
   EXPECT_TRUE(hasPluginFileExtension("file.esp", GetParam()));
@@ -0,0 +1,252 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_API_INTERNALS_PLUGIN_SHARED_PLUGIN_CACHE_TEST
+#define LOOT_TESTS_API_INTERNALS_PLUGIN_SHARED_PLUGIN_CACHE_TEST
+
+#include "api/plugin/shared_plugin_cache.h"
+
+#include <thread>
+
+#include <boost/filesystem/fstream.hpp>
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class SharedPluginCacheTest : public ::testing::Test {
+protected:
+  SharedPluginCacheTest() :
+      rootPath_(boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path()),
+      cachePath_(rootPath_ / "plugins.cache"),
+      pluginPath_(rootPath_ / "Blank.esm") {}
+
+  void SetUp() {
+    boost::filesystem::create_directories(rootPath_);
+    writePlugin("TES4");
+
+    record_.isHeaderOnly = false;
+    record_.isEmpty = false;
+    record_.isMaster = true;
+    record_.crc = 0x187BE342;
+    record_.numOverrideRecords = 4;
+    record_.description = "{{BASH:C.Climate}}";
+    record_.masters = {"Skyrim.esm", "Update.esm"};
+  }
+
+  void TearDown() { boost::filesystem::remove_all(rootPath_); }
+
+  void writePlugin(const std::string& content) {
+    boost::filesystem::ofstream out(pluginPath_);
+    out << content;
+  }
+
+  PluginFileKey getKey() const {
+    return PluginFileKey::Get(GameType::tes5, pluginPath_);
+  }
+
+  const boost::filesystem::path rootPath_;
+  const boost::filesystem::path cachePath_;
+  const boost::filesystem::path pluginPath_;
+  SharedPluginRecord record_;
+};
+
+TEST_F(SharedPluginCacheTest, findShouldReturnFalseIfNoRecordHasBeenStored) {
+  SharedPluginCache cache(cachePath_);
+
+  SharedPluginRecord record;
+  EXPECT_FALSE(cache.Find(getKey(), false, record));
+  EXPECT_FALSE(cache.Find(getKey(), true, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       findShouldReturnARecordStoredThroughAnotherMappingOfTheFile) {
+  SharedPluginCache writer(cachePath_);
+  SharedPluginCache reader(cachePath_);
+
+  writer.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  ASSERT_TRUE(reader.Find(getKey(), false, record));
+  EXPECT_FALSE(record.isHeaderOnly);
+  EXPECT_FALSE(record.isEmpty);
+  EXPECT_TRUE(record.isMaster);
+  EXPECT_FALSE(record.isLightMaster);
+  EXPECT_EQ(record_.crc, record.crc);
+  EXPECT_EQ(record_.numOverrideRecords, record.numOverrideRecords);
+  EXPECT_EQ(record_.description, record.description);
+  EXPECT_EQ(record_.masters, record.masters);
+}
+
+TEST_F(SharedPluginCacheTest, recordsShouldPersistAfterTheFileIsClosed) {
+  SharedPluginCache(cachePath_).Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  EXPECT_TRUE(SharedPluginCache(cachePath_).Find(getKey(), false, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       findShouldReturnFalseIfThePluginHasChangedSinceItsRecordWasStored) {
+  SharedPluginCache cache(cachePath_);
+  cache.Store(getKey(), record_);
+
+  writePlugin("TES4 with more data");
+
+  SharedPluginRecord record;
+  EXPECT_FALSE(cache.Find(getKey(), false, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       findShouldReturnFalseForARecordStoredForAnotherGame) {
+  SharedPluginCache cache(cachePath_);
+  cache.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  EXPECT_FALSE(cache.Find(
+      PluginFileKey::Get(GameType::tes5se, pluginPath_), false, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       findShouldNotReturnAHeaderOnlyRecordForAWholePluginLookup) {
+  SharedPluginCache cache(cachePath_);
+  record_.isHeaderOnly = true;
+  record_.crc = 0;
+  record_.numOverrideRecords = 0;
+  cache.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  EXPECT_TRUE(cache.Find(getKey(), true, record));
+  EXPECT_FALSE(cache.Find(getKey(), false, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       findShouldReturnAWholePluginRecordForAHeaderOnlyLookupWithoutItsCrc) {
+  SharedPluginCache cache(cachePath_);
+  cache.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  ASSERT_TRUE(cache.Find(getKey(), true, record));
+  EXPECT_TRUE(record.isHeaderOnly);
+  EXPECT_EQ(0, record.crc);
+  EXPECT_EQ(0, record.numOverrideRecords);
+  EXPECT_EQ(record_.masters, record.masters);
+}
+
+TEST_F(SharedPluginCacheTest,
+       storingAWholePluginRecordShouldReplaceAHeaderOnlyRecord) {
+  SharedPluginCache cache(cachePath_);
+  SharedPluginRecord headerOnlyRecord;
+  cache.Store(getKey(), headerOnlyRecord);
+  cache.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  ASSERT_TRUE(cache.Find(getKey(), false, record));
+  EXPECT_EQ(record_.crc, record.crc);
+}
+
+TEST_F(SharedPluginCacheTest, openingAFileThatIsNotACacheShouldReplaceIt) {
+  boost::filesystem::ofstream out(cachePath_);
+  out << "This is not a shared plugin cache.";
+  out.close();
+
+  SharedPluginCache cache(cachePath_);
+  cache.Store(getKey(), record_);
+
+  SharedPluginRecord record;
+  EXPECT_TRUE(cache.Find(getKey(), false, record));
+}
+
+TEST_F(SharedPluginCacheTest,
+       replacingAFileThatIsNotACacheShouldNotChangeItsContent) {
+  boost::filesystem::ofstream out(cachePath_);
+  out << "This is not a shared plugin cache.";
+  out.close();
+
+  // The link still refers to the original file after it's replaced.
+  auto linkPath = rootPath_ / "plugins.cache.link";
+  boost::filesystem::create_hard_link(cachePath_, linkPath);
+
+  SharedPluginCache cache(cachePath_);
+  cache.Store(getKey(), record_);
+
+  boost::filesystem::ifstream in(linkPath);
+  std::string content;
+  std::getline(in, content);
+  EXPECT_EQ("This is not a shared plugin cache.", content);
+}
+
+TEST_F(SharedPluginCacheTest, storeShouldDoNothingIfTheCacheIsFull) {
+  auto otherPluginPath = rootPath_ / "Blank.esp";
+  boost::filesystem::copy_file(pluginPath_, otherPluginPath);
+  auto otherKey = PluginFileKey::Get(GameType::tes5, otherPluginPath);
+
+  SharedPluginCache cache(cachePath_, 1);
+  cache.Store(getKey(), record_);
+  cache.Store(otherKey, record_);
+
+  SharedPluginRecord record;
+  EXPECT_TRUE(cache.Find(getKey(), false, record));
+  EXPECT_FALSE(cache.Find(otherKey, false, record));
+}
+
+TEST_F(SharedPluginCacheTest, findingAndStoringOnManyThreadsShouldBeSafe) {
+  std::vector<PluginFileKey> keys;
+  for (size_t i = 0; i < 100; ++i) {
+    PluginFileKey key = getKey();
+    key.path += std::to_string(i);
+    keys.push_back(key);
+  }
+
+  SharedPluginCache cache(cachePath_, 64);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([&]() {
+      SharedPluginCache otherCache(cachePath_);
+      for (const auto& key : keys) {
+        SharedPluginRecord record;
+        if (otherCache.Find(key, false, record))
+          EXPECT_EQ(record_.masters, record.masters);
+        else
+          otherCache.Store(key, record_);
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t recordCount = 0;
+  for (const auto& key : keys) {
+    SharedPluginRecord record;
+    if (cache.Find(key, false, record))
+      ++recordCount;
+  }
+  EXPECT_EQ(64, recordCount);
+}
+}
+}
+
+#endif
@@ -0,0 +1,139 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_API_INTERNALS_PLUGIN_SORT_GRAPH_TEST
+#define LOOT_TESTS_API_INTERNALS_PLUGIN_SORT_GRAPH_TEST
+
+#include "api/plugin/sort_graph.h"
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+class SortGraphTest : public ::testing::Test {
+protected:
+  // A -> B -> C -> D is all tie-break edges except for A -> B, while
+  // A -> C -> D is shorter but only has one non-tie-break edge.
+  SortGraphTest() :
+      graph_({"A.esm", "B.esp", "C.esp", "D.esp", "E.esp"},
+             {
+                 {0, 1, EdgeType::master},
+                 {1, 2, EdgeType::loadAfter},
+                 {2, 3, EdgeType::overlap},
+                 {0, 2, EdgeType::tieBreak},
+                 {0, 3, EdgeType::tieBreak},
+             }) {}
+
+  SortGraph graph_;
+};
+
+TEST_F(SortGraphTest, defaultConstructorShouldCreateAnEmptyGraph) {
+  SortGraph graph;
+
+  EXPECT_EQ(0, graph.GetPluginCount());
+  EXPECT_EQ(0, graph.GetEdgeCount());
+}
+
+TEST_F(SortGraphTest, constructorShouldThrowIfAnEdgeHasAnInvalidPlugin) {
+  EXPECT_THROW(SortGraph({"A.esm"}, {{0, 1, EdgeType::master}}),
+               std::invalid_argument);
+}
+
+TEST_F(SortGraphTest, constructorShouldStoreAllPluginsAndEdges) {
+  EXPECT_EQ(5, graph_.GetPluginCount());
+  EXPECT_EQ(5, graph_.GetEdgeCount());
+}
+
+TEST_F(SortGraphTest, findPathShouldThrowIfAPluginIsNotInTheGraph) {
+  EXPECT_THROW(graph_.FindPath("A.esm", "F.esp"), std::invalid_argument);
+  EXPECT_THROW(graph_.FindPath("F.esp", "A.esm"), std::invalid_argument);
+}
+
+TEST_F(SortGraphTest, findPathShouldReturnAnEmptyVectorIfThereIsNoPath) {
+  EXPECT_TRUE(graph_.FindPath("D.esp", "A.esm").empty());
+  EXPECT_TRUE(graph_.FindPath("A.esm", "E.esp").empty());
+}
+
+TEST_F(SortGraphTest, findPathShouldReturnAnEmptyVectorForTheSamePlugin) {
+  EXPECT_TRUE(graph_.FindPath("B.esp", "B.esp").empty());
+}
+
+TEST_F(SortGraphTest, findPathShouldBeCaseInsensitive) {
+  auto path = graph_.FindPath("a.ESM", "b.ESP");
+
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ("A.esm", path[0].from_plugin);
+  EXPECT_EQ("B.esp", path[0].to_plugin);
+  EXPECT_EQ(EdgeType::master, path[0].type);
+}
+
+TEST_F(SortGraphTest, findPathShouldPreferPathsWithFewerTieBreakEdges) {
+  auto path = graph_.FindPath("A.esm", "D.esp");
+
+  ASSERT_EQ(3, path.size());
+  EXPECT_EQ("A.esm", path[0].from_plugin);
+  EXPECT_EQ("B.esp", path[0].to_plugin);
+  EXPECT_EQ(EdgeType::master, path[0].type);
+  EXPECT_EQ("B.esp", path[1].from_plugin);
+  EXPECT_EQ("C.esp", path[1].to_plugin);
+  EXPECT_EQ(EdgeType::loadAfter, path[1].type);
+  EXPECT_EQ("C.esp", path[2].from_plugin);
+  EXPECT_EQ("D.esp", path[2].to_plugin);
+  EXPECT_EQ(EdgeType::overlap, path[2].type);
+}
+
+TEST_F(SortGraphTest, findPathShouldUseTieBreakEdgesIfThereIsNoOtherPath) {
+  SortGraph graph({"A.esm", "B.esp", "C.esp"},
+                  {
+                      {0, 1, EdgeType::master},
+                      {1, 2, EdgeType::tieBreak},
+                  });
+
+  auto path = graph.FindPath("A.esm", "C.esp");
+
+  ASSERT_EQ(2, path.size());
+  EXPECT_EQ(EdgeType::master, path[0].type);
+  EXPECT_EQ(EdgeType::tieBreak, path[1].type);
+}
+
+TEST_F(SortGraphTest,
+       findPathShouldPreferShorterPathsWithTheSameNumberOfTieBreakEdges) {
+  SortGraph graph({"A.esm", "B.esp", "C.esp"},
+                  {
+                      {0, 1, EdgeType::master},
+                      {1, 2, EdgeType::priority},
+                      {0, 2, EdgeType::masterFlag},
+                  });
+
+  auto path = graph.FindPath("A.esm", "C.esp");
+
+  ASSERT_EQ(1, path.size());
+  EXPECT_EQ(EdgeType::masterFlag, path[0].type);
+}
+}
+}
+
+#endif
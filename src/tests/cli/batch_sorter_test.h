@@ -0,0 +1,184 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_CLI_BATCH_SORTER_TEST
+#define LOOT_TESTS_CLI_BATCH_SORTER_TEST
+
+#include "cli/batch_sorter.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "tests/sorting_test_fixture.h"
+
+namespace loot {
+namespace test {
+class BatchSorterTest : public SortingTestFixture {
+protected:
+  cli::InstallJob createJob(const std::string& name) {
+    cli::InstallJob job;
+    job.name = name;
+    job.gameType = gameType_;
+    job.gamePath = dataPath.parent_path().string();
+    job.localPath = localPath.string();
+    job.masterlistPath = masterlistPath_.string();
+    job.plugins = plugins_;
+
+    return job;
+  }
+
+  size_t getIndex(const std::vector<std::string>& loadOrder,
+                  const std::string& plugin) {
+    return std::distance(loadOrder.begin(),
+                         std::find(loadOrder.begin(), loadOrder.end(), plugin));
+  }
+
+  cli::BatchSorter sorter_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        BatchSorterTest,
+                        ::testing::Values(GameType::tes5));
+
+TEST(ReadManifest, shouldResolveRelativePathsAgainstTheBasePath) {
+  std::istringstream in(
+      "{\"installs\": [{\"game\": \"tes5se\", \"game_path\": \"game\", "
+      "\"masterlist_path\": \"lists/masterlist.yaml\", "
+      "\"plugins\": [\"Blank.esp\"]}]}");
+
+  auto jobs = cli::ReadManifest(in, "/manifests");
+
+  ASSERT_EQ(1, jobs.size());
+  EXPECT_EQ(GameType::tes5se, jobs[0].gameType);
+  EXPECT_EQ(boost::filesystem::path("/manifests/game").string(),
+            jobs[0].gamePath);
+  EXPECT_EQ(jobs[0].gamePath, jobs[0].name);
+  EXPECT_EQ(
+      boost::filesystem::path("/manifests/lists/masterlist.yaml").string(),
+      jobs[0].masterlistPath);
+  EXPECT_TRUE(jobs[0].localPath.empty());
+  EXPECT_TRUE(jobs[0].userlistPath.empty());
+  EXPECT_EQ(std::vector<std::string>({"Blank.esp"}), jobs[0].plugins);
+}
+
+TEST(ReadManifest, shouldThrowIfAnInstallHasAnUnknownGame) {
+  std::istringstream in(
+      "{\"installs\": [{\"game\": \"tes3\", \"game_path\": \"game\"}]}");
+
+  EXPECT_THROW(cli::ReadManifest(in, "/manifests"), std::invalid_argument);
+}
+
+TEST(ReadManifest, shouldThrowIfAnInstallHasNoGamePath) {
+  std::istringstream in("{\"installs\": [{\"game\": \"tes5\"}]}");
+
+  EXPECT_THROW(cli::ReadManifest(in, "/manifests"), std::invalid_argument);
+}
+
+TEST_P(BatchSorterTest, sortShouldSortEachInstallAndParseTheMasterlistOnce) {
+  writeMasterlist("plugins: []");
+
+  auto results = sorter_.Sort({createJob("first"), createJob("second")});
+
+  ASSERT_EQ(2, results.size());
+  for (const auto& result : results) {
+    EXPECT_TRUE(result.isSorted) << result.error;
+    EXPECT_EQ(plugins_.size(), result.loadOrder.size());
+  }
+  EXPECT_EQ("first", results[0].name);
+  EXPECT_EQ("second", results[1].name);
+  EXPECT_EQ(1, sorter_.GetMasterlistCache().GetMissCount());
+  EXPECT_EQ(1, sorter_.GetMasterlistCache().GetHitCount());
+}
+
+TEST_P(BatchSorterTest, sortShouldParseTheMasterlistAgainIfItHasChanged) {
+  writeMasterlist("plugins: []");
+  auto results = sorter_.Sort({createJob("first")});
+  ASSERT_TRUE(results[0].isSorted) << results[0].error;
+
+  writeMasterlist("plugins:\n"
+                  "  - name: " + blankEsp + "\n"
+                  "    after:\n"
+                  "      - " + blankMasterDependentEsp + "\n");
+  boost::filesystem::last_write_time(
+      masterlistPath_,
+      boost::filesystem::last_write_time(masterlistPath_) + 10);
+
+  results = sorter_.Sort({createJob("first")});
+  ASSERT_TRUE(results[0].isSorted) << results[0].error;
+  EXPECT_FALSE(results[0].isMasterlistCacheHit);
+  EXPECT_EQ(2, sorter_.GetMasterlistCache().GetMissCount());
+  EXPECT_LT(getIndex(results[0].loadOrder, blankMasterDependentEsp),
+            getIndex(results[0].loadOrder, blankEsp));
+}
+
+TEST_P(BatchSorterTest, sortShouldReportAFailedInstallWithoutStoppingOthers) {
+  writeMasterlist("plugins: []");
+  auto badJob = createJob("bad");
+  badJob.gamePath = (dataPath.parent_path() / "missing").string();
+
+  auto results = sorter_.Sort({badJob, createJob("good")});
+
+  ASSERT_EQ(2, results.size());
+  EXPECT_FALSE(results[0].isSorted);
+  EXPECT_FALSE(results[0].error.empty());
+  EXPECT_TRUE(results[1].isSorted) << results[1].error;
+}
+
+TEST_P(BatchSorterTest, writeReportShouldWriteEachInstallsLoadOrderAndTimings) {
+  writeMasterlist("plugins: []");
+  auto results = sorter_.Sort({createJob("first"), createJob("second")});
+
+  std::stringstream stream;
+  cli::WriteReport(stream,
+                   results,
+                   sorter_.GetMasterlistCache(),
+                   GameStatistics(),
+                   std::chrono::milliseconds(5));
+
+  boost::property_tree::ptree report;
+  boost::property_tree::read_json(stream, report);
+
+  EXPECT_EQ(2, report.get<size_t>("installs_sorted"));
+  EXPECT_EQ(0, report.get<size_t>("installs_failed"));
+  EXPECT_EQ(5.0, report.get<double>("total_ms"));
+  EXPECT_EQ(1, report.get<size_t>("masterlist_cache.hits"));
+  EXPECT_EQ(1, report.get<size_t>("masterlist_cache.misses"));
+  EXPECT_EQ(0, report.get<size_t>("statistics.plugins_parsed"));
+
+  ASSERT_EQ(2, report.get_child("installs").size());
+  auto& install = report.get_child("installs").front().second;
+  EXPECT_EQ("first", install.get<std::string>("name"));
+  EXPECT_EQ("ok", install.get<std::string>("status"));
+  EXPECT_EQ(plugins_.size(), install.get_child("load_order").size());
+  EXPECT_LE(0.0, install.get<double>("timings.total_ms"));
+}
+}
+}
+
+#endif
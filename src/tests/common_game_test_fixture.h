@@ -134,6 +134,26 @@ protected:
     ASSERT_NO_THROW(boost::filesystem::remove(dataPath / invalidPlugin));
   }
 
+  // Moves the modification times of the load order state files a day into the
+  // past, so that they aren't treated as possibly modified again in the same
+  // second. Plugins' relative timestamps are preserved.
+  void ageStateFiles() {
+    std::vector<boost::filesystem::path> paths(
+        {localPath / "plugins.txt", localPath / "loadorder.txt"});
+    for (boost::filesystem::directory_iterator it(dataPath);
+         it != boost::filesystem::directory_iterator();
+         ++it) {
+      paths.push_back(it->path());
+    }
+
+    for (const auto& path : paths) {
+      if (boost::filesystem::exists(path)) {
+        boost::filesystem::last_write_time(
+            path, boost::filesystem::last_write_time(path) - 24 * 60 * 60);
+      }
+    }
+  }
+
   std::vector<std::string> readFileLines(const boost::filesystem::path& file) {
     boost::filesystem::ifstream in(file);
 
@@ -212,6 +232,39 @@ protected:
     return loadOrder;
   }
 
+  void setLoadOrder(
+      const std::vector<std::pair<std::string, bool>>& loadOrder) const {
+    boost::filesystem::ofstream out(localPath / "plugins.txt");
+    for (const auto& plugin : loadOrder) {
+      if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se) {
+        if (plugin.second)
+          out << '*';
+      } else if (!plugin.second)
+        continue;
+
+      out << plugin.first << std::endl;
+    }
+
+    if (isLoadOrderTimestampBased(GetParam())) {
+      time_t modificationTime = time(NULL);  // Current time.
+      for (const auto& plugin : loadOrder) {
+        if (boost::filesystem::exists(
+                dataPath / boost::filesystem::path(plugin.first + ".ghost"))) {
+          boost::filesystem::last_write_time(
+              dataPath / boost::filesystem::path(plugin.first + ".ghost"),
+              modificationTime);
+        } else {
+          boost::filesystem::last_write_time(dataPath / plugin.first,
+                                             modificationTime);
+        }
+        modificationTime += 60;
+      }
+    } else if (GetParam() == GameType::tes5) {
+      boost::filesystem::ofstream out(localPath / "loadorder.txt");
+      for (const auto& plugin : loadOrder) out << plugin.first << std::endl;
+    }
+  }
+
 protected:
   const std::string french;
   const std::string german;
@@ -278,39 +331,6 @@ private:
       return 0x6A1273DC;
   }
 
-  void setLoadOrder(
-      const std::vector<std::pair<std::string, bool>>& loadOrder) const {
-    boost::filesystem::ofstream out(localPath / "plugins.txt");
-    for (const auto& plugin : loadOrder) {
-      if (GetParam() == GameType::fo4 || GetParam() == GameType::tes5se) {
-        if (plugin.second)
-          out << '*';
-      } else if (!plugin.second)
-        continue;
-
-      out << plugin.first << std::endl;
-    }
-
-    if (isLoadOrderTimestampBased(GetParam())) {
-      time_t modificationTime = time(NULL);  // Current time.
-      for (const auto& plugin : loadOrder) {
-        if (boost::filesystem::exists(
-                dataPath / boost::filesystem::path(plugin.first + ".ghost"))) {
-          boost::filesystem::last_write_time(
-              dataPath / boost::filesystem::path(plugin.first + ".ghost"),
-              modificationTime);
-        } else {
-          boost::filesystem::last_write_time(dataPath / plugin.first,
-                                             modificationTime);
-        }
-        modificationTime += 60;
-      }
-    } else if (GetParam() == GameType::tes5) {
-      boost::filesystem::ofstream out(localPath / "loadorder.txt");
-      for (const auto& plugin : loadOrder) out << plugin.first << std::endl;
-    }
-  }
-
   inline static bool isLoadOrderTimestampBased(GameType gameType) {
     return gameType == GameType::tes4 || gameType == GameType::fo3 ||
            gameType == GameType::fonv;
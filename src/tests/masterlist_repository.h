@@ -0,0 +1,123 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2013-2017    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_MASTERLIST_REPOSITORY
+#define LOOT_TESTS_MASTERLIST_REPOSITORY
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+namespace loot {
+namespace test {
+// A local Git repository that can be used as a file:// masterlist remote, so
+// that masterlist update tests don't need network access. The repository is
+// created and committed to using the Git command line client.
+class MasterlistRepository {
+public:
+  MasterlistRepository(const boost::filesystem::path& path,
+                       const std::string& filename = "masterlist.yaml") :
+      path_(boost::filesystem::absolute(path)),
+      filename_(filename) {}
+
+  void Init() const {
+    boost::filesystem::create_directories(path_);
+    Git("init --quiet");
+    Git("symbolic-ref HEAD refs/heads/master");
+  }
+
+  void Commit(const std::string& content, const std::string& message) const {
+    boost::filesystem::ofstream out(path_ / filename_);
+    out << content;
+    out.close();
+
+    Git("add \"" + filename_ + "\"");
+    // Set an identity so that committing works on machines without one.
+    Git("-c user.name=LOOT -c user.email=loot@example.com commit --quiet "
+        "-m \"" + message + "\"");
+  }
+
+  // Creates a branch at HEAD and checks it out.
+  void CreateBranch(const std::string& branch) const {
+    Git("checkout --quiet -b \"" + branch + "\"");
+  }
+
+  void Checkout(const std::string& branch) const {
+    Git("checkout --quiet \"" + branch + "\"");
+  }
+
+  // Writes a bundle of the given revisions, eg. "master" or "HEAD~1..master",
+  // to a file in the repository's directory and returns its path.
+  boost::filesystem::path CreateBundle(const std::string& revisions) const {
+    boost::filesystem::path bundlePath = path_ / "masterlist.bundle";
+    boost::filesystem::remove(bundlePath);
+    Git("bundle create --quiet \"" + bundlePath.string() + "\" " + revisions);
+
+    return bundlePath;
+  }
+
+  std::string GetUrl() const {
+    std::string path = path_.generic_string();
+    if (path[0] != '/')
+      path = "/" + path;
+
+    return "file://" + path;
+  }
+
+  const boost::filesystem::path& GetPath() const { return path_; }
+
+  void Remove() const {
+    if (!boost::filesystem::exists(path_))
+      return;
+
+    // Git makes some files in the repository read-only, which stops them
+    // from being deleted on Windows.
+    for (boost::filesystem::recursive_directory_iterator it(path_);
+         it != boost::filesystem::recursive_directory_iterator();
+         ++it) {
+      boost::filesystem::permissions(
+          it->path(),
+          boost::filesystem::add_perms | boost::filesystem::owner_write);
+    }
+
+    boost::filesystem::remove_all(path_);
+  }
+
+private:
+  void Git(const std::string& arguments) const {
+    std::string command = "git -C \"" + path_.string() + "\" " + arguments;
+    if (std::system(command.c_str()) != 0)
+      throw std::runtime_error("Command failed: " + command);
+  }
+
+  const boost::filesystem::path path_;
+  const std::string filename_;
+};
+}
+}
+
+#endif
@@ -0,0 +1,203 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOOT_TESTS_SERVICE_SORT_SERVICE_TEST
+#define LOOT_TESTS_SERVICE_SORT_SERVICE_TEST
+
+#include "service/sort_service.h"
+
+#include <sstream>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include "tests/sorting_test_fixture.h"
+
+namespace loot {
+namespace test {
+class SortServiceTest : public SortingTestFixture {
+protected:
+  // Builds a request for the fixture's game install.
+  boost::property_tree::ptree createRequest(const std::string& command) {
+    boost::property_tree::ptree request;
+    request.put("command", command);
+    request.put("game", gameName_);
+    request.put("game_path", dataPath.parent_path().string());
+    request.put("local_path", localPath.string());
+
+    boost::property_tree::ptree plugins;
+    for (const auto& plugin : plugins_) {
+      boost::property_tree::ptree element;
+      element.put_value(plugin);
+      plugins.push_back(std::make_pair("", element));
+    }
+    request.add_child("plugins", plugins);
+
+    return request;
+  }
+
+  boost::property_tree::ptree send(const boost::property_tree::ptree& request) {
+    std::ostringstream out;
+    boost::property_tree::write_json(out, request, false);
+
+    return send(out.str());
+  }
+
+  boost::property_tree::ptree send(const std::string& request) {
+    std::string response = service_.HandleRequest(request);
+    EXPECT_EQ('\n', response.back());
+    EXPECT_EQ(std::string::npos, response.find('\n'));
+
+    boost::property_tree::ptree tree;
+    std::istringstream in(response);
+    boost::property_tree::read_json(in, tree);
+    return tree;
+  }
+
+  service::SortService service_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(,
+                        SortServiceTest,
+                        ::testing::Values(GameType::tes5));
+
+TEST_P(SortServiceTest, invalidJsonShouldReturnAnErrorResponse) {
+  auto response = send("{\"command\": ");
+
+  EXPECT_EQ("error", response.get<std::string>("status"));
+  EXPECT_FALSE(response.get<std::string>("message").empty());
+}
+
+TEST_P(SortServiceTest, anUnknownCommandShouldReturnAnErrorResponse) {
+  auto response = send(createRequest("defragment"));
+
+  EXPECT_EQ("error", response.get<std::string>("status"));
+  EXPECT_EQ("Unknown command: defragment",
+            response.get<std::string>("message"));
+}
+
+TEST_P(SortServiceTest, anUnknownGameShouldReturnAnErrorResponse) {
+  auto request = createRequest("load");
+  request.put("game", "tes3");
+  auto response = send(request);
+
+  EXPECT_EQ("error", response.get<std::string>("status"));
+  EXPECT_EQ("Unknown game: tes3", response.get<std::string>("message"));
+}
+
+TEST_P(SortServiceTest, loadShouldOnlyParsePluginsThatHaveNotBeenLoaded) {
+  auto response = send(createRequest("load"));
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(plugins_.size(), response.get<size_t>("plugins_parsed"));
+
+  response = send(createRequest("load"));
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(0, response.get<size_t>("plugins_parsed"));
+}
+
+TEST_P(SortServiceTest,
+       loadShouldNotParseTheMainMasterAgainIfItWasLoadedWithHeadersOnly) {
+  auto request = createRequest("load");
+  request.put("main_master_file", masterFile);
+  request.put("headers_only", true);
+  auto response = send(request);
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(plugins_.size(), response.get<size_t>("plugins_parsed"));
+
+  boost::property_tree::ptree plugins;
+  boost::property_tree::ptree element;
+  element.put_value(masterFile);
+  plugins.push_back(std::make_pair("", element));
+  request.put_child("plugins", plugins);
+  request.put("headers_only", false);
+
+  response = send(request);
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(0, response.get<size_t>("plugins_parsed"));
+}
+
+TEST_P(SortServiceTest, sortShouldOnlyParsePluginsThatHaveChanged) {
+  auto response = send(createRequest("sort"));
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(plugins_.size(), response.get<size_t>("plugins_parsed"));
+  EXPECT_EQ(plugins_.size(), response.get_child("load_order").size());
+
+  response = send(createRequest("sort"));
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(0, response.get<size_t>("plugins_parsed"));
+
+  auto pluginPath = dataPath / blankEsp;
+  boost::filesystem::last_write_time(
+      pluginPath, boost::filesystem::last_write_time(pluginPath) + 10);
+
+  response = send(createRequest("sort"));
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_EQ(1, response.get<size_t>("plugins_parsed"));
+  EXPECT_EQ(plugins_.size(), response.get_child("load_order").size());
+}
+
+TEST_P(SortServiceTest,
+       sortingNoPluginsShouldReturnAnEmptyLoadOrderArrayAndANumberParsed) {
+  auto request = createRequest("sort");
+  request.put_child("plugins", boost::property_tree::ptree());
+  std::ostringstream out;
+  boost::property_tree::write_json(out, request, false);
+
+  std::string response = service_.HandleRequest(out.str());
+
+  EXPECT_NE(std::string::npos, response.find("\"status\":\"ok\""));
+  EXPECT_NE(std::string::npos, response.find("\"load_order\":[]"));
+  EXPECT_NE(std::string::npos, response.find("\"plugins_parsed\":0"));
+}
+
+TEST_P(SortServiceTest, getMetadataShouldReloadTheMasterlistIfItHasChanged) {
+  writeMasterlist("plugins: []");
+
+  auto request = createRequest("get_metadata");
+  request.put("plugin", blankEsm);
+  request.put("masterlist_path", masterlistPath_.string());
+
+  auto response = send(request);
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  EXPECT_FALSE(response.get_child_optional("metadata.after"));
+
+  writeMasterlist("plugins:\n"
+                  "  - name: " + blankEsm + "\n"
+                  "    after:\n"
+                  "      - " + blankEsp + "\n");
+  boost::filesystem::last_write_time(
+      masterlistPath_,
+      boost::filesystem::last_write_time(masterlistPath_) + 10);
+
+  response = send(request);
+  ASSERT_EQ("ok", response.get<std::string>("status"));
+  ASSERT_TRUE(response.get_child_optional("metadata.after"));
+  EXPECT_EQ(1, response.get_child("metadata.after").size());
+}
+}
+}
+
+#endif
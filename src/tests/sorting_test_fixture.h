@@ -0,0 +1,68 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2014-2016    WrinklyNinja
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_SORTING_TEST_FIXTURE
+#define LOOT_TESTS_SORTING_TEST_FIXTURE
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "tests/common_game_test_fixture.h"
+
+namespace loot {
+namespace test {
+// Shared by the tests of the tools that sort whole installs, which load the
+// same plugins and masterlist.
+class SortingTestFixture : public CommonGameTestFixture {
+protected:
+  // Only Skyrim is tested, so the game is hardcoded.
+  SortingTestFixture() :
+      gameType_(GameType::tes5),
+      gameName_("tes5"),
+      plugins_({
+          masterFile,
+          blankEsm,
+          blankDifferentEsm,
+          blankMasterDependentEsm,
+          blankEsp,
+          blankMasterDependentEsp,
+      }),
+      masterlistPath_(localPath / "masterlist.yaml") {}
+
+  void writeMasterlist(const std::string& content) {
+    boost::filesystem::ofstream out(masterlistPath_);
+    out << content;
+  }
+
+  const GameType gameType_;
+  const std::string gameName_;
+  const std::vector<std::string> plugins_;
+  const boost::filesystem::path masterlistPath_;
+};
+}
+}
+
+#endif